@@ -0,0 +1,104 @@
+#include "Batch.h"
+#include "Exception.h"
+#include "Requirement.h"
+#include "Resolver.h"
+
+#include "Ecosystem.h"
+#include "TestValue.h"
+
+#include "benchmark/benchmark.h"
+
+#include <memory>
+#include <vector>
+
+using namespace Arbiter;
+using namespace Testing;
+
+namespace {
+
+const size_t manifestCount = 64;
+
+/**
+ * An ecosystem, and many root dependency lists which overlap within it, like
+ * the targets of a monorepo.
+ */
+struct Manifests final
+{
+  public:
+    Ecosystem _ecosystem;
+    std::vector<BatchEntry> _entries;
+
+    Manifests ()
+      : _ecosystem(options())
+    {
+      for (size_t i = 0; i < manifestCount; i++) {
+        std::vector<ArbiterDependency> dependencies;
+
+        for (size_t package = i % 16; package < 32; package += 4) {
+          ArbiterProjectIdentifier project(makeSharedUserValue<ArbiterProjectIdentifier, StringTestValue>(_ecosystem.packages()[package]._name));
+          dependencies.emplace_back(std::move(project), Requirement::Any());
+        }
+
+        _entries.push_back(BatchEntry{ ArbiterDependencyList(std::move(dependencies)), ArbiterResolvedDependencyGraph() });
+      }
+    }
+
+  private:
+    static EcosystemOptions options ()
+    {
+      EcosystemOptions options;
+      options._packageCount = 256;
+      options._fanOut = 4;
+      options._compatibleWithWeight = 0;
+      options._exactlyWeight = 0;
+      return options;
+    }
+};
+
+const Manifests &manifests ()
+{
+  static const Manifests manifests;
+  return manifests;
+}
+
+/**
+ * Resolves every manifest with its own resolver, one after another.
+ */
+void BM_ResolveManifestsSeparately (benchmark::State &state)
+{
+  const Manifests &batch = manifests();
+
+  for (auto _ : state) {
+    for (const BatchEntry &entry : batch._entries) {
+      std::unique_ptr<ArbiterResolver> resolver = batch._ecosystem.createResolver(entry._dependenciesToResolve);
+
+      try {
+        benchmark::DoNotOptimize(resolver->resolve());
+      } catch (const Exception::Base &ex) {
+        state.SkipWithError(ex.what());
+        return;
+      }
+    }
+  }
+}
+
+/**
+ * Resolves every manifest in one batch, on the given number of threads.
+ */
+void BM_ResolveManifestsInBatch (benchmark::State &state)
+{
+  const Manifests &batch = manifests();
+  BatchStats stats;
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(resolveBatch(Ecosystem::behaviors(), batch._ecosystem.context(), batch._entries, size_t(state.range(0)), &stats));
+  }
+
+  state.counters["fetches"] = double(stats._availableVersionFetches + stats._dependencyListFetches);
+  state.counters["shared"] = double(stats._sharedFetches);
+}
+
+} // namespace
+
+BENCHMARK(BM_ResolveManifestsSeparately)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ResolveManifestsInBatch)->Arg(1)->Arg(4)->UseRealTime()->Unit(benchmark::kMillisecond);
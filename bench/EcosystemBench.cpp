@@ -0,0 +1,76 @@
+#include "Ecosystem.h"
+#include "Exception.h"
+#include "Resolver.h"
+
+#include "benchmark/benchmark.h"
+
+#include <memory>
+
+using namespace Arbiter;
+using namespace Testing;
+
+namespace {
+
+/**
+ * An ecosystem with the given number of packages, whose constraints never
+ * conflict, so that scaling reflects the size of the graph rather than the
+ * difficulty of the search. (With even a few `~>` constraints, the search can
+ * take exponential time.)
+ */
+EcosystemOptions scalingOptions (size_t packageCount)
+{
+  EcosystemOptions options;
+  options._packageCount = packageCount;
+  options._versionsPerPackage = 10;
+  options._fanOut = 4;
+  options._rootDependencyCount = 10;
+  options._compatibleWithWeight = 0;
+  options._atLeastWeight = 1;
+  options._exactlyWeight = 0;
+  return options;
+}
+
+void BM_ResolveEcosystem (benchmark::State &state)
+{
+  Ecosystem ecosystem(scalingOptions(size_t(state.range(0))));
+  const ArbiterDependencyList dependencies = ecosystem.rootDependencies();
+
+  size_t nodeCount = 0;
+
+  for (auto _ : state) {
+    std::unique_ptr<ArbiterResolver> resolver = ecosystem.createResolver(dependencies);
+
+    try {
+      nodeCount = resolver->resolve().nodes().size();
+    } catch (const Exception::Base &ex) {
+      state.SkipWithError(ex.what());
+      break;
+    }
+  }
+
+  state.counters["nodes"] = double(nodeCount);
+}
+
+void BM_CreateInstallerForEcosystem (benchmark::State &state)
+{
+  Ecosystem ecosystem(scalingOptions(size_t(state.range(0))));
+
+  ArbiterResolvedDependencyGraph graph;
+  try {
+    graph = ecosystem.createResolver(ecosystem.rootDependencies())->resolve();
+  } catch (const Exception::Base &ex) {
+    state.SkipWithError(ex.what());
+    return;
+  }
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(graph.createInstaller());
+  }
+
+  state.counters["nodes"] = double(graph.nodes().size());
+}
+
+} // namespace
+
+BENCHMARK(BM_ResolveEcosystem)->RangeMultiplier(4)->Range(64, 16384)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CreateInstallerForEcosystem)->RangeMultiplier(4)->Range(64, 16384)->Unit(benchmark::kMillisecond);
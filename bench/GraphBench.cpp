@@ -0,0 +1,90 @@
+#include "CompactGraph.h"
+#include "Graph.h"
+#include "Requirement.h"
+
+#include "TestValue.h"
+
+#include "benchmark/benchmark.h"
+
+#include <random>
+#include <string>
+
+using namespace Arbiter;
+using namespace Testing;
+
+namespace {
+
+ArbiterProjectIdentifier makeProjectIdentifier (size_t index)
+{
+  return ArbiterProjectIdentifier(makeSharedUserValue<ArbiterProjectIdentifier, StringTestValue>("project" + std::to_string(index)));
+}
+
+/**
+ * Creates an acyclic graph where each node depends upon a few randomly chosen
+ * nodes created before it.
+ */
+ArbiterResolvedDependencyGraph makeSyntheticGraph (size_t nodeCount, size_t maxDependencies)
+{
+  std::mt19937 generator(nodeCount);
+  ArbiterResolvedDependencyGraph graph;
+
+  for (size_t index = 0; index < nodeCount; index++) {
+    ArbiterSelectedVersion version(ArbiterSemanticVersion(1, 0, 0), makeSharedUserValue<ArbiterSelectedVersion, EmptyTestValue>());
+    graph.addNode(ArbiterResolvedDependency(makeProjectIdentifier(index), std::move(version)), Requirement::Any());
+
+    if (index == 0) {
+      continue;
+    }
+
+    std::uniform_int_distribution<size_t> dependencyDistribution(0, index - 1);
+    std::uniform_int_distribution<size_t> countDistribution(0, maxDependencies);
+
+    for (size_t count = countDistribution(generator); count > 0; count--) {
+      graph.addEdge(makeProjectIdentifier(index), makeProjectIdentifier(dependencyDistribution(generator)));
+    }
+  }
+
+  return graph;
+}
+
+void BM_CreateInstaller (benchmark::State &state)
+{
+  ArbiterResolvedDependencyGraph graph = makeSyntheticGraph(size_t(state.range(0)), 4);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(graph.createInstaller());
+  }
+
+  state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+void BM_BuildCompactGraph (benchmark::State &state)
+{
+  ArbiterResolvedDependencyGraph graph = makeSyntheticGraph(size_t(state.range(0)), 4);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(CompactGraph(graph));
+  }
+
+  state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+void BM_GraphWithNewRoots (benchmark::State &state)
+{
+  ArbiterResolvedDependencyGraph graph = makeSyntheticGraph(size_t(state.range(0)), 4);
+
+  // The last node has the most nodes reachable from it.
+  std::vector<ArbiterProjectIdentifier> roots = { makeProjectIdentifier(size_t(state.range(0)) - 1) };
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(graph.graphWithNewRoots(roots));
+  }
+
+  state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+} // namespace
+
+BENCHMARK(BM_BuildCompactGraph)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CreateInstaller)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_GraphWithNewRoots)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
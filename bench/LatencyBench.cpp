@@ -0,0 +1,100 @@
+#include "Exception.h"
+#include "Resolver.h"
+
+#include "Ecosystem.h"
+#include "Fixture.h"
+#include "LatencySimulator.h"
+
+#include "benchmark/benchmark.h"
+
+#include <chrono>
+#include <memory>
+
+using namespace Arbiter;
+using namespace Testing;
+
+namespace {
+
+using std::chrono::milliseconds;
+
+/**
+ * Resolves dependencies with a new simulator and resolver each time, reporting
+ * the simulated end-to-end time, and how much of it was spent fetching.
+ *
+ * The difference between `fetch_ms` and `critical_path_ms` is the time that
+ * overlapping fetches could save.
+ */
+template<typename Source>
+void runLatencyBenchmark (benchmark::State &state, const Source &source, const ArbiterDependencyList &dependencies, const LatencyOptions &options)
+{
+  LatencyReport report;
+
+  for (auto _ : state) {
+    LatencySimulator simulator(Source::behaviors(), source.context(), options);
+    std::unique_ptr<ArbiterResolver> resolver = simulator.createResolver(dependencies);
+
+    try {
+      ArbiterResolvedDependencyGraph resolved = resolver->resolve();
+      report = simulator.report(*resolver, resolved);
+    } catch (const Exception::Base &ex) {
+      state.SkipWithError(ex.what());
+      return;
+    }
+
+    state.SetIterationTime(std::chrono::duration<double>(report._duration).count());
+  }
+
+  state.counters["fetches"] = double(report._fetches);
+  state.counters["fetch_ms"] = std::chrono::duration<double, std::milli>(report._fetchLatency).count();
+  state.counters["critical_path_ms"] = std::chrono::duration<double, std::milli>(report._criticalPathLatency).count();
+}
+
+void BM_ResolveCarthageWithFixedLatency (benchmark::State &state)
+{
+  const FixtureDirectory &fixture = FixtureDirectory::carthage();
+
+  LatencyOptions options;
+  options._availableVersions = LatencyDistribution::fixed(milliseconds(state.range(0)));
+  options._dependencyList = LatencyDistribution::fixed(milliseconds(state.range(0)));
+
+  runLatencyBenchmark(state, fixture, fixture.loadDependencyList("Carthage", "0.18"), options);
+}
+
+void BM_ResolveCarthageWithLogNormalLatency (benchmark::State &state)
+{
+  const FixtureDirectory &fixture = FixtureDirectory::carthage();
+
+  LatencyOptions options;
+  options._availableVersions = LatencyDistribution::logNormal(milliseconds(state.range(0)), 1);
+  options._dependencyList = LatencyDistribution::logNormal(milliseconds(state.range(0)), 1);
+
+  runLatencyBenchmark(state, fixture, fixture.loadDependencyList("Carthage", "0.18"), options);
+}
+
+/**
+ * Resolves a synthetic ecosystem where one package depended upon by the root
+ * project is much slower to fetch than the rest, like a mirror having trouble.
+ */
+void BM_ResolveEcosystemWithSlowPackage (benchmark::State &state)
+{
+  EcosystemOptions ecosystemOptions;
+  ecosystemOptions._packageCount = size_t(state.range(0));
+  ecosystemOptions._compatibleWithWeight = 0;
+  ecosystemOptions._exactlyWeight = 0;
+
+  Ecosystem ecosystem(ecosystemOptions);
+  const ArbiterDependencyList dependencies = ecosystem.rootDependencies();
+
+  LatencyOptions options;
+  options._availableVersions = LatencyDistribution::logNormal(milliseconds(20), 0.5);
+  options._dependencyList = LatencyDistribution::logNormal(milliseconds(20), 0.5);
+  options._perProject[dependencies._dependencies.front()._projectIdentifier] = LatencyDistribution::fixed(milliseconds(500));
+
+  runLatencyBenchmark(state, ecosystem, dependencies, options);
+}
+
+} // namespace
+
+BENCHMARK(BM_ResolveCarthageWithFixedLatency)->Arg(1)->Arg(50)->UseManualTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ResolveCarthageWithLogNormalLatency)->Arg(50)->UseManualTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ResolveEcosystemWithSlowPackage)->Arg(64)->Arg(256)->UseManualTime()->Unit(benchmark::kMillisecond);
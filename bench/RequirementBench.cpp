@@ -0,0 +1,56 @@
+#include "Requirement.h"
+#include "Version.h"
+
+#include "benchmark/benchmark.h"
+
+#include <memory>
+#include <vector>
+
+using namespace Arbiter;
+
+namespace {
+
+/**
+ * A mix of the kinds of requirement found in typical dependency lists, over a
+ * range of versions.
+ */
+std::vector<std::unique_ptr<ArbiterRequirement>> makeRequirements ()
+{
+  std::vector<std::unique_ptr<ArbiterRequirement>> requirements;
+
+  for (unsigned major = 0; major < 3; major++) {
+    for (unsigned minor = 0; minor < 4; minor++) {
+      ArbiterSemanticVersion version(major, minor, 1);
+
+      requirements.emplace_back(std::make_unique<Requirement::AtLeast>(version));
+      requirements.emplace_back(std::make_unique<Requirement::CompatibleWith>(version, ArbiterRequirementStrictnessAllowVersionZeroPatches));
+      requirements.emplace_back(std::make_unique<Requirement::Exactly>(version));
+    }
+  }
+
+  requirements.emplace_back(std::make_unique<Requirement::Any>());
+  return requirements;
+}
+
+void BM_IntersectRequirements (benchmark::State &state)
+{
+  const auto requirements = makeRequirements();
+
+  for (auto _ : state) {
+    size_t intersections = 0;
+
+    for (const auto &lhs : requirements) {
+      for (const auto &rhs : requirements) {
+        intersections += bool(lhs->intersect(*rhs));
+      }
+    }
+
+    benchmark::DoNotOptimize(intersections);
+  }
+
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(requirements.size() * requirements.size()));
+}
+
+} // namespace
+
+BENCHMARK(BM_IntersectRequirements);
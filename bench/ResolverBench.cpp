@@ -0,0 +1,120 @@
+#include "Exception.h"
+#include "Resolver.h"
+
+#include "Fixture.h"
+
+#include "benchmark/benchmark.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+
+using namespace Arbiter;
+using namespace Testing;
+
+namespace {
+
+/**
+ * Resolves the given version of Carthage with a new resolver each time, so
+ * that every project must be fetched from the fixture.
+ */
+void BM_ResolveCarthageCold (benchmark::State &state, const std::string &version)
+{
+  const FixtureDirectory &fixture = FixtureDirectory::carthage();
+  const ArbiterDependencyList dependencies = fixture.loadDependencyList("Carthage", version);
+
+  for (auto _ : state) {
+    std::unique_ptr<ArbiterResolver> resolver = fixture.createResolver(dependencies);
+
+    try {
+      benchmark::DoNotOptimize(resolver->resolve());
+    } catch (const Exception::Base &ex) {
+      state.SkipWithError(ex.what());
+      break;
+    }
+  }
+}
+
+/**
+ * Resolves the given version of Carthage repeatedly with the same resolver,
+ * so that every project has already been fetched.
+ */
+void BM_ResolveCarthageWarm (benchmark::State &state, const std::string &version)
+{
+  const FixtureDirectory &fixture = FixtureDirectory::carthage();
+  std::unique_ptr<ArbiterResolver> resolver = fixture.createResolver(fixture.loadDependencyList("Carthage", version));
+
+  try {
+    resolver->resolve();
+  } catch (const Exception::Base &ex) {
+    state.SkipWithError(ex.what());
+    return;
+  }
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(resolver->resolve());
+  }
+}
+
+/**
+ * Resolves the latest version of Carthage with a new resolver each time, which
+ * finds its result in a shared ArbiterResultCache.
+ */
+void BM_ResolveCarthageFromResultCache (benchmark::State &state)
+{
+  const FixtureDirectory &fixture = FixtureDirectory::carthage();
+  const ArbiterDependencyList dependencies = fixture.loadDependencyList("Carthage", "0.18.1");
+
+  ArbiterResultCache cache(1, None(), ArbiterLockfileValueReaders());
+
+  std::unique_ptr<ArbiterResolver> first = fixture.createResolver(dependencies);
+  first->setResultCache(&cache, "bench");
+
+  try {
+    first->resolve();
+  } catch (const Exception::Base &ex) {
+    state.SkipWithError(ex.what());
+    return;
+  }
+
+  for (auto _ : state) {
+    std::unique_ptr<ArbiterResolver> resolver = fixture.createResolver(dependencies);
+    resolver->setResultCache(&cache, "bench");
+
+    benchmark::DoNotOptimize(resolver->resolve());
+  }
+}
+
+/**
+ * Registers benchmarks for every version of Carthage in the fixture, named
+ * after the version so that results can be compared across runs.
+ */
+bool registerCarthageBenchmarks ()
+{
+  const auto &brokenVersions = FixtureDirectory::brokenCarthageVersions();
+
+  std::vector<std::string> versions;
+  try {
+    versions = FixtureDirectory::carthage().loadVersionStrings("Carthage");
+  } catch (const std::exception &) {
+    // The fixture has not been unzipped.
+    return false;
+  }
+
+  for (const std::string &version : versions) {
+    if (std::find(brokenVersions.begin(), brokenVersions.end(), version) != brokenVersions.end()) {
+      continue;
+    }
+
+    benchmark::RegisterBenchmark(("BM_ResolveCarthageCold/" + version).c_str(), &BM_ResolveCarthageCold, version)->Unit(benchmark::kMillisecond);
+    benchmark::RegisterBenchmark(("BM_ResolveCarthageWarm/" + version).c_str(), &BM_ResolveCarthageWarm, version)->Unit(benchmark::kMillisecond);
+  }
+
+  benchmark::RegisterBenchmark("BM_ResolveCarthageFromResultCache", &BM_ResolveCarthageFromResultCache)->Unit(benchmark::kMicrosecond);
+
+  return true;
+}
+
+const bool registeredCarthageBenchmarks = registerCarthageBenchmarks();
+
+} // namespace
@@ -0,0 +1,164 @@
+#include "Version.h"
+
+#include "benchmark/benchmark.h"
+
+#include <regex>
+#include <string>
+#include <vector>
+
+using namespace Arbiter;
+
+namespace {
+
+/**
+ * The regular expression-based parser which ArbiterSemanticVersion::fromString
+ * used to be implemented with, kept as a point of comparison.
+ */
+Optional<ArbiterSemanticVersion> regexFromString (const std::string &versionString)
+{
+  #define VERSION "(0|[1-9][0-9]*)"
+  #define IDENTIFIER "(?:0|[1-9A-Za-z-][0-9A-Za-z-]*)"
+  #define DOTTED_IDENTIFIER "(" IDENTIFIER "(?:\\." IDENTIFIER ")*)"
+
+  std::regex pattern {
+    VERSION "\\." VERSION "\\." VERSION
+    "(?:"   "-" DOTTED_IDENTIFIER ")?"
+    "(?:" "\\+" DOTTED_IDENTIFIER ")?"
+  };
+
+  #undef DOTTED_IDENTIFIER
+  #undef IDENTIFIER
+  #undef VERSION
+
+  std::smatch match;
+  if (!std::regex_match(versionString, match, pattern)) {
+    return Optional<ArbiterSemanticVersion>();
+  }
+
+  unsigned major = std::stoul(match.str(1));
+  unsigned minor = std::stoul(match.str(2));
+  unsigned patch = std::stoul(match.str(3));
+
+  Optional<std::string> prereleaseVersion;
+  Optional<std::string> buildMetadata;
+
+  if (match.length(4) > 0) {
+    prereleaseVersion = Optional<std::string>(match.str(4));
+  }
+  if (match.length(5) > 0) {
+    buildMetadata = Optional<std::string>(match.str(5));
+  }
+
+  return ArbiterSemanticVersion(major, minor, patch, prereleaseVersion, buildMetadata);
+}
+
+/**
+ * A mix of version strings resembling a typical list of tags.
+ */
+const std::vector<std::string> &versionStrings ()
+{
+  static const std::vector<std::string> strings = [] {
+    std::vector<std::string> strings;
+
+    for (unsigned major = 0; major < 4; major++) {
+      for (unsigned minor = 0; minor < 16; minor++) {
+        for (unsigned patch = 0; patch < 4; patch++) {
+          std::string base = std::to_string(major) + "." + std::to_string(minor) + "." + std::to_string(patch);
+
+          strings.emplace_back(base);
+          strings.emplace_back(base + "-beta." + std::to_string(patch + 1));
+          strings.emplace_back(base + "+build." + std::to_string(minor * 100 + patch));
+        }
+      }
+    }
+
+    // Some malformed tags, like branch names.
+    strings.emplace_back("master");
+    strings.emplace_back("1.0");
+    strings.emplace_back("01.2.3");
+
+    return strings;
+  }();
+
+  return strings;
+}
+
+void BM_ParseVersion (benchmark::State &state)
+{
+  const auto &strings = versionStrings();
+
+  for (auto _ : state) {
+    for (const auto &string : strings) {
+      benchmark::DoNotOptimize(ArbiterSemanticVersion::fromString(string));
+    }
+  }
+
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(strings.size()));
+}
+
+void BM_ParseVersionWithRegex (benchmark::State &state)
+{
+  const auto &strings = versionStrings();
+
+  for (auto _ : state) {
+    for (const auto &string : strings) {
+      benchmark::DoNotOptimize(regexFromString(string));
+    }
+  }
+
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(strings.size()));
+}
+
+void BM_ParseVersionsInBulk (benchmark::State &state)
+{
+  const auto &strings = versionStrings();
+
+  std::vector<const char *> cStrings;
+  for (const auto &string : strings) {
+    cStrings.emplace_back(string.c_str());
+  }
+
+  std::vector<ArbiterSemanticVersion *> versions(cStrings.size());
+
+  for (auto _ : state) {
+    ArbiterCreateSemanticVersionsFromStrings(cStrings.data(), cStrings.size(), versions.data());
+
+    for (ArbiterSemanticVersion *version : versions) {
+      ArbiterFree(version);
+    }
+  }
+
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(strings.size()));
+}
+
+void BM_CompareVersions (benchmark::State &state)
+{
+  std::vector<ArbiterSemanticVersion> versions;
+  for (const auto &string : versionStrings()) {
+    auto version = ArbiterSemanticVersion::fromString(string);
+    if (version) {
+      versions.emplace_back(std::move(*version));
+    }
+  }
+
+  for (auto _ : state) {
+    size_t lessCount = 0;
+
+    for (const auto &lhs : versions) {
+      for (const auto &rhs : versions) {
+        lessCount += lhs < rhs;
+      }
+    }
+
+    benchmark::DoNotOptimize(lessCount);
+  }
+
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(versions.size() * versions.size()));
+}
+
+} // namespace
+
+BENCHMARK(BM_CompareVersions);
+BENCHMARK(BM_ParseVersion);
+BENCHMARK(BM_ParseVersionWithRegex);
+BENCHMARK(BM_ParseVersionsInBulk);
@@ -72,7 +72,8 @@ extension ArbiterValue {
       destructor: { ptr in
         let wrapper = Unmanaged<UserValueWrapper>.fromOpaque(COpaquePointer(ptr)).takeRetainedValue()
         wrapper.destructor(wrapper.data)
-      })
+      },
+      createSerialization: nil)
   }
 
   /**
@@ -2,7 +2,6 @@
 
 #include "asprintf.h"
 #include "strerror.h"
-#include "string_value.h"
 
 #include <arbiter/Requirement.h>
 #include <arbiter/Types.h>
@@ -147,8 +146,7 @@ ArbiterDependencyList *create_dependency_list_from_path (const char *path, char
       ArbiterFree(semanticVersion);
     }
 
-    ArbiterUserValue dependencyValue = string_value_from_string(dependencyPath, strlen(dependencyPath));
-    ArbiterProjectIdentifier *dependencyProject = ArbiterCreateProjectIdentifier(dependencyValue);
+    ArbiterProjectIdentifier *dependencyProject = ArbiterCreateProjectIdentifierFromString(dependencyPath, strlen(dependencyPath));
 
     dependencies[dependenciesCount - 1] = ArbiterCreateDependency(dependencyProject, requirement);
 
@@ -201,8 +199,7 @@ ArbiterSelectedVersionList *create_available_versions_list (const ArbiterResolve
       continue;
     }
 
-    ArbiterUserValue versionValue = string_value_from_string(name, strlen(name));
-    ArbiterSelectedVersion *selectedVersion = ArbiterCreateSelectedVersion(semanticVersion, versionValue);
+    ArbiterSelectedVersion *selectedVersion = ArbiterCreateSelectedVersionWithStringMetadata(semanticVersion, name, strlen(name));
 
     ArbiterFree(semanticVersion);
 
@@ -1,7 +0,0 @@
-#pragma once
-
-#include <arbiter/Value.h>
-
-#include <stddef.h>
-
-ArbiterUserValue string_value_from_string (const char *str, size_t length);
@@ -0,0 +1,104 @@
+#ifndef ARBITER_BATCH_H
+#define ARBITER_BATCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <arbiter/Resolver.h>
+#include <arbiter/Value.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+// forward declarations
+struct ArbiterDependencyList;
+struct ArbiterResolvedDependencyGraph;
+
+/**
+ * One set of dependencies to resolve as part of a batch.
+ */
+typedef struct
+{
+  /**
+   * The dependencies to resolve, as passed to ArbiterCreateResolver().
+   */
+  const struct ArbiterDependencyList *dependenciesToResolve;
+
+  /**
+   * The initial graph, as passed to ArbiterCreateResolver(). This may be NULL.
+   */
+  const struct ArbiterResolvedDependencyGraph *initialGraph;
+} ArbiterResolverBatchEntry;
+
+/**
+ * The outcome of resolving one entry of a batch.
+ */
+typedef struct
+{
+  /**
+   * The resolved graph, which the caller is responsible for freeing, or NULL
+   * if resolution failed.
+   */
+  struct ArbiterResolvedDependencyGraph *graph;
+
+  /**
+   * A string describing why resolution failed, which must be freed with
+   * free(), or NULL if it succeeded.
+   */
+  char *error;
+} ArbiterResolverBatchResult;
+
+/**
+ * Statistics about a whole batch.
+ */
+typedef struct
+{
+  /**
+   * The total time taken, in seconds.
+   */
+  double durationSeconds;
+
+  /**
+   * The number of times each of the behaviors passed to ArbiterResolveBatch()
+   * was actually invoked.
+   */
+  uint64_t availableVersionFetches;
+  uint64_t dependencyListFetches;
+
+  /**
+   * The number of times that a resolver in the batch needed available
+   * versions or a dependency list which another resolver had already fetched
+   * (or was fetching), and so did not invoke the behavior again.
+   */
+  uint64_t sharedFetches;
+} ArbiterResolverBatchStatistics;
+
+/**
+ * Resolves `count` entries concurrently, on up to `threadCount` threads, and
+ * writes the outcome of each entry into the corresponding element of the
+ * C array `results`.
+ *
+ * Each entry is resolved as if by its own resolver created with
+ * ArbiterCreateResolver() from `behaviors` and `context`, except that the
+ * available versions and dependency lists of each project are only fetched
+ * once for the whole batch, and then shared between the resolvers. The batch
+ * assumes that the behaviors return the same results for the same inputs
+ * throughout, including when they fail.
+ *
+ * The behaviors may be invoked from any of the threads at once, so they must be
+ * thread-safe. The resolver passed to them is only valid for use with
+ * ArbiterResolverContext().
+ *
+ * If `threadCount` is zero, one thread is used per processor. If `statistics`
+ * is not NULL, statistics about the batch are copied into it.
+ *
+ * Returns the number of entries which were resolved successfully.
+ */
+size_t ArbiterResolveBatch (ArbiterResolverBehaviors behaviors, const ArbiterResolverBatchEntry *entries, size_t count, ArbiterUserContext context, size_t threadCount, ArbiterResolverBatchResult *results, ArbiterResolverBatchStatistics *statistics);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
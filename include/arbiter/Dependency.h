@@ -56,6 +56,22 @@ typedef struct ArbiterDependencyList ArbiterDependencyList;
  */
 ArbiterDependencyList *ArbiterCreateDependencyList (const ArbiterDependency * const *dependencies, size_t count);
 
+/**
+ * Returns the number of dependencies in the given list, for use with
+ * ArbiterDependencyListGetAll().
+ */
+size_t ArbiterDependencyListCount (const ArbiterDependencyList *dependencyList);
+
+/**
+ * Copies pointers to all of the dependencies in the given list into the C array
+ * `buffer`, which must have enough space to contain
+ * ArbiterDependencyListCount() elements.
+ *
+ * The copied pointers are guaranteed to remain valid until the
+ * ArbiterDependencyList they were obtained from is freed.
+ */
+void ArbiterDependencyListGetAll (const ArbiterDependencyList *dependencyList, const ArbiterDependency **buffer);
+
 /**
  * Represents a dependency which has been resolved to a specific version.
  */
@@ -5,6 +5,8 @@
 extern "C" {
 #endif
 
+#include <arbiter/Value.h>
+
 #include <stdbool.h>
 #include <stddef.h>
 
@@ -17,6 +19,9 @@ struct ArbiterSelectedVersion;
 /**
  * Represents a fully consistent, resolved dependency graph, preserving
  * relationships between dependencies.
+ *
+ * Functions which take a const graph may be called from many threads at once,
+ * including those which lazily build and cache an index of the graph.
  */
 typedef struct ArbiterResolvedDependencyGraph ArbiterResolvedDependencyGraph;
 
@@ -72,7 +77,8 @@ bool ArbiterResolvedDependencyGraphAddEdge (ArbiterResolvedDependencyGraph *grap
 
 /**
  * Returns the number of unique nodes in the given graph, for use with
- * ArbiterResolvedDependencyGraphGetAll().
+ * ArbiterResolvedDependencyGraphGetAll() and
+ * ArbiterResolvedDependencyGraphCopyAll().
  *
  * The returned count may be invalidated if the graph is modified.
  */
@@ -89,6 +95,46 @@ size_t ArbiterResolvedDependencyGraphCount (const ArbiterResolvedDependencyGraph
  */
 void ArbiterResolvedDependencyGraphCopyAll (const ArbiterResolvedDependencyGraph *graph, struct ArbiterResolvedDependency **buffer);
 
+/**
+ * Copies pointers to all of the resolved dependencies in the given graph into
+ * the C array `nodes`, and pointers to their requirements into the C array
+ * `requirements`. Each array must have enough space to contain
+ * ArbiterResolvedDependencyGraphCount() elements, or be NULL to skip it.
+ *
+ * This operation guarantees that nodes will appear in ascending order of their
+ * project identifiers, and that the requirement at each index corresponds to
+ * the node at the same index.
+ *
+ * Unlike ArbiterResolvedDependencyGraphCopyAll(), this does not allocate
+ * anything once the graph has been read. The copied pointers are guaranteed
+ * to remain valid until the ArbiterResolvedDependencyGraph they were obtained
+ * from is modified or freed.
+ */
+void ArbiterResolvedDependencyGraphGetAll (const ArbiterResolvedDependencyGraph *graph, const struct ArbiterResolvedDependency **nodes, const struct ArbiterRequirement **requirements);
+
+/**
+ * Returns the number of edges in the given graph, for use with
+ * ArbiterResolvedDependencyGraphGetAllEdges().
+ *
+ * The returned count may be invalidated if the graph is modified.
+ */
+size_t ArbiterResolvedDependencyGraphCountEdges (const ArbiterResolvedDependencyGraph *graph);
+
+/**
+ * Copies every edge of the given graph into C arrays, where nodes are
+ * identified by their index in the order used by
+ * ArbiterResolvedDependencyGraphGetAll().
+ *
+ * The dependencies of node `i` are written to `dependencies`, in ascending
+ * order, from index `offsets[i]` up to (but not including) `offsets[i + 1]`.
+ *
+ * `offsets` must have enough space to contain
+ * ArbiterResolvedDependencyGraphCount() + 1 elements, and `dependencies` must
+ * have enough space to contain ArbiterResolvedDependencyGraphCountEdges()
+ * elements.
+ */
+void ArbiterResolvedDependencyGraphGetAllEdges (const ArbiterResolvedDependencyGraph *graph, size_t *offsets, size_t *dependencies);
+
 /**
  * Returns the version which was selected for the given project in the
  * dependency graph, or NULL if the project is not part of the graph.
@@ -142,10 +188,23 @@ typedef struct ArbiterResolvedDependencyInstaller ArbiterResolvedDependencyInsta
  *
  * The dependency graph can be safely freed after calling this function.
  *
+ * Returns the created installer, or NULL if the graph contains a dependency
+ * cycle. Use ArbiterResolvedDependencyInstallerCreateWithError() to find out
+ * which projects are part of the cycle.
+ *
  * The returned installer must be freed with ArbiterFree().
  */
 ArbiterResolvedDependencyInstaller *ArbiterResolvedDependencyInstallerCreate (const ArbiterResolvedDependencyGraph *graph);
 
+/**
+ * Like ArbiterResolvedDependencyInstallerCreate(), except that if NULL is
+ * returned and `error` is not NULL, it may be set to a string describing the
+ * dependency cycle, which the caller is responsible for freeing.
+ *
+ * The returned installer must be freed with ArbiterFree().
+ */
+ArbiterResolvedDependencyInstaller *ArbiterResolvedDependencyInstallerCreateWithError (const ArbiterResolvedDependencyGraph *graph, char **error);
+
 /**
  * Returns the number of phases that the installer has, for use with
  * ArbiterResolvedDependencyInstallerCountInPhase() and
@@ -176,6 +235,88 @@ size_t ArbiterResolvedDependencyInstallerCountInPhase (const ArbiterResolvedDepe
  */
 void ArbiterResolvedDependencyInstallerGetAllInPhase (const ArbiterResolvedDependencyInstaller *installer, size_t phaseIndex, const struct ArbiterResolvedDependency **buffer);
 
+/**
+ * Hands out the projects of a resolved dependency graph for installation one at
+ * a time, as soon as all of their dependencies have been installed.
+ *
+ * Unlike ArbiterResolvedDependencyInstaller, there is no barrier between
+ * phases, so one slow installation only delays the projects which actually
+ * depend upon it. When several projects are ready at once, the one with the
+ * most expensive chain of dependents (the "critical path") is handed out first.
+ *
+ * All scheduler functions are safe to call from multiple threads at once.
+ */
+typedef struct ArbiterResolvedDependencyScheduler ArbiterResolvedDependencyScheduler;
+
+/**
+ * Estimates the cost of installing the given resolved dependency, in whatever
+ * units the caller likes (for example, seconds). Negative costs are treated as
+ * zero.
+ */
+typedef double (*ArbiterResolvedDependencyCostFunction)(const struct ArbiterResolvedDependency *dependency, const void *context);
+
+/**
+ * Creates a scheduler for the given resolved dependency graph.
+ *
+ * `costFunction` is invoked once for each project in the graph before this
+ * function returns, with the data from `context`. If it is NULL, every project
+ * is assumed to have the same cost.
+ *
+ * `workerCount` is the maximum number of projects which may be installed
+ * concurrently, or 0 for no limit.
+ *
+ * The dependency graph can be safely freed after calling this function.
+ *
+ * Returns the created scheduler, or NULL if the graph contains a dependency
+ * cycle. If NULL is returned and `error` is not NULL, it may be set to a string
+ * describing the cycle, which the caller is responsible for freeing.
+ *
+ * The returned scheduler must be freed with ArbiterFree().
+ */
+ArbiterResolvedDependencyScheduler *ArbiterResolvedDependencySchedulerCreate (const ArbiterResolvedDependencyGraph *graph, ArbiterResolvedDependencyCostFunction costFunction, ArbiterUserContext context, size_t workerCount, char **error);
+
+/**
+ * Returns the next resolved dependency which should be installed, marking it as
+ * in progress, or NULL if none can be started right now. This does not block.
+ *
+ * NULL is returned when all remaining projects are waiting on dependencies
+ * which are still in progress, when `workerCount` projects are already in
+ * progress, or when every project has been installed.
+ *
+ * The returned pointer is guaranteed to remain valid until the
+ * ArbiterResolvedDependencyScheduler it was obtained from is freed.
+ */
+const struct ArbiterResolvedDependency *ArbiterResolvedDependencySchedulerNext (ArbiterResolvedDependencyScheduler *scheduler);
+
+/**
+ * Like ArbiterResolvedDependencySchedulerNext(), but blocks the calling thread
+ * until a resolved dependency can be started. NULL is only returned once every
+ * project has been installed.
+ *
+ * This is useful for a pool of worker threads which each loop over this
+ * function and ArbiterResolvedDependencySchedulerMarkCompleted().
+ */
+const struct ArbiterResolvedDependency *ArbiterResolvedDependencySchedulerWaitForNext (ArbiterResolvedDependencyScheduler *scheduler);
+
+/**
+ * Marks a resolved dependency previously returned from
+ * ArbiterResolvedDependencySchedulerNext() or
+ * ArbiterResolvedDependencySchedulerWaitForNext() as installed, which may allow
+ * its dependents to be started.
+ *
+ * Returns whether the dependency could be marked as installed. If false is
+ * returned (because the dependency is not currently being installed) and
+ * `error` is not NULL, it may be set to a string describing the error, which
+ * the caller is responsible for freeing.
+ */
+bool ArbiterResolvedDependencySchedulerMarkCompleted (ArbiterResolvedDependencyScheduler *scheduler, const struct ArbiterResolvedDependency *dependency, char **error);
+
+/**
+ * Returns whether every project in the scheduler's graph has been marked as
+ * installed.
+ */
+bool ArbiterResolvedDependencySchedulerIsFinished (const ArbiterResolvedDependencyScheduler *scheduler);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,162 @@
+#ifndef ARBITER_LIMITS_H
+#define ARBITER_LIMITS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <arbiter/Value.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// forward declarations
+struct ArbiterResolvedDependencyGraph;
+struct ArbiterResolver;
+
+/**
+ * A snapshot of how far the current resolution has progressed.
+ */
+typedef struct
+{
+  /**
+   * The level of resolution currently being explored, where 1 is the level
+   * containing the dependencies passed to ArbiterCreateResolver().
+   */
+  size_t depth;
+
+  /**
+   * The number of combinations of versions which have failed so far.
+   */
+  uint64_t deadEnds;
+
+  /**
+   * The number of times the behaviors provided to ArbiterCreateResolver()
+   * have been invoked so far.
+   */
+  uint64_t fetches;
+
+  /**
+   * The number of projects whose available versions have been fetched so far.
+   */
+  uint64_t fetchedProjects;
+
+  /**
+   * The time since the resolution began, in seconds.
+   */
+  double elapsedSeconds;
+} ArbiterResolverProgress;
+
+/**
+ * Receives the progress of a resolution, along with the context data provided
+ * when the limits were set.
+ *
+ * Returns whether the resolution should continue. Returning false cancels it.
+ */
+typedef bool (*ArbiterResolverProgressFunction)(const ArbiterResolverProgress *progress, const void *context);
+
+/**
+ * Limits on the work that a single resolution may do before it is cancelled.
+ *
+ * A limit of zero means that there is no limit.
+ */
+typedef struct
+{
+  /**
+   * The longest that one resolution may take, in seconds.
+   */
+  double timeLimitSeconds;
+
+  /**
+   * The most combinations of versions which may fail in one resolution.
+   */
+  uint64_t maxDeadEnds;
+
+  /**
+   * The most times that the behaviors provided to ArbiterCreateResolver() may
+   * be invoked in one resolution. Results cached from earlier resolutions do
+   * not count.
+   */
+  uint64_t maxFetches;
+
+  /**
+   * A function to periodically report progress to, which may cancel the
+   * resolution, or NULL.
+   */
+  ArbiterResolverProgressFunction progress;
+
+  /**
+   * The least time between calls to `progress`, in seconds. If zero, it is
+   * called whenever a new combination of versions is tried.
+   */
+  double progressIntervalSeconds;
+} ArbiterResolverLimits;
+
+/**
+ * Why a resolution was cancelled.
+ */
+typedef enum
+{
+  /**
+   * The resolution was not cancelled.
+   */
+  ArbiterResolverCancellationNone,
+
+  /**
+   * The resolution exceeded `timeLimitSeconds`.
+   */
+  ArbiterResolverCancellationTimeLimit,
+
+  /**
+   * The resolution exceeded `maxDeadEnds`.
+   */
+  ArbiterResolverCancellationDeadEndLimit,
+
+  /**
+   * The resolution exceeded `maxFetches`.
+   */
+  ArbiterResolverCancellationFetchLimit,
+
+  /**
+   * The `progress` function returned false.
+   */
+  ArbiterResolverCancellationRequested,
+} ArbiterResolverCancellation;
+
+/**
+ * Limits the work done by subsequent resolutions, replacing any limits that
+ * were previously set on the resolver.
+ *
+ * `limits` may be NULL to remove all limits, which is the default. Limits are
+ * checked whenever a new combination of versions is tried, and after each
+ * invocation of a behavior, so a resolution may run over its time limit by as
+ * long as one behavior takes to return.
+ *
+ * When a resolution is cancelled, it fails with an error describing why, and
+ * ArbiterResolverGetCancellation() and
+ * ArbiterResolverCreatePartialDependencyGraph() may be used to learn more.
+ */
+void ArbiterResolverSetLimits (struct ArbiterResolver *resolver, const ArbiterResolverLimits *limits, ArbiterUserContext context);
+
+/**
+ * Returns why the most recent resolution was cancelled, or
+ * ArbiterResolverCancellationNone if it was not.
+ */
+ArbiterResolverCancellation ArbiterResolverGetCancellation (const struct ArbiterResolver *resolver);
+
+/**
+ * Returns the graph that the most recent resolution was building when it was
+ * cancelled, which satisfies every dependency it contains but may be missing
+ * others.
+ *
+ * Returns NULL if the most recent resolution was not cancelled. The caller is
+ * responsible for freeing the returned graph.
+ */
+struct ArbiterResolvedDependencyGraph *ArbiterResolverCreatePartialDependencyGraph (const struct ArbiterResolver *resolver);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
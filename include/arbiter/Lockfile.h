@@ -0,0 +1,169 @@
+#ifndef ARBITER_LOCKFILE_H
+#define ARBITER_LOCKFILE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <arbiter/Value.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// forward declarations
+struct ArbiterProjectIdentifier;
+struct ArbiterRequirement;
+struct ArbiterResolvedDependencyGraph;
+struct ArbiterSelectedVersion;
+
+/**
+ * Receives a chunk of a lockfile being written.
+ *
+ * Returns whether the chunk was written successfully. If false, writing will be
+ * aborted.
+ */
+typedef bool (*ArbiterLockfileWriteFunction)(const void *bytes, size_t length, void *context);
+
+/**
+ * Writes the given dependency graph into a lockfile at `path`, replacing any
+ * file which already exists there.
+ *
+ * Every project identifier and version metadata object in the graph (including
+ * those referenced by requirements) must either have been created from
+ * a string, or from an ArbiterUserValue with a `createSerialization` callback.
+ * Custom requirements cannot be written.
+ *
+ * Returns whether writing succeeded. If false and `error` is not NULL, it may
+ * be set to a string describing the error, which must be freed with free().
+ */
+bool ArbiterResolvedDependencyGraphWriteLockfile (const struct ArbiterResolvedDependencyGraph *graph, const char *path, char **error);
+
+/**
+ * Writes the given dependency graph as a lockfile, in sequential chunks passed
+ * to `write`.
+ *
+ * This has the same requirements and error handling as
+ * ArbiterResolvedDependencyGraphWriteLockfile().
+ */
+bool ArbiterResolvedDependencyGraphWriteLockfileToFunction (const struct ArbiterResolvedDependencyGraph *graph, ArbiterLockfileWriteFunction write, void *context, char **error);
+
+/**
+ * Callbacks to recreate user values which were written into a lockfile using
+ * their `createSerialization` callbacks. Values which were created from strings
+ * do not need these.
+ */
+typedef struct
+{
+  /**
+   * Creates the value for an ArbiterProjectIdentifier from the `length` bytes
+   * of its serialization.
+   *
+   * This may be NULL if the lockfile does not contain any such identifiers.
+   */
+  ArbiterUserValue (*createProjectIdentifierValue)(const void *bytes, size_t length, const void *context);
+
+  /**
+   * Creates the metadata for an ArbiterSelectedVersion from the `length`
+   * bytes of its serialization.
+   *
+   * This may be NULL if the lockfile does not contain any such metadata.
+   */
+  ArbiterUserValue (*createSelectedVersionMetadata)(const void *bytes, size_t length, const void *context);
+
+  /**
+   * Passed to the callbacks above.
+   */
+  const void *context;
+} ArbiterLockfileValueReaders;
+
+/**
+ * A lockfile which has been mapped into memory, and can be queried without
+ * reading it in full.
+ *
+ * Nodes in the lockfile are identified by index, in ascending (bytewise) order
+ * of the serializations of their project identifiers.
+ */
+typedef struct ArbiterLockfile ArbiterLockfile;
+
+/**
+ * Maps the lockfile at `path` into memory, and validates its structure.
+ *
+ * Returns the lockfile, which must be freed with ArbiterFree(), or NULL if an
+ * error occurred. If NULL is returned and `error` is not NULL, it may be set to
+ * a string describing the error, which must be freed with free().
+ */
+ArbiterLockfile *ArbiterLockfileOpen (const char *path, ArbiterLockfileValueReaders readers, char **error);
+
+/**
+ * Returns the number of nodes in the lockfile.
+ */
+size_t ArbiterLockfileCount (const ArbiterLockfile *lockfile);
+
+/**
+ * Looks up a node by the serialization of its project identifier (or the
+ * string it was created from), using a binary search.
+ *
+ * Returns whether the node was found, and if so, sets `index` to its index.
+ */
+bool ArbiterLockfileFind (const ArbiterLockfile *lockfile, const void *projectBytes, size_t length, size_t *index);
+
+/**
+ * Returns the serialization of the project identifier at `index` (or the
+ * string it was created from), and sets `length` to its size in bytes.
+ *
+ * The returned pointer points into the mapped lockfile, and remains valid until
+ * the lockfile is freed.
+ */
+const void *ArbiterLockfileProjectBytes (const ArbiterLockfile *lockfile, size_t index, size_t *length);
+
+/**
+ * Creates the project identifier of the node at `index`.
+ *
+ * Returns the identifier, which must be freed with ArbiterFree(), or NULL if an
+ * error occurred, with the same error handling as ArbiterLockfileOpen().
+ */
+struct ArbiterProjectIdentifier *ArbiterLockfileCreateProjectIdentifier (const ArbiterLockfile *lockfile, size_t index, char **error);
+
+/**
+ * Creates the selected version of the node at `index`.
+ *
+ * Returns the version, which must be freed with ArbiterFree(), or NULL if an
+ * error occurred, with the same error handling as ArbiterLockfileOpen().
+ */
+struct ArbiterSelectedVersion *ArbiterLockfileCreateSelectedVersion (const ArbiterLockfile *lockfile, size_t index, char **error);
+
+/**
+ * Creates the requirement of the node at `index`.
+ *
+ * Returns the requirement, which must be freed with ArbiterFree(), or NULL if
+ * an error occurred, with the same error handling as ArbiterLockfileOpen().
+ */
+struct ArbiterRequirement *ArbiterLockfileCreateRequirement (const ArbiterLockfile *lockfile, size_t index, char **error);
+
+/**
+ * Returns the number of dependencies of the node at `index`.
+ */
+size_t ArbiterLockfileCountDependencies (const ArbiterLockfile *lockfile, size_t index);
+
+/**
+ * Copies the indexes of the dependencies of the node at `index` into the
+ * C array `buffer`, which must have enough space to contain
+ * ArbiterLockfileCountDependencies() elements.
+ *
+ * The indexes will appear in ascending order.
+ */
+void ArbiterLockfileGetAllDependencies (const ArbiterLockfile *lockfile, size_t index, size_t *buffer);
+
+/**
+ * Reads the entire lockfile into a new dependency graph.
+ *
+ * Returns the graph, which must be freed with ArbiterFree(), or NULL if an
+ * error occurred, with the same error handling as ArbiterLockfileOpen().
+ */
+struct ArbiterResolvedDependencyGraph *ArbiterLockfileCreateResolvedDependencyGraph (const ArbiterLockfile *lockfile, char **error);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
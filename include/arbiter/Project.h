@@ -20,6 +20,19 @@ typedef struct ArbiterProjectIdentifier ArbiterProjectIdentifier;
  */
 ArbiterProjectIdentifier *ArbiterCreateProjectIdentifier (ArbiterUserValue value);
 
+/**
+ * Creates a project identifier from a string of `length` bytes, which will be
+ * copied.
+ *
+ * Identifiers created this way are hashed and compared by Arbiter itself,
+ * without invoking any callbacks, and ArbiterProjectIdentifierValue() will
+ * return the string as a NUL-terminated `const char *`. They must not be
+ * compared against identifiers created with ArbiterCreateProjectIdentifier().
+ *
+ * The returned identifier must be freed with ArbiterFree().
+ */
+ArbiterProjectIdentifier *ArbiterCreateProjectIdentifierFromString (const char *string, size_t length);
+
 /**
  * Returns the opaque data which was provided to ArbiterCreateProjectIdentifier().
  *
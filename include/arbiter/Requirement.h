@@ -9,10 +9,12 @@ extern "C" {
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 // forward declarations
 struct ArbiterSemanticVersion;
 struct ArbiterSelectedVersion;
+struct ArbiterSelectedVersionList;
 
 /**
  * How strict to be in matching compatible versions.
@@ -37,6 +39,9 @@ typedef enum
 
 /**
  * Represents a requirement for a specific version or set of versions.
+ *
+ * Requirements are immutable, so one may be evaluated, intersected, copied,
+ * and compared from many threads at once.
  */
 typedef struct ArbiterRequirement ArbiterRequirement;
 
@@ -46,6 +51,15 @@ typedef struct ArbiterRequirement ArbiterRequirement;
  */
 typedef bool (*ArbiterRequirementPredicate)(const struct ArbiterSelectedVersion *version, const void *context);
 
+/**
+ * A predicate used to determine whether each of the given versions suitably
+ * satisfies the requirement.
+ *
+ * The predicate must set `results[i]` to whether `versions[i]` satisfies the
+ * requirement, for every `i` less than `count`.
+ */
+typedef void (*ArbiterRequirementBatchPredicate)(const struct ArbiterSelectedVersion * const *versions, size_t count, bool *results, const void *context);
+
 /**
  * Creates a requirement which will match any version.
  *
@@ -89,17 +103,45 @@ ArbiterRequirement *ArbiterCreateRequirementExactly (const struct ArbiterSemanti
  */
 ArbiterRequirement *ArbiterCreateRequirementUnversioned (ArbiterUserValue metadata);
 
+/**
+ * Creates a requirement which only matches against `ArbiterSelectedVersion`s
+ * that have string metadata equal to the `length` bytes of `metadata`, as
+ * created with ArbiterCreateSelectedVersionWithStringMetadata().
+ *
+ * The returned requirement must be freed with ArbiterFree().
+ */
+ArbiterRequirement *ArbiterCreateRequirementUnversionedWithString (const char *metadata, size_t length);
+
 /**
  * Creates a requirement which will evaluate a custom predicate whenever
  * a specific version is checked against it.
  *
  * The predicate may be invoked many times during dependency resolution, so it
- * should not take a long time to complete.
+ * should not take a long time to complete. If the requirement (or a copy of
+ * it) is used from several threads, the predicate may be invoked from all of
+ * them at once.
  *
  * The returned requirement must be freed with ArbiterFree().
  */
 ArbiterRequirement *ArbiterCreateRequirementCustom (ArbiterRequirementPredicate predicate, ArbiterUserContext context);
 
+/**
+ * Creates a requirement which will evaluate a custom predicate, like
+ * ArbiterCreateRequirementCustom(), but which can also check many versions with
+ * a single call.
+ *
+ * During dependency resolution, `batchPredicate` will be preferred whenever
+ * a project's available versions are filtered, and its results will be cached
+ * for the remainder of the resolution. `predicate` will be used to check
+ * individual versions.
+ *
+ * `predicate` may be NULL, in which case `batchPredicate` will also be used to
+ * check individual versions. `batchPredicate` must not be NULL.
+ *
+ * The returned requirement must be freed with ArbiterFree().
+ */
+ArbiterRequirement *ArbiterCreateRequirementCustomBatch (ArbiterRequirementPredicate predicate, ArbiterRequirementBatchPredicate batchPredicate, ArbiterUserContext context);
+
 /**
  * Creates a compound requirement that evaluates each of a list of requirements.
  * All of the requirements must be satisfied for the compound requirement to be
@@ -155,6 +197,25 @@ ArbiterRequirement *ArbiterCreateRequirementPrioritized (const ArbiterRequiremen
  */
 bool ArbiterRequirementSatisfiedBy (const ArbiterRequirement *requirement, const struct ArbiterSelectedVersion *version);
 
+/**
+ * Determines which of the versions in the given list satisfy the given
+ * requirement, evaluating all of them at once.
+ *
+ * This is equivalent to calling ArbiterRequirementSatisfiedBy() for each
+ * version in the list, but can be much faster for large lists, since
+ * requirements upon semantic versions are evaluated using vectorized
+ * comparisons.
+ *
+ * Unlike dependency resolution, this function does not cache the results of
+ * custom predicates.
+ *
+ * `bitmask` must have room for `(count + 63) / 64` elements, where `count` is
+ * ArbiterSelectedVersionListCount(). Upon return, bit `i % 64` of
+ * `bitmask[i / 64]` will be set if and only if the version at index `i` of the
+ * list satisfies the requirement. All other bits will be cleared.
+ */
+void ArbiterRequirementSatisfiedByEach (const ArbiterRequirement *requirement, const struct ArbiterSelectedVersionList *versions, uint64_t *bitmask);
+
 /**
  * Returns the priority of the given requirement. See
  * ArbiterCreateRequirementPrioritized() for more information.
@@ -8,6 +8,8 @@ extern "C" {
 #include <arbiter/Value.h>
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 // forward declarations
 struct ArbiterDependencyList;
@@ -19,6 +21,10 @@ struct ArbiterSelectedVersionList;
 /**
  * A dependency resolver which contains context about how to evaluate the
  * dependency graph.
+ *
+ * A resolver must only be used by one thread at a time, and its behaviors are
+ * invoked on that thread. To resolve several sets of dependencies at once, use
+ * one resolver per thread, or ArbiterResolveBatch().
  */
 typedef struct ArbiterResolver ArbiterResolver;
 
@@ -125,6 +131,172 @@ const void *ArbiterResolverContext (const ArbiterResolver *resolver);
  */
 struct ArbiterResolvedDependencyGraph *ArbiterResolverCreateResolvedDependencyGraph (ArbiterResolver *resolver, char **error);
 
+/**
+ * Checks whether the resolver's `initialGraph` already satisfies
+ * `dependenciesToResolve` and all of their transitive dependencies, in which
+ * case resolution would return the same graph.
+ *
+ * Unlike ArbiterResolverCreateResolvedDependencyGraph(), this does not search
+ * for other versions, and visits each project and dependency in the graph at
+ * most once. The `createDependencyList` behavior is invoked once for each
+ * project reachable in the graph (unless a previous resolution already fetched
+ * its dependencies), and `createAvailableVersionsList` is never invoked.
+ * Projects in the graph which are not reachable from `dependenciesToResolve`
+ * are ignored.
+ *
+ * A dependency is unsatisfied if its project is missing from the graph, if the
+ * version selected in the graph does not satisfy its requirement, or if the
+ * graph is missing the edge from the project which depends upon it.
+ *
+ * Returns a list of every unsatisfied dependency, without duplicates, which is
+ * empty if the graph is already complete and consistent, or NULL if an error
+ * occurred. The caller is responsible for freeing the returned list. If NULL is returned and `error`
+ * is not NULL, it may be set to a string describing the error, which the
+ * caller is responsible for freeing.
+ */
+struct ArbiterDependencyList *ArbiterResolverCreateUnsatisfiedDependencyList (ArbiterResolver *resolver, char **error);
+
+/**
+ * Memory allocated for one purpose, in bytes.
+ */
+typedef struct
+{
+  /**
+   * The bytes allocated at the end of the measurement.
+   */
+  uint64_t currentBytes;
+
+  /**
+   * The most bytes allocated at any one time during the measurement.
+   */
+  uint64_t peakBytes;
+} ArbiterMemoryUsage;
+
+/**
+ * Statistics about the work done by the most recent call to
+ * ArbiterResolverCreateResolvedDependencyGraph() or
+ * ArbiterResolverCreateUnsatisfiedDependencyList() on a resolver.
+ *
+ * New fields will only ever be added to the end of this structure.
+ */
+typedef struct
+{
+  /**
+   * The total time taken, in seconds.
+   */
+  double durationSeconds;
+
+  /**
+   * The time spent waiting for the behaviors provided to
+   * ArbiterCreateResolver() to return, in seconds. The remainder of
+   * `durationSeconds` was spent within Arbiter itself.
+   */
+  double behaviorSeconds;
+
+  /**
+   * The number of times each of the behaviors provided to
+   * ArbiterCreateResolver() was invoked.
+   */
+  uint64_t availableVersionFetches;
+  uint64_t dependencyListFetches;
+  uint64_t selectedVersionForMetadataFetches;
+
+  /**
+   * The number of times that available versions or dependency lists were
+   * needed, but had already been fetched (possibly by an earlier resolution).
+   *
+   * The hit rate of each cache is its hits divided by the sum of its hits and
+   * fetches.
+   */
+  uint64_t availableVersionCacheHits;
+  uint64_t dependencyListCacheHits;
+
+  /**
+   * The number of times that the result of a custom requirement's predicate
+   * was or was not already known for every version of a project.
+   */
+  uint64_t predicateCacheHits;
+  uint64_t predicateCacheMisses;
+
+  /**
+   * The number of combinations of versions which were tried, and the number
+   * of those which failed.
+   */
+  uint64_t permutationsAttempted;
+  uint64_t deadEnds;
+
+  /**
+   * The number of times a partially-resolved graph was copied in order to try
+   * a combination of versions.
+   */
+  uint64_t graphCopies;
+
+  /**
+   * The number of times a requirement was intersected with an existing
+   * requirement for the same project.
+   */
+  uint64_t requirementIntersections;
+
+  /**
+   * The deepest level of transitive dependencies which was reached.
+   */
+  uint64_t maxDepth;
+
+  /**
+   * The most candidate versions which were being permuted together at any one
+   * depth.
+   */
+  uint64_t peakCandidates;
+
+  /**
+   * The memory used by the resolver to cache available versions and
+   * dependency lists, which persists across resolutions. This excludes user
+   * data, and the contents of version strings.
+   */
+  ArbiterMemoryUsage availableVersionsMemory;
+  ArbiterMemoryUsage dependencyListsMemory;
+
+  /**
+   * The memory used for candidate dependency graphs, and for the rest of the
+   * state of the search. Both are released when the next resolution begins.
+   */
+  ArbiterMemoryUsage candidateGraphMemory;
+  ArbiterMemoryUsage searchStateMemory;
+
+  /**
+   * The memory used by every requirement in the process, including those
+   * owned by the caller or by other resolvers. The peak is measured over the
+   * lifetime of the process.
+   */
+  ArbiterMemoryUsage requirementMemory;
+
+  /**
+   * The bytes reserved for the resolver's scratch memory, from which candidate
+   * graphs and most of the search state are allocated. This may exceed their
+   * peak usage, since it is retained for reuse across resolutions.
+   */
+  uint64_t arenaReservedBytes;
+
+  /**
+   * 1 if the resolved graph was found in the ArbiterResultCache set on the
+   * resolver, in which case no other work was done, or 0 otherwise.
+   */
+  uint64_t resultCacheHits;
+} ArbiterResolverStatistics;
+
+/**
+ * Copies statistics about the most recent resolution into `statistics`.
+ *
+ * `structSize` must be `sizeof(ArbiterResolverStatistics)` as compiled by the
+ * caller. At most that many bytes are written, so a caller built against an
+ * older version of this header (with fewer fields) can safely use a newer
+ * version of the library.
+ *
+ * Returns whether any statistics were available. If false, the resolver has
+ * not finished any work yet, and `statistics` is left unmodified.
+ */
+bool ArbiterResolverCopyStatistics (const ArbiterResolver *resolver, ArbiterResolverStatistics *statistics, size_t structSize);
+
 #ifdef __cplusplus
 }
 #endif
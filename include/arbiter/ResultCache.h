@@ -0,0 +1,72 @@
+#ifndef ARBITER_RESULT_CACHE_H
+#define ARBITER_RESULT_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <arbiter/Lockfile.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// forward declarations
+struct ArbiterResolver;
+
+/**
+ * A cache of resolved dependency graphs, keyed by a fingerprint of everything
+ * which determines the result of a resolution: the dependencies to resolve,
+ * the initial graph, and a registry epoch supplied by the caller.
+ *
+ * The registry epoch must change whenever the behaviors of a resolver could
+ * return something different (e.g., when a new version of any project is
+ * published), or stale graphs will be returned from the cache.
+ *
+ * A cache may be shared by any number of resolvers, on any threads. Copies of
+ * a cache made with ArbiterCreateCopy() share the same entries.
+ */
+typedef struct ArbiterResultCache ArbiterResultCache;
+
+/**
+ * Creates a cache which keeps up to `capacity` graphs in memory, discarding
+ * the least recently used graph when full.
+ *
+ * If `directory` is not NULL, graphs are also written there as lockfiles, and
+ * graphs missing from memory are looked for there before resolving. Such
+ * graphs must be serializable into a lockfile (see
+ * ArbiterResolvedDependencyGraphWriteLockfile()), and are read back using
+ * `readers`. Nothing is ever removed from the directory.
+ *
+ * Returns the cache, which must be freed with ArbiterFree(), or NULL if
+ * `directory` does not exist. If NULL is returned and `error` is not NULL, it
+ * may be set to a string describing the error, which must be freed with
+ * free().
+ */
+ArbiterResultCache *ArbiterCreateResultCache (size_t capacity, const char *directory, ArbiterLockfileValueReaders readers, char **error);
+
+/**
+ * Returns the number of graphs currently held in memory by the cache.
+ */
+size_t ArbiterResultCacheCount (const ArbiterResultCache *cache);
+
+/**
+ * Makes subsequent resolutions by `resolver` consult `cache` before doing any
+ * work, and store their results in it. The resolver keeps its own reference
+ * to the cache.
+ *
+ * `registryEpoch` is an arbitrary token of `epochLength` bytes identifying the
+ * state of the registry that the resolver's behaviors read from.
+ *
+ * `cache` may be NULL to stop using a cache, which is the default.
+ *
+ * Resolutions whose dependencies or initial graph cannot be serialized into
+ * a lockfile (e.g., because they contain custom requirements) never use the
+ * cache.
+ */
+void ArbiterResolverSetResultCache (struct ArbiterResolver *resolver, const ArbiterResultCache *cache, const void *registryEpoch, size_t epochLength);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
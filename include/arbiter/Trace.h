@@ -0,0 +1,145 @@
+#ifndef ARBITER_TRACE_H
+#define ARBITER_TRACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <arbiter/Value.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// forward declarations
+struct ArbiterProjectIdentifier;
+struct ArbiterResolver;
+
+/**
+ * The kinds of work which are traced during dependency resolution.
+ */
+typedef enum
+{
+  /**
+   * One level of resolution, where the versions of a group of sibling
+   * dependencies are permuted together. Levels are nested for each level of
+   * transitive dependencies.
+   */
+  ArbiterTraceEventKindResolveLevel,
+
+  /**
+   * One combination of versions being tried within a level.
+   */
+  ArbiterTraceEventKindPermutation,
+
+  /**
+   * An invocation of the `createDependencyList` behavior.
+   */
+  ArbiterTraceEventKindFetchDependencyList,
+
+  /**
+   * An invocation of the `createAvailableVersionsList` behavior.
+   */
+  ArbiterTraceEventKindFetchAvailableVersions,
+
+  /**
+   * A combination of versions which failed, described by the event's
+   * `message`.
+   */
+  ArbiterTraceEventKindConflict,
+} ArbiterTraceEventKind;
+
+typedef enum
+{
+  /**
+   * The beginning of a span of work, which will be followed by a matching
+   * ArbiterTraceEventPhaseEnd event of the same kind.
+   */
+  ArbiterTraceEventPhaseBegin,
+
+  /**
+   * The end of the most recently begun span of work.
+   */
+  ArbiterTraceEventPhaseEnd,
+
+  /**
+   * Something which happened at a single point in time.
+   */
+  ArbiterTraceEventPhaseInstant,
+} ArbiterTraceEventPhase;
+
+/**
+ * Describes one traced event.
+ */
+typedef struct
+{
+  ArbiterTraceEventKind kind;
+  ArbiterTraceEventPhase phase;
+
+  /**
+   * A short, human-readable name for `kind`.
+   */
+  const char *name;
+
+  /**
+   * The time at which the event occurred, in microseconds since tracing was
+   * enabled.
+   */
+  double timestampMicroseconds;
+
+  /**
+   * The level of resolution at which the event occurred, where 1 is the level
+   * containing the dependencies passed to ArbiterCreateResolver(), or 0 if the
+   * event occurred outside of any level.
+   */
+  size_t depth;
+
+  /**
+   * The project the event concerns, or NULL if it does not concern just one.
+   */
+  const struct ArbiterProjectIdentifier *project;
+
+  /**
+   * A description of the event, or NULL if there is none.
+   */
+  const char *message;
+} ArbiterTraceEvent;
+
+/**
+ * Receives traced events, along with the context data provided when tracing
+ * was enabled.
+ *
+ * The event, and everything it points to, is only guaranteed to remain valid
+ * for the duration of the call.
+ */
+typedef void (*ArbiterTraceFunction)(const ArbiterTraceEvent *event, const void *context);
+
+/**
+ * Enables tracing of subsequent resolutions, passing each event to `function`
+ * as soon as it occurs. Any previous tracing on the resolver is stopped.
+ *
+ * `function` may be NULL to disable tracing, which is the default. While
+ * disabled, tracing costs no more than one branch for each event which would
+ * have been emitted.
+ */
+void ArbiterResolverSetTraceFunction (struct ArbiterResolver *resolver, ArbiterTraceFunction function, ArbiterUserContext context);
+
+/**
+ * Enables tracing of subsequent resolutions, writing events to the file at
+ * `path` in the Chrome trace event (JSON) format, which can be viewed with
+ * `about:tracing` or Perfetto. Any existing file at `path` is replaced, and any
+ * previous tracing on the resolver is stopped.
+ *
+ * The file is flushed after each resolution, and completed when tracing is
+ * stopped or the resolver is freed.
+ *
+ * Returns whether the file could be opened. If false is returned and `error` is
+ * not NULL, it may be set to a string describing the error, which the caller is
+ * responsible for freeing.
+ */
+bool ArbiterResolverSetTraceFile (struct ArbiterResolver *resolver, const char *path, char **error);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
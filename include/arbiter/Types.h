@@ -7,6 +7,31 @@ extern "C" {
 
 #include <stddef.h>
 
+/**
+ * Thread safety
+ *
+ * Unless documented otherwise, Arbiter objects follow the same rules as the
+ * standard library's containers:
+ *
+ *  - Any number of threads may call functions which take a const pointer to
+ *    the same object (e.g., copying, comparing, describing, or querying it)
+ *    at once, without any synchronization. Values which Arbiter computes and
+ *    caches on first use are published atomically and never replaced, so
+ *    pointers into them remain valid until the object is modified or freed.
+ *  - A function which takes a non-const pointer to an object must not run
+ *    at the same time as any other function using that object.
+ *  - Different objects may always be used from different threads at once,
+ *    even if one was copied from the other.
+ *
+ * ArbiterResolvers are mutable for the whole of a resolution, so each must
+ * only be used from one thread at a time. Objects whose documentation says
+ * they may be shared between threads (like ArbiterResultCache and
+ * ArbiterResolvedDependencyScheduler) are synchronized internally.
+ *
+ * Arbiter may invoke user-provided callbacks, like those of an
+ * ArbiterUserValue, from whichever thread is using the object that owns them.
+ */
+
 /**
  * Frees an Arbiter object.
  *
@@ -14,6 +14,17 @@ extern "C" {
  *
  * For example, ArbiterProjectIdentifiers are defined by providing a user value
  * type.
+ *
+ * If the Arbiter objects holding a value are used from several threads, the
+ * callbacks below may be invoked from all of them at once, so they must be
+ * safe to call concurrently on the same data object. Arbiter shares values
+ * between copies with atomic reference counting, so `destructor` is invoked
+ * exactly once, after the last copy is freed, on whichever thread freed it.
+ *
+ * Fields may be added to this structure in later versions of Arbiter, and an
+ * unset field is read as NULL. Always zero-initialize it (for example, with
+ * `ArbiterUserValue value = { 0 };`) before assigning fields individually,
+ * and recompile when upgrading Arbiter.
  */
 typedef struct
 {
@@ -44,6 +55,10 @@ typedef struct
    * Generates a hash of the data object. The hash does not need to be
    * cryptographically secure.
    *
+   * Objects which are equal must have the same hash. The hash is computed once,
+   * when the ArbiterUserValue is passed to Arbiter, so the data object must not
+   * be mutated afterward in a way that affects it.
+   *
    * This must not be NULL.
    */
   size_t (*hash)(const void *first);
@@ -62,6 +77,16 @@ typedef struct
    * This may be NULL.
    */
   void (*destructor)(void *data);
+
+  /**
+   * Serializes the data object into a dynamically allocated buffer, which must
+   * support being destroyed with free(), and sets `length` to its size in
+   * bytes.
+   *
+   * This may be NULL, in which case the value cannot be written into
+   * a lockfile.
+   */
+  void *(*createSerialization)(const void *data, size_t *length);
 } ArbiterUserValue;
 
 /**
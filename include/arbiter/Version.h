@@ -30,6 +30,30 @@ ArbiterSemanticVersion *ArbiterCreateSemanticVersion (unsigned major, unsigned m
  */
 ArbiterSemanticVersion *ArbiterCreateSemanticVersionFromString (const char *string);
 
+/**
+ * Attempts to parse the first `length` characters of `buffer` into a semantic
+ * version. The buffer does not need to be NUL-terminated.
+ *
+ * Returns NULL if a parse failure occurs. In that case, if `error` is not
+ * NULL, it will be set to a string describing the problem and where it
+ * occurred, which the caller is responsible for freeing.
+ *
+ * The returned version must be freed with ArbiterFree().
+ */
+ArbiterSemanticVersion *ArbiterCreateSemanticVersionFromBuffer (const char *buffer, size_t length, char **error);
+
+/**
+ * Attempts to parse each of the `count` NUL-terminated strings in `strings`
+ * into a semantic version, storing the result for `strings[i]` into
+ * `versions[i]`. Entries which fail to parse are set to NULL.
+ *
+ * `versions` must have room for `count` elements.
+ *
+ * Returns the number of strings which were parsed successfully. Each non-NULL
+ * version must be freed with ArbiterFree().
+ */
+size_t ArbiterCreateSemanticVersionsFromStrings (const char * const *strings, size_t count, ArbiterSemanticVersion **versions);
+
 /**
  * Returns the major version number (X.y.z) from a semantic version.
  */
@@ -95,6 +119,19 @@ typedef struct ArbiterSelectedVersion ArbiterSelectedVersion;
  */
 ArbiterSelectedVersion *ArbiterCreateSelectedVersion (const ArbiterSemanticVersion *semanticVersion, ArbiterUserValue metadata);
 
+/**
+ * Creates a selected version whose metadata is a string of `length` bytes,
+ * which will be copied.
+ *
+ * String metadata is compared by Arbiter itself, without invoking any
+ * callbacks, and ArbiterSelectedVersionMetadata() will return it as
+ * a NUL-terminated `const char *`. It must not be compared against metadata
+ * created from an ArbiterUserValue.
+ *
+ * The returned version must be freed with ArbiterFree().
+ */
+ArbiterSelectedVersion *ArbiterCreateSelectedVersionWithStringMetadata (const ArbiterSemanticVersion *semanticVersion, const char *metadata, size_t length);
+
 /**
  * Returns the semantic version which corresponds to the given selected version,
  * or NULL if there is no semantic version component.
@@ -127,6 +164,11 @@ typedef struct ArbiterSelectedVersionList ArbiterSelectedVersionList;
  */
 ArbiterSelectedVersionList *ArbiterCreateSelectedVersionList (const ArbiterSelectedVersion * const *versions, size_t count);
 
+/**
+ * Returns the number of versions in the given list.
+ */
+size_t ArbiterSelectedVersionListCount (const ArbiterSelectedVersionList *versionList);
+
 #ifdef __cplusplus
 }
 #endif
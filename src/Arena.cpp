@@ -0,0 +1,62 @@
+#include "Arena.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+
+using namespace Arbiter;
+
+void *Arena::allocate (size_t size, size_t alignment)
+{
+  assert(alignment && (alignment & (alignment - 1)) == 0);
+
+  while (_current < _blocks.size()) {
+    Block &block = _blocks[_current];
+
+    size_t offset = fit(block, _offset, size, alignment);
+    if (offset < block._size) {
+      _offset = offset + size;
+      return block._data.get() + offset;
+    }
+
+    // Skip over any blocks which were kept from earlier, but are too small for
+    // this allocation.
+    ++_current;
+    _offset = 0;
+  }
+
+  // Leave room to align the allocation, in case `alignment` is greater than
+  // the alignment of new[].
+  size_t blockSize = std::max(_blockSize, size + alignment);
+  _blocks.emplace_back(Block{ std::make_unique<char[]>(blockSize), blockSize });
+
+  Block &block = _blocks.back();
+  size_t offset = fit(block, 0, size, alignment);
+  assert(offset < block._size);
+
+  _current = _blocks.size() - 1;
+  _offset = offset + size;
+  return block._data.get() + offset;
+}
+
+size_t Arena::capacity () const noexcept
+{
+  size_t capacity = 0;
+  for (const Block &block : _blocks) {
+    capacity += block._size;
+  }
+
+  return capacity;
+}
+
+size_t Arena::fit (const Block &block, size_t offset, size_t size, size_t alignment) noexcept
+{
+  auto address = reinterpret_cast<uintptr_t>(block._data.get()) + offset;
+  size_t padding = (alignment - address % alignment) % alignment;
+
+  if (offset + padding + size > block._size || (size == 0 && offset + padding >= block._size)) {
+    return block._size;
+  }
+
+  return offset + padding;
+}
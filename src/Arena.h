@@ -0,0 +1,175 @@
+#pragma once
+
+#ifndef __cplusplus
+#error "This file must be compiled as C++."
+#endif
+
+#include "Memory.h"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace Arbiter {
+
+/**
+ * A monotonic allocator, which hands out memory from large blocks and frees it
+ * in bulk.
+ *
+ * Memory is released by rewinding the arena to an earlier mark. Every object
+ * allocated since the mark must have been destroyed by then. Blocks are kept
+ * after rewinding, so that they can be reused by later allocations.
+ *
+ * Arenas are not thread-safe.
+ */
+class Arena final
+{
+  public:
+    /**
+     * A position in the arena which can be rewound to.
+     */
+    struct Mark final
+    {
+      public:
+        size_t _block;
+        size_t _offset;
+    };
+
+    /**
+     * Creates an empty arena, which will allocate memory from the system in
+     * blocks of at least `blockSize` bytes.
+     */
+    explicit Arena (size_t blockSize = 64 * 1024) noexcept
+      : _blockSize(blockSize)
+    {}
+
+    Arena (const Arena &) = delete;
+    Arena &operator= (const Arena &) = delete;
+
+    /**
+     * Allocates `size` bytes aligned to `alignment`, which must be a power of
+     * two.
+     */
+    void *allocate (size_t size, size_t alignment);
+
+    /**
+     * Returns the current position of the arena.
+     */
+    Mark mark () const noexcept
+    {
+      return Mark{ _current, _offset };
+    }
+
+    /**
+     * Releases everything allocated since `mark` was created.
+     */
+    void rewind (Mark mark) noexcept
+    {
+      _current = mark._block;
+      _offset = mark._offset;
+    }
+
+    /**
+     * Releases everything allocated from the arena.
+     */
+    void reset () noexcept
+    {
+      rewind(Mark{ 0, 0 });
+    }
+
+    /**
+     * The total size of the blocks owned by the arena, whether or not they are
+     * currently in use.
+     */
+    size_t capacity () const noexcept;
+
+  private:
+    struct Block final
+    {
+      public:
+        std::unique_ptr<char[]> _data;
+        size_t _size;
+    };
+
+    size_t _blockSize;
+    std::vector<Block> _blocks;
+
+    // The block currently being allocated from, and the offset of the next
+    // free byte within it.
+    size_t _current = 0;
+    size_t _offset = 0;
+
+    /**
+     * Returns the offset at which an allocation would fit in the given block,
+     * or the block's size if it would not.
+     */
+    static size_t fit (const Block &block, size_t offset, size_t size, size_t alignment) noexcept;
+};
+
+/**
+ * A standard allocator which allocates from an Arena, for use with standard
+ * containers.
+ *
+ * Deallocation does nothing; memory is only released when the arena is
+ * rewound. If a MemoryCounter is provided, it counts the bytes allocated by
+ * the allocator which have not yet been deallocated.
+ *
+ * This is not final, since standard containers may derive from their
+ * allocator.
+ */
+template<typename T>
+class ArenaAllocator
+{
+  public:
+    using value_type = T;
+
+    explicit ArenaAllocator (Arena &arena, MemoryCounter *counter = nullptr) noexcept
+      : _arena(&arena)
+      , _counter(counter)
+    {}
+
+    template<typename U>
+    ArenaAllocator (const ArenaAllocator<U> &other) noexcept
+      : _arena(other._arena)
+      , _counter(other._counter)
+    {}
+
+    T *allocate (size_t count)
+    {
+      T *ptr = static_cast<T *>(_arena->allocate(count * sizeof(T), alignof(T)));
+
+      if (_counter) {
+        _counter->allocated(count * sizeof(T));
+      }
+
+      return ptr;
+    }
+
+    void deallocate (T *, size_t count) noexcept
+    {
+      if (_counter) {
+        _counter->deallocated(count * sizeof(T));
+      }
+    }
+
+    template<typename U>
+    bool operator== (const ArenaAllocator<U> &other) const noexcept
+    {
+      return _arena == other._arena && _counter == other._counter;
+    }
+
+    template<typename U>
+    bool operator!= (const ArenaAllocator<U> &other) const noexcept
+    {
+      return !(*this == other);
+    }
+
+  private:
+    template<typename U>
+    friend class ArenaAllocator;
+
+    Arena *_arena;
+    MemoryCounter *_counter;
+};
+
+} // namespace Arbiter
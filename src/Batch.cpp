@@ -0,0 +1,210 @@
+#include "Batch.h"
+
+#include "Exception.h"
+#include "ToString.h"
+#include "Value.h"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+using namespace Arbiter;
+
+namespace {
+
+SharedFetchCache &cacheForResolver (const ArbiterResolver *resolver)
+{
+  return *static_cast<SharedFetchCache *>(const_cast<void *>(resolver->_context.get()));
+}
+
+/**
+ * Sets `error` (if not null) to a copy of `message` which the resolver can
+ * free with free().
+ */
+void setError (char **error, const std::string &message)
+{
+  if (error) {
+    *error = strdup(message.c_str());
+  }
+}
+
+} // namespace
+
+SharedFetchCache::SharedFetchCache (ArbiterResolverBehaviors behaviors, std::shared_ptr<const void> context)
+  : _behaviors(std::move(behaviors))
+  , _innerResolver(std::make_unique<ArbiterResolver>(_behaviors, ArbiterResolvedDependencyGraph(), ArbiterDependencyList(), std::move(context)))
+{}
+
+std::unique_ptr<ArbiterResolver> SharedFetchCache::createResolver (ArbiterResolvedDependencyGraph initialGraph, ArbiterDependencyList dependenciesToResolve)
+{
+  ArbiterResolverBehaviors behaviors;
+  behaviors.createDependencyList = &createDependencyList;
+  behaviors.createAvailableVersionsList = &createAvailableVersionsList;
+  behaviors.createSelectedVersionForMetadata = _behaviors.createSelectedVersionForMetadata ? &createSelectedVersionForMetadata : nullptr;
+
+  std::shared_ptr<const void> context(std::shared_ptr<const void>(), this);
+  return std::make_unique<ArbiterResolver>(behaviors, std::move(initialGraph), std::move(dependenciesToResolve), std::move(context));
+}
+
+template<typename T, typename Fetch>
+SharedFetchCache::Outcome<T> SharedFetchCache::fetchOnce (std::unique_lock<std::mutex> &lock, SharedOutcome<T> &slot, std::atomic<uint64_t> &fetchCount, Fetch fetch)
+{
+  if (slot.valid()) {
+    SharedOutcome<T> outcome = slot;
+    lock.unlock();
+
+    _sharedFetches.fetch_add(1, std::memory_order_relaxed);
+    return outcome.get();
+  }
+
+  std::promise<Outcome<T>> promise;
+  slot = promise.get_future().share();
+  lock.unlock();
+
+  fetchCount.fetch_add(1, std::memory_order_relaxed);
+
+  char *error = nullptr;
+  std::unique_ptr<T> value(fetch(&error));
+
+  Outcome<T> outcome;
+  if (value) {
+    outcome._value = std::move(value);
+  } else {
+    outcome._error = error ? copyAcquireCString(error) : Exception::UserError().what();
+  }
+
+  promise.set_value(outcome);
+  return outcome;
+}
+
+ArbiterDependencyList *SharedFetchCache::createDependencyList (const ArbiterResolver *resolver, const ArbiterProjectIdentifier *project, const ArbiterSelectedVersion *selectedVersion, char **error)
+{
+  SharedFetchCache &cache = cacheForResolver(resolver);
+
+  std::unique_lock<std::mutex> lock(cache._mutex);
+  auto &slot = cache._dependencyLists[*project][*selectedVersion];
+
+  auto outcome = cache.fetchOnce(lock, slot, cache._dependencyListFetches, [&](char **fetchError) {
+    return cache._behaviors.createDependencyList(cache._innerResolver.get(), project, selectedVersion, fetchError);
+  });
+
+  if (!outcome._value) {
+    setError(error, outcome._error);
+    return nullptr;
+  }
+
+  return new ArbiterDependencyList(*outcome._value);
+}
+
+ArbiterSelectedVersionList *SharedFetchCache::createAvailableVersionsList (const ArbiterResolver *resolver, const ArbiterProjectIdentifier *project, char **error)
+{
+  SharedFetchCache &cache = cacheForResolver(resolver);
+
+  std::unique_lock<std::mutex> lock(cache._mutex);
+  auto &slot = cache._availableVersions[*project];
+
+  auto outcome = cache.fetchOnce(lock, slot, cache._availableVersionFetches, [&](char **fetchError) {
+    return cache._behaviors.createAvailableVersionsList(cache._innerResolver.get(), project, fetchError);
+  });
+
+  if (!outcome._value) {
+    setError(error, outcome._error);
+    return nullptr;
+  }
+
+  return new ArbiterSelectedVersionList(*outcome._value);
+}
+
+ArbiterSelectedVersion *SharedFetchCache::createSelectedVersionForMetadata (const ArbiterResolver *resolver, const ArbiterProjectIdentifier *project, const void *metadata)
+{
+  SharedFetchCache &cache = cacheForResolver(resolver);
+  return cache._behaviors.createSelectedVersionForMetadata(cache._innerResolver.get(), project, metadata);
+}
+
+std::vector<BatchResult> Arbiter::resolveBatch (ArbiterResolverBehaviors behaviors, std::shared_ptr<const void> context, const std::vector<BatchEntry> &entries, size_t threadCount, BatchStats *stats)
+{
+  Stats::Clock::time_point start = Stats::Clock::now();
+
+  SharedFetchCache cache(std::move(behaviors), std::move(context));
+  std::vector<BatchResult> results(entries.size());
+
+  // Entries are handed out in order, one at a time, so that a slow entry
+  // doesn't hold up a whole share of the batch.
+  std::atomic<size_t> nextEntry{0};
+
+  auto work = [&] {
+    for (size_t index; (index = nextEntry.fetch_add(1)) < entries.size();) {
+      const BatchEntry &entry = entries[index];
+      std::unique_ptr<ArbiterResolver> resolver = cache.createResolver(entry._initialGraph, entry._dependenciesToResolve);
+
+      try {
+        results[index]._graph = resolver->resolve();
+      } catch (const std::exception &ex) {
+        results[index]._error = ex.what();
+      }
+    }
+  };
+
+  if (threadCount == 0) {
+    threadCount = std::max(1U, std::thread::hardware_concurrency());
+  }
+
+  threadCount = std::min(threadCount, entries.size());
+
+  // The calling thread does its share of the work too.
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < threadCount; i++) {
+    threads.emplace_back(work);
+  }
+
+  work();
+
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+
+  if (stats) {
+    stats->_duration = Stats::Clock::now() - start;
+    stats->_availableVersionFetches = cache.availableVersionFetches();
+    stats->_dependencyListFetches = cache.dependencyListFetches();
+    stats->_sharedFetches = cache.sharedFetches();
+  }
+
+  return results;
+}
+
+size_t ArbiterResolveBatch (ArbiterResolverBehaviors behaviors, const ArbiterResolverBatchEntry *entries, size_t count, ArbiterUserContext context, size_t threadCount, ArbiterResolverBatchResult *results, ArbiterResolverBatchStatistics *statistics)
+{
+  std::vector<BatchEntry> batch;
+  batch.reserve(count);
+
+  for (size_t i = 0; i < count; i++) {
+    batch.push_back(BatchEntry{ *entries[i].dependenciesToResolve, (entries[i].initialGraph ? *entries[i].initialGraph : ArbiterResolvedDependencyGraph()) });
+  }
+
+  BatchStats stats;
+  std::vector<BatchResult> batchResults = resolveBatch(std::move(behaviors), shareUserContext(context), batch, threadCount, &stats);
+
+  size_t succeeded = 0;
+  for (size_t i = 0; i < count; i++) {
+    if (batchResults[i]._graph) {
+      results[i].graph = new ArbiterResolvedDependencyGraph(std::move(*batchResults[i]._graph));
+      results[i].error = nullptr;
+      ++succeeded;
+    } else {
+      results[i].graph = nullptr;
+      results[i].error = copyCString(batchResults[i]._error).release();
+    }
+  }
+
+  if (statistics) {
+    using Seconds = std::chrono::duration<double>;
+
+    statistics->durationSeconds = std::chrono::duration_cast<Seconds>(stats._duration).count();
+    statistics->availableVersionFetches = stats._availableVersionFetches;
+    statistics->dependencyListFetches = stats._dependencyListFetches;
+    statistics->sharedFetches = stats._sharedFetches;
+  }
+
+  return succeeded;
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#ifndef __cplusplus
+#error "This file must be compiled as C++."
+#endif
+
+#include <arbiter/Batch.h>
+
+#include "Dependency.h"
+#include "Graph.h"
+#include "Optional.h"
+#include "Resolver.h"
+#include "Stats.h"
+#include "Version.h"
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Arbiter {
+
+/**
+ * Wraps resolver behaviors so that each project's available versions, and
+ * each dependency list, are only fetched once no matter how many resolvers
+ * (on how many threads) ask for them.
+ *
+ * When several resolvers ask for the same thing at once, one of them invokes
+ * the behavior while the others wait for it to finish. Failures are shared in
+ * the same way as successes.
+ *
+ * All methods are thread-safe.
+ */
+class SharedFetchCache final
+{
+  public:
+    /**
+     * Shares fetches made with `behaviors`, which will receive a resolver with
+     * the given `context` from ArbiterResolverContext().
+     */
+    SharedFetchCache (ArbiterResolverBehaviors behaviors, std::shared_ptr<const void> context);
+
+    SharedFetchCache (const SharedFetchCache &) = delete;
+    SharedFetchCache &operator= (const SharedFetchCache &) = delete;
+
+    /**
+     * Creates a resolver whose behaviors go through this cache. The cache must
+     * outlive the resolver.
+     */
+    std::unique_ptr<ArbiterResolver> createResolver (ArbiterResolvedDependencyGraph initialGraph, ArbiterDependencyList dependenciesToResolve);
+
+    // The number of times the wrapped behaviors were actually invoked.
+    uint64_t availableVersionFetches () const noexcept
+    {
+      return _availableVersionFetches.load(std::memory_order_relaxed);
+    }
+
+    uint64_t dependencyListFetches () const noexcept
+    {
+      return _dependencyListFetches.load(std::memory_order_relaxed);
+    }
+
+    // The number of fetches which were answered by another resolver's fetch.
+    uint64_t sharedFetches () const noexcept
+    {
+      return _sharedFetches.load(std::memory_order_relaxed);
+    }
+
+  private:
+    /**
+     * The outcome of one fetch: a value, or an error message.
+     */
+    template<typename T>
+    struct Outcome final
+    {
+      public:
+        std::shared_ptr<const T> _value;
+        std::string _error;
+    };
+
+    template<typename T>
+    using SharedOutcome = std::shared_future<Outcome<T>>;
+
+    ArbiterResolverBehaviors _behaviors;
+
+    // Passed to the wrapped behaviors, so that they can retrieve their own
+    // context.
+    std::unique_ptr<ArbiterResolver> _innerResolver;
+
+    std::mutex _mutex;
+    std::unordered_map<ArbiterProjectIdentifier, SharedOutcome<ArbiterSelectedVersionList>> _availableVersions;
+    std::unordered_map<ArbiterProjectIdentifier, std::unordered_map<ArbiterSelectedVersion, SharedOutcome<ArbiterDependencyList>>> _dependencyLists;
+
+    std::atomic<uint64_t> _availableVersionFetches{0};
+    std::atomic<uint64_t> _dependencyListFetches{0};
+    std::atomic<uint64_t> _sharedFetches{0};
+
+    /**
+     * Returns the outcome stored in `slot`, if another fetch has claimed it,
+     * or else claims it, invokes `fetch` (which returns an owned pointer and
+     * may set an error), and stores the outcome.
+     *
+     * `slot` must be looked up while `lock` is held. The lock is released
+     * before waiting or fetching.
+     */
+    template<typename T, typename Fetch>
+    Outcome<T> fetchOnce (std::unique_lock<std::mutex> &lock, SharedOutcome<T> &slot, std::atomic<uint64_t> &fetchCount, Fetch fetch);
+
+    static ArbiterDependencyList *createDependencyList (const ArbiterResolver *resolver, const ArbiterProjectIdentifier *project, const ArbiterSelectedVersion *selectedVersion, char **error);
+    static ArbiterSelectedVersionList *createAvailableVersionsList (const ArbiterResolver *resolver, const ArbiterProjectIdentifier *project, char **error);
+    static ArbiterSelectedVersion *createSelectedVersionForMetadata (const ArbiterResolver *resolver, const ArbiterProjectIdentifier *project, const void *metadata);
+};
+
+/**
+ * One set of dependencies to resolve in a batch.
+ */
+struct BatchEntry final
+{
+  public:
+    ArbiterDependencyList _dependenciesToResolve;
+    ArbiterResolvedDependencyGraph _initialGraph;
+};
+
+/**
+ * The outcome of resolving one BatchEntry.
+ */
+struct BatchResult final
+{
+  public:
+    // The resolved graph, or None if resolution failed.
+    Optional<ArbiterResolvedDependencyGraph> _graph;
+
+    // Why resolution failed, if it did.
+    std::string _error;
+};
+
+/**
+ * Statistics about a whole batch.
+ */
+struct BatchStats final
+{
+  public:
+    Stats::Clock::duration _duration{0};
+    uint64_t _availableVersionFetches{0};
+    uint64_t _dependencyListFetches{0};
+    uint64_t _sharedFetches{0};
+};
+
+/**
+ * Resolves every entry on up to `threadCount` threads (or one per processor,
+ * if zero), sharing fetches between them through a SharedFetchCache.
+ *
+ * Returns a result for each entry, in the same order.
+ */
+std::vector<BatchResult> resolveBatch (ArbiterResolverBehaviors behaviors, std::shared_ptr<const void> context, const std::vector<BatchEntry> &entries, size_t threadCount, BatchStats *stats = nullptr);
+
+} // namespace Arbiter
@@ -0,0 +1,91 @@
+#include "CompactGraph.h"
+
+#include "Graph.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+using namespace Arbiter;
+
+CompactGraph::CompactGraph (const ArbiterResolvedDependencyGraph &graph)
+{
+  assert(graph.nodes().size() < std::numeric_limits<Index>::max());
+
+  using Node = ArbiterResolvedDependencyGraph::NodeMap::value_type;
+
+  std::vector<const Node *> sortedNodes;
+  sortedNodes.reserve(graph.nodes().size());
+
+  for (const Node &node : graph.nodes()) {
+    sortedNodes.emplace_back(&node);
+  }
+
+  std::sort(sortedNodes.begin(), sortedNodes.end(), [](const Node *lhs, const Node *rhs) {
+    return lhs->first < rhs->first;
+  });
+
+  _nodes.reserve(sortedNodes.size());
+  _requirements.reserve(sortedNodes.size());
+
+  for (const Node *node : sortedNodes) {
+    _nodes.emplace_back(node->first, node->second._version);
+    _requirements.emplace_back(node->second._requirement);
+  }
+
+  _dependencyOffsets.assign(_nodes.size() + 1, 0);
+  _dependentOffsets.assign(_nodes.size() + 1, 0);
+
+  // Count the edges in each direction, then convert the counts into offsets.
+  for (Index index = 0; index < _nodes.size(); index++) {
+    const auto it = graph.edges().find(project(index));
+    if (it == graph.edges().end()) {
+      continue;
+    }
+
+    _dependencyOffsets[index + 1] = Index(it->second.size());
+    for (const ArbiterProjectIdentifier &dependency : it->second) {
+      ++_dependentOffsets[*indexOf(dependency) + 1];
+    }
+  }
+
+  for (size_t index = 0; index < _nodes.size(); index++) {
+    _dependencyOffsets[index + 1] += _dependencyOffsets[index];
+    _dependentOffsets[index + 1] += _dependentOffsets[index];
+  }
+
+  _dependencies.resize(_dependencyOffsets.back());
+  _dependents.resize(_dependentOffsets.back());
+
+  // Visiting dependents in ascending order keeps each reverse edge list
+  // sorted, and std::set already keeps the forward edges sorted.
+  std::vector<Index> nextDependent(_dependentOffsets.begin(), _dependentOffsets.end() - 1);
+
+  for (Index index = 0; index < _nodes.size(); index++) {
+    const auto it = graph.edges().find(project(index));
+    if (it == graph.edges().end()) {
+      continue;
+    }
+
+    Index position = _dependencyOffsets[index];
+    for (const ArbiterProjectIdentifier &dependency : it->second) {
+      Index dependencyIndex = *indexOf(dependency);
+
+      _dependencies[position++] = dependencyIndex;
+      _dependents[nextDependent[dependencyIndex]++] = index;
+    }
+  }
+}
+
+Optional<CompactGraph::Index> CompactGraph::indexOf (const ArbiterProjectIdentifier &project) const
+{
+  auto it = std::lower_bound(_nodes.begin(), _nodes.end(), project, [](const ArbiterResolvedDependency &node, const ArbiterProjectIdentifier &project) {
+    return node._project < project;
+  });
+
+  if (it == _nodes.end() || project < it->_project) {
+    return None();
+  }
+
+  return makeOptional(Index(it - _nodes.begin()));
+}
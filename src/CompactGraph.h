@@ -0,0 +1,161 @@
+#pragma once
+
+#ifndef __cplusplus
+#error "This file must be compiled as C++."
+#endif
+
+#include "Dependency.h"
+#include "Optional.h"
+#include "Project.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+struct ArbiterResolvedDependencyGraph;
+
+namespace Arbiter {
+
+/**
+ * A frozen, read-optimized copy of an ArbiterResolvedDependencyGraph.
+ *
+ * Nodes are numbered densely in ascending order of their project identifiers,
+ * and stored contiguously. Edges in both directions are stored in compressed
+ * sparse row form: the neighbors of node `i` are the indexes in
+ * `[offsets[i], offsets[i + 1])`.
+ */
+class CompactGraph final
+{
+  public:
+    using Index = uint32_t;
+
+    /**
+     * A contiguous range of node indexes.
+     */
+    class Range final
+    {
+      public:
+        Range (const Index *begin, const Index *end) noexcept
+          : _begin(begin)
+          , _end(end)
+        {}
+
+        const Index *begin () const noexcept
+        {
+          return _begin;
+        }
+
+        const Index *end () const noexcept
+        {
+          return _end;
+        }
+
+        size_t size () const noexcept
+        {
+          return size_t(_end - _begin);
+        }
+
+      private:
+        const Index *_begin;
+        const Index *_end;
+    };
+
+    /**
+     * Builds the compact form of the given graph in one pass over its nodes and
+     * edges (plus sorting the nodes).
+     */
+    explicit CompactGraph (const ArbiterResolvedDependencyGraph &graph);
+
+    size_t size () const noexcept
+    {
+      return _nodes.size();
+    }
+
+    const ArbiterProjectIdentifier &project (Index index) const noexcept
+    {
+      return _nodes[index]._project;
+    }
+
+    /**
+     * The project and selected version of the node at `index`.
+     */
+    const ArbiterResolvedDependency &node (Index index) const noexcept
+    {
+      return _nodes[index];
+    }
+
+    const ArbiterRequirement &requirement (Index index) const noexcept
+    {
+      return *_requirements[index];
+    }
+
+    /**
+     * All nodes, in ascending order.
+     */
+    const ArbiterResolvedDependency *nodes () const noexcept
+    {
+      return _nodes.data();
+    }
+
+    /**
+     * The offsets of each node's dependencies in dependencyIndexes(), followed
+     * by the total number of edges.
+     */
+    const std::vector<Index> &dependencyOffsets () const noexcept
+    {
+      return _dependencyOffsets;
+    }
+
+    /**
+     * The dependencies of every node, concatenated.
+     */
+    const std::vector<Index> &dependencyIndexes () const noexcept
+    {
+      return _dependencies;
+    }
+
+    /**
+     * Returns the index of the given project, or None if it is not in the
+     * graph.
+     *
+     * This is a binary search.
+     */
+    Optional<Index> indexOf (const ArbiterProjectIdentifier &project) const;
+
+    /**
+     * The nodes which `index` depends upon, in ascending order.
+     */
+    Range dependencies (Index index) const noexcept
+    {
+      return range(_dependencyOffsets, _dependencies, index);
+    }
+
+    /**
+     * The nodes which depend upon `index`, in ascending order.
+     */
+    Range dependents (Index index) const noexcept
+    {
+      return range(_dependentOffsets, _dependents, index);
+    }
+
+  private:
+    std::vector<ArbiterResolvedDependency> _nodes;
+
+    // Shared with the graph's nodes, which replace rather than modify their
+    // requirements.
+    std::vector<std::shared_ptr<const ArbiterRequirement>> _requirements;
+
+    std::vector<Index> _dependencyOffsets;
+    std::vector<Index> _dependencies;
+
+    std::vector<Index> _dependentOffsets;
+    std::vector<Index> _dependents;
+
+    static Range range (const std::vector<Index> &offsets, const std::vector<Index> &indexes, Index index) noexcept
+    {
+      return Range(indexes.data() + offsets[index], indexes.data() + offsets[index + 1]);
+    }
+};
+
+} // namespace Arbiter
@@ -34,6 +34,18 @@ ArbiterDependencyList *ArbiterCreateDependencyList (const ArbiterDependency * co
   return new ArbiterDependencyList(std::move(vec));
 }
 
+size_t ArbiterDependencyListCount (const ArbiterDependencyList *dependencyList)
+{
+  return dependencyList->_dependencies.size();
+}
+
+void ArbiterDependencyListGetAll (const ArbiterDependencyList *dependencyList, const ArbiterDependency **buffer)
+{
+  for (const ArbiterDependency &dependency : dependencyList->_dependencies) {
+    *(buffer++) = &dependency;
+  }
+}
+
 ArbiterResolvedDependency *ArbiterCreateResolvedDependency (const ArbiterProjectIdentifier *project, const ArbiterSelectedVersion *version)
 {
   return new ArbiterResolvedDependency(*project, *version);
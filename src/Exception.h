@@ -64,6 +64,42 @@ struct UnsatisfiableConstraints final : public Base
     {}
 };
 
+/**
+ * Exception type indicating that a dependency graph contains a cycle, and so
+ * cannot be installed in any order.
+ */
+struct DependencyCycle final : public Base
+{
+  public:
+    explicit DependencyCycle (const std::string &string)
+      : Base(string)
+    {}
+};
+
+/**
+ * Exception type indicating that a value could not be written to or read from
+ * a lockfile.
+ */
+struct SerializationError final : public Base
+{
+  public:
+    explicit SerializationError (const std::string &string)
+      : Base(string)
+    {}
+};
+
+/**
+ * Exception type indicating that dependency resolution was cancelled before it
+ * could finish.
+ */
+struct Cancelled final : public Base
+{
+  public:
+    explicit Cancelled (const std::string &string)
+      : Base(string)
+    {}
+};
+
 }
 } // namespace Arbiter
 
@@ -1,7 +1,10 @@
 #include "Graph.h"
 
 #include <algorithm>
+#include <memory>
+#include <stdexcept>
 
+#include "CompactGraph.h"
 #include "Exception.h"
 
 using namespace Arbiter;
@@ -63,6 +66,36 @@ void ArbiterResolvedDependencyGraphCopyAll (const ArbiterResolvedDependencyGraph
   }
 }
 
+void ArbiterResolvedDependencyGraphGetAll (const ArbiterResolvedDependencyGraph *graph, const ArbiterResolvedDependency **nodes, const ArbiterRequirement **requirements)
+{
+  // The compact graph is cached by `graph`, so these pointers remain valid
+  // until it is modified or freed.
+  auto compact = graph->compact();
+
+  for (CompactGraph::Index index = 0; index < compact->size(); index++) {
+    if (nodes) {
+      nodes[index] = &compact->node(index);
+    }
+
+    if (requirements) {
+      requirements[index] = &compact->requirement(index);
+    }
+  }
+}
+
+size_t ArbiterResolvedDependencyGraphCountEdges (const ArbiterResolvedDependencyGraph *graph)
+{
+  return graph->compact()->dependencyIndexes().size();
+}
+
+void ArbiterResolvedDependencyGraphGetAllEdges (const ArbiterResolvedDependencyGraph *graph, size_t *offsets, size_t *dependencies)
+{
+  auto compact = graph->compact();
+
+  std::copy(compact->dependencyOffsets().begin(), compact->dependencyOffsets().end(), offsets);
+  std::copy(compact->dependencyIndexes().begin(), compact->dependencyIndexes().end(), dependencies);
+}
+
 const ArbiterSelectedVersion *ArbiterResolvedDependencyGraphProjectVersion (const ArbiterResolvedDependencyGraph *graph, const ArbiterProjectIdentifier *project)
 {
   auto it = graph->nodes().find(*project);
@@ -107,7 +140,20 @@ void ArbiterResolvedDependencyGraphGetAllDependencies (const ArbiterResolvedDepe
 
 ArbiterResolvedDependencyInstaller *ArbiterResolvedDependencyInstallerCreate (const ArbiterResolvedDependencyGraph *graph)
 {
-  return new ArbiterResolvedDependencyInstaller(graph->createInstaller());
+  return ArbiterResolvedDependencyInstallerCreateWithError(graph, nullptr);
+}
+
+ArbiterResolvedDependencyInstaller *ArbiterResolvedDependencyInstallerCreateWithError (const ArbiterResolvedDependencyGraph *graph, char **error)
+{
+  try {
+    return new ArbiterResolvedDependencyInstaller(graph->createInstaller());
+  } catch (const Exception::Base &ex) {
+    if (error) {
+      *error = copyCString(ex.what()).release();
+    }
+
+    return nullptr;
+  }
 }
 
 size_t ArbiterResolvedDependencyInstallerPhaseCount (const ArbiterResolvedDependencyInstaller *installer)
@@ -150,10 +196,46 @@ void ArbiterResolvedDependencyGraph::NodeValue::setRequirement (std::unique_ptr<
   _requirement = std::move(requirement);
 }
 
+ArbiterResolvedDependencyGraph::ArbiterResolvedDependencyGraph (const ArbiterResolvedDependencyGraph &other)
+  : _edges(other._edges)
+  , _nodes(other._nodes)
+  , _compact(std::atomic_load(&other._compact))
+{}
+
+ArbiterResolvedDependencyGraph::ArbiterResolvedDependencyGraph (ArbiterResolvedDependencyGraph &&other) noexcept
+  : _edges(std::move(other._edges))
+  , _nodes(std::move(other._nodes))
+  , _compact(std::atomic_exchange(&other._compact, std::shared_ptr<const CompactGraph>()))
+{}
+
+ArbiterResolvedDependencyGraph &ArbiterResolvedDependencyGraph::operator= (const ArbiterResolvedDependencyGraph &other)
+{
+  if (this != &other) {
+    _edges = other._edges;
+    _nodes = other._nodes;
+    std::atomic_store(&_compact, std::atomic_load(&other._compact));
+  }
+
+  return *this;
+}
+
+ArbiterResolvedDependencyGraph &ArbiterResolvedDependencyGraph::operator= (ArbiterResolvedDependencyGraph &&other) noexcept
+{
+  if (this != &other) {
+    _edges = std::move(other._edges);
+    _nodes = std::move(other._nodes);
+    std::atomic_store(&_compact, std::atomic_exchange(&other._compact, std::shared_ptr<const CompactGraph>()));
+  }
+
+  return *this;
+}
+
 void ArbiterResolvedDependencyGraph::addNode (ArbiterResolvedDependency node, const ArbiterRequirement &initialRequirement) noexcept(false)
 {
   assert(initialRequirement.satisfiedBy(node._version));
 
+  std::atomic_store(&_compact, std::shared_ptr<const CompactGraph>());
+
   const NodeKey &key = node._project;
 
   const auto it = _nodes.find(key);
@@ -161,54 +243,104 @@ void ArbiterResolvedDependencyGraph::addNode (ArbiterResolvedDependency node, co
     NodeValue &value = it->second;
 
     // We need to unify our input with what was already there.
-    if (auto newRequirement = initialRequirement.intersect(value.requirement())) {
-      if (!newRequirement->satisfiedBy(value._version)) {
-        throw Exception::UnsatisfiableConstraints("Cannot satisfy " + toString(*newRequirement) + " with " + toString(value._version));
-      }
-
-      value.setRequirement(std::move(newRequirement));
-    } else {
-      throw Exception::MutuallyExclusiveConstraints(toString(value.requirement()) + " and " + toString(initialRequirement) + " are mutually exclusive");
-    }
+    value.setRequirement(unifyRequirements(value._version, value.requirement(), initialRequirement));
   } else {
     _nodes.emplace(std::make_pair(key, NodeValue(node._version, initialRequirement)));
   }
 }
 
+std::unique_ptr<ArbiterRequirement> ArbiterResolvedDependencyGraph::unifyRequirements (const ArbiterSelectedVersion &version, const ArbiterRequirement &existingRequirement, const ArbiterRequirement &newRequirement) noexcept(false)
+{
+  auto requirement = newRequirement.intersect(existingRequirement);
+  if (!requirement) {
+    throw Exception::MutuallyExclusiveConstraints(toString(existingRequirement) + " and " + toString(newRequirement) + " are mutually exclusive");
+  }
+
+  if (!requirement->satisfiedBy(version)) {
+    throw Exception::UnsatisfiableConstraints("Cannot satisfy " + toString(*requirement) + " with " + toString(version));
+  }
+
+  return requirement;
+}
+
 void ArbiterResolvedDependencyGraph::addEdge (const ArbiterProjectIdentifier &dependent, ArbiterProjectIdentifier dependency)
 {
   assert(_nodes.find(dependent) != _nodes.end());
   assert(_nodes.find(dependency) != _nodes.end());
 
+  std::atomic_store(&_compact, std::shared_ptr<const CompactGraph>());
+
   _edges[dependent].emplace(std::move(dependency));
 }
 
 ArbiterResolvedDependencyGraph ArbiterResolvedDependencyGraph::graphWithNewRoots (const std::vector<NodeKey> &roots) const
 {
-  ArbiterResolvedDependencyGraph graph;
+  auto compact = this->compact();
+
+  std::vector<bool> visited(compact->size(), false);
+  std::vector<CompactGraph::Index> stack;
 
   for (const NodeKey &root : roots) {
-    walkNodeAndCopyInto(graph, root, None());
+    auto index = compact->indexOf(root);
+    if (!index) {
+      throw std::out_of_range("Root " + toString(root) + " does not exist in the graph");
+    }
+
+    if (!visited[*index]) {
+      visited[*index] = true;
+      stack.emplace_back(*index);
+    }
+  }
+
+  while (!stack.empty()) {
+    CompactGraph::Index index = stack.back();
+    stack.pop_back();
+
+    for (CompactGraph::Index dependency : compact->dependencies(index)) {
+      if (!visited[dependency]) {
+        visited[dependency] = true;
+        stack.emplace_back(dependency);
+      }
+    }
+  }
+
+  ArbiterResolvedDependencyGraph graph;
+
+  for (CompactGraph::Index index = 0; index < compact->size(); index++) {
+    if (visited[index]) {
+      const NodeKey &key = compact->project(index);
+      graph._nodes.emplace(std::make_pair(key, _nodes.at(key)));
+    }
+  }
+
+  // Every dependency of a visited node was visited too.
+  for (CompactGraph::Index index = 0; index < compact->size(); index++) {
+    if (visited[index]) {
+      const auto it = _edges.find(compact->project(index));
+      if (it != _edges.end()) {
+        graph._edges.emplace(*it);
+      }
+    }
   }
 
   return graph;
 }
 
-void ArbiterResolvedDependencyGraph::walkNodeAndCopyInto (ArbiterResolvedDependencyGraph &newGraph, const NodeKey &key, const Arbiter::Optional<NodeKey> &dependent) const
+std::shared_ptr<const CompactGraph> ArbiterResolvedDependencyGraph::compact () const
 {
-  newGraph.addNode(resolveNode(key), _nodes.at(key).requirement());
-  if (dependent) {
-    newGraph.addEdge(*dependent, key);
-  }
-
-  const auto it = _edges.find(key);
-  if (it == _edges.end()) {
-    return;
+  auto compact = std::atomic_load(&_compact);
+  if (compact) {
+    return compact;
   }
 
-  const auto &dependencies = it->second;
-  for (const NodeKey &dependency : dependencies) {
-    walkNodeAndCopyInto(newGraph, dependency, makeOptional(key));
+  // Only the first graph to be published is ever handed out. Replacing it
+  // would free a graph that other callers may still hold pointers into (like
+  // those returned by ArbiterResolvedDependencyGraphGetAll()).
+  auto candidate = std::make_shared<const CompactGraph>(*this);
+  if (std::atomic_compare_exchange_strong(&_compact, &compact, candidate)) {
+    return candidate;
+  } else {
+    return compact;
   }
 }
 
@@ -222,74 +354,109 @@ ArbiterResolvedDependency ArbiterResolvedDependencyGraph::resolveNode (const Nod
   return resolveNode(std::make_pair(key, _nodes.at(key)));
 }
 
-ArbiterResolvedDependencyInstaller ArbiterResolvedDependencyGraph::createInstaller () const
+ArbiterResolvedDependencyInstaller ArbiterResolvedDependencyGraph::createInstaller () const noexcept(false)
 {
   ArbiterResolvedDependencyInstaller installer;
   if (_nodes.empty()) {
     return installer;
   }
 
-  // Contains edges which still need to be added to the resolved graph.
-  EdgeMap remainingEdges;
-  remainingEdges.reserve(_edges.size());
+  auto compact = this->compact();
 
-  // Contains dependencies without any dependencies themselves.
-  ArbiterResolvedDependencyInstaller::PhaseSet leaves;
+  // For each node, the number of its dependencies which have not been placed
+  // into a phase yet.
+  std::vector<size_t> remainingDependencies(compact->size(), 0);
+  std::vector<CompactGraph::Index> thisLayer;
 
-  for (const auto &pair : _nodes) {
-    const NodeKey &key = pair.first;
-    const auto it = _edges.find(key);
-
-    if (it == _edges.end()) {
-      leaves.emplace(resolveNode(key));
-    } else {
-      const auto &dependencySet = it->second;
+  for (CompactGraph::Index index = 0; index < compact->size(); index++) {
+    auto dependencies = compact->dependencies(index);
+    remainingDependencies[index] = dependencies.size();
 
-      remainingEdges[key] = dependencySet;
+    if (dependencies.size() == 0) {
+      thisLayer.emplace_back(index);
+      continue;
+    }
 
-      std::vector<NodeKey> dependencyList(dependencySet.begin(), dependencySet.end());
-      std::sort(dependencyList.begin(), dependencyList.end());
+    std::vector<NodeKey> dependencyList;
+    dependencyList.reserve(dependencies.size());
 
-      installer._edges.emplace(std::make_pair(key, std::move(dependencyList)));
+    // These are already sorted.
+    for (CompactGraph::Index dependency : dependencies) {
+      dependencyList.emplace_back(compact->project(dependency));
     }
+
+    installer._edges.emplace(std::make_pair(compact->project(index), std::move(dependencyList)));
   }
 
   assert(installer._edges.size() == _edges.size());
-  installer._phases.emplace_back(std::move(leaves));
 
-  while (!remainingEdges.empty()) {
-    ArbiterResolvedDependencyInstaller::PhaseSet thisPhase;
+  // Kahn's algorithm, one layer at a time: each phase contains exactly the
+  // nodes whose last dependency was placed in the previous phase.
+  size_t placedCount = 0;
 
-    for (auto edgeIt = remainingEdges.begin(); edgeIt != remainingEdges.end(); ) {
-      const NodeKey &dependent = edgeIt->first;
-      auto &dependencies = edgeIt->second;
+  while (!thisLayer.empty()) {
+    ArbiterResolvedDependencyInstaller::PhaseSet thisPhase;
+    std::vector<CompactGraph::Index> nextLayer;
 
-      for (auto depIt = dependencies.begin(); depIt != dependencies.end(); ) {
-        const NodeKey &dependency = *depIt;
+    for (CompactGraph::Index index : thisLayer) {
+      thisPhase.emplace(compact->node(index));
 
-        // If this dependency is in the graph already, it can be removed
-        // from the list of remaining edges.
-        if (installer.contains(resolveNode(dependency))) {
-          depIt = dependencies.erase(depIt);
-        } else {
-          ++depIt;
+      for (CompactGraph::Index dependent : compact->dependents(index)) {
+        if (--remainingDependencies[dependent] == 0) {
+          nextLayer.emplace_back(dependent);
         }
       }
+    }
+
+    placedCount += thisLayer.size();
+    installer._phases.emplace_back(std::move(thisPhase));
+    thisLayer = std::move(nextLayer);
+  }
+
+  if (placedCount == compact->size()) {
+    return installer;
+  }
+
+  std::unordered_set<NodeKey> unplaced;
+  for (CompactGraph::Index index = 0; index < compact->size(); index++) {
+    if (remainingDependencies[index] != 0) {
+      unplaced.emplace(compact->project(index));
+    }
+  }
+
+  throwDependencyCycle(unplaced);
+}
 
-      // If all dependencies are now in the graph, we can add this node to
-      // the current phase we're building.
-      if (dependencies.empty()) {
-        thisPhase.emplace(resolveNode(dependent));
-        edgeIt = remainingEdges.erase(edgeIt);
-      } else {
-        ++edgeIt;
+void ArbiterResolvedDependencyGraph::throwDependencyCycle (const std::unordered_set<NodeKey> &unplaced) const noexcept(false)
+{
+  assert(!unplaced.empty());
+
+  // Every node which could not be placed has at least one dependency which
+  // could not be placed either, so following those must eventually revisit
+  // a node.
+  std::unordered_map<NodeKey, size_t> visitOrder;
+  std::vector<const NodeKey *> path;
+
+  const NodeKey *current = &*unplaced.begin();
+  while (visitOrder.find(*current) == visitOrder.end()) {
+    visitOrder.emplace(*current, path.size());
+    path.emplace_back(current);
+
+    for (const NodeKey &dependency : _edges.at(*current)) {
+      if (unplaced.find(dependency) != unplaced.end()) {
+        current = &dependency;
+        break;
       }
     }
+  }
 
-    installer._phases.emplace_back(std::move(thisPhase));
+  std::string description = "Dependency cycle detected: ";
+  for (size_t i = visitOrder.at(*current); i < path.size(); i++) {
+    description += toString(*path[i]) + " -> ";
   }
 
-  return installer;
+  description += toString(*current);
+  throw Exception::DependencyCycle(description);
 }
 
 std::unique_ptr<Arbiter::Base> ArbiterResolvedDependencyGraph::clone () const
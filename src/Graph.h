@@ -13,8 +13,15 @@
 #include <memory>
 #include <ostream>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+namespace Arbiter {
+
+class CompactGraph;
+
+} // namespace Arbiter
+
 struct ArbiterResolvedDependencyGraph final : public Arbiter::Base
 {
   public:
@@ -34,6 +41,7 @@ struct ArbiterResolvedDependencyGraph final : public Arbiter::Base
 
       private:
         friend struct ArbiterResolvedDependencyGraph;
+        friend class Arbiter::CompactGraph;
 
         std::shared_ptr<ArbiterRequirement> _requirement;
 
@@ -41,6 +49,19 @@ struct ArbiterResolvedDependencyGraph final : public Arbiter::Base
         void setRequirement (std::unique_ptr<ArbiterRequirement> requirement);
     };
 
+    ArbiterResolvedDependencyGraph () = default;
+
+    /**
+     * Copies a graph, sharing its compact form if it has been created. The
+     * source may be read concurrently by other threads, including through
+     * compact().
+     */
+    ArbiterResolvedDependencyGraph (const ArbiterResolvedDependencyGraph &other);
+    ArbiterResolvedDependencyGraph (ArbiterResolvedDependencyGraph &&other) noexcept;
+
+    ArbiterResolvedDependencyGraph &operator= (const ArbiterResolvedDependencyGraph &other);
+    ArbiterResolvedDependencyGraph &operator= (ArbiterResolvedDependencyGraph &&other) noexcept;
+
     using NodeKey = ArbiterProjectIdentifier;
     using NodeMap = std::unordered_map<NodeKey, NodeValue>;
     using EdgeMap = std::unordered_map<NodeKey, std::set<NodeKey>>;
@@ -55,6 +76,15 @@ struct ArbiterResolvedDependencyGraph final : public Arbiter::Base
      */
     void addNode (ArbiterResolvedDependency node, const ArbiterRequirement &initialRequirement) noexcept(false);
 
+    /**
+     * Intersects the requirement of a node already in a graph with a new
+     * requirement for the same project, as done by addNode().
+     *
+     * Returns the combined requirement, or throws an exception if it cannot be
+     * satisfied by the version already selected for the node.
+     */
+    static std::unique_ptr<ArbiterRequirement> unifyRequirements (const ArbiterSelectedVersion &version, const ArbiterRequirement &existingRequirement, const ArbiterRequirement &newRequirement) noexcept(false);
+
     /**
      * Adds an edge from a dependent to its dependency.
      *
@@ -73,10 +103,38 @@ struct ArbiterResolvedDependencyGraph final : public Arbiter::Base
       return _edges;
     }
 
+    /**
+     * Returns a read-optimized form of the graph's structure, creating it if
+     * necessary.
+     *
+     * The compact graph is cached until the graph is next modified, and may be
+     * shared with copies of the graph. Building it costs a sort of every node,
+     * so queries about a single project should use nodes() and edges()
+     * instead.
+     */
+    std::shared_ptr<const Arbiter::CompactGraph> compact () const;
+
     static ArbiterResolvedDependency resolveNode (const NodeMap::value_type &node);
     ArbiterResolvedDependency resolveNode (const NodeMap::key_type &key) const;
 
-    ArbiterResolvedDependencyInstaller createInstaller () const;
+    /**
+     * Groups the nodes of the graph into installation phases, where each node
+     * appears in the phase immediately after the last of its dependencies.
+     *
+     * This takes time linear in the number of nodes and edges.
+     *
+     * Throws an exception if the graph contains a cycle.
+     */
+    ArbiterResolvedDependencyInstaller createInstaller () const noexcept(false);
+
+    /**
+     * Throws an exception describing a dependency cycle among the given nodes.
+     *
+     * `unplaced` must be non-empty, and every node in it must have at least
+     * one dependency which is also in it, as is the case for the nodes left
+     * over from a topological sort.
+     */
+    [[noreturn]] void throwDependencyCycle (const std::unordered_set<NodeKey> &unplaced) const noexcept(false);
 
     /**
      * Creates a new dependency graph that contains only nodes and edges which
@@ -94,7 +152,9 @@ struct ArbiterResolvedDependencyGraph final : public Arbiter::Base
     EdgeMap _edges;
     NodeMap _nodes;
 
-    void walkNodeAndCopyInto (ArbiterResolvedDependencyGraph &newGraph, const NodeKey &key, const Arbiter::Optional<NodeKey> &dependent) const;
+    // Only accessed with std::atomic_load() and std::atomic_store(), since it
+    // is created lazily by const methods.
+    mutable std::shared_ptr<const Arbiter::CompactGraph> _compact;
 };
 
 struct ArbiterResolvedDependencyInstaller final : public Arbiter::Base
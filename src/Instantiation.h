@@ -5,6 +5,7 @@
 #endif
 
 #include "Dependency.h"
+#include "Memory.h"
 #include "Version.h"
 
 #include <functional>
@@ -31,11 +32,16 @@ namespace Arbiter {
 class Instantiation final
 {
   public:
-    using Dependencies = std::unordered_set<ArbiterDependency>;
-    using Versions = std::set<ArbiterSelectedVersion, std::greater<ArbiterSelectedVersion>>;
+    using Dependencies = std::unordered_set<ArbiterDependency, std::hash<ArbiterDependency>, std::equal_to<ArbiterDependency>, CountingAllocator<ArbiterDependency>>;
+    using Versions = std::set<ArbiterSelectedVersion, std::greater<ArbiterSelectedVersion>, CountingAllocator<ArbiterSelectedVersion>>;
 
+    /**
+     * Creates an instantiation with the given dependencies. Memory used for
+     * its versions is counted alongside the dependencies.
+     */
     explicit Instantiation (Dependencies dependencies)
-      : _dependencies(std::move(dependencies))
+      : _versions(Versions::allocator_type(dependencies.get_allocator()))
+      , _dependencies(std::move(dependencies))
     {}
 
     const Dependencies &dependencies () const
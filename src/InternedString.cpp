@@ -0,0 +1,36 @@
+#include "InternedString.h"
+
+#include <mutex>
+#include <unordered_set>
+
+using namespace Arbiter;
+
+namespace {
+
+const std::string *intern (std::string string)
+{
+  // Intentionally leaked, so that interned strings remain valid during static
+  // destruction.
+  static auto &strings = *new std::unordered_set<std::string>;
+  static auto &mutex = *new std::mutex;
+
+  std::lock_guard<std::mutex> guard(mutex);
+
+  // Elements of an unordered_set are never moved, even upon rehashing.
+  return &*strings.insert(std::move(string)).first;
+}
+
+} // namespace
+
+InternedString::InternedString ()
+  : InternedString(nullptr, 0)
+{}
+
+InternedString::InternedString (const char *string, size_t length)
+  : _string(intern(length ? std::string(string, length) : std::string()))
+{}
+
+std::ostream &operator<< (std::ostream &os, const InternedString &string)
+{
+  return os << string.str();
+}
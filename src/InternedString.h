@@ -0,0 +1,87 @@
+#pragma once
+
+#ifndef __cplusplus
+#error "This file must be compiled as C++."
+#endif
+
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <string>
+
+namespace Arbiter {
+
+/**
+ * An immutable string which is shared with every other InternedString of the
+ * same contents, so that equality can be determined by comparing pointers.
+ *
+ * Interned strings are never freed, so this should only be used for values
+ * which are expected to repeat often, like prerelease version identifiers.
+ *
+ * Creating an interned string is thread-safe.
+ */
+class InternedString final
+{
+  public:
+    /**
+     * Creates an empty string.
+     */
+    InternedString ();
+
+    explicit InternedString (const std::string &string)
+      : InternedString(string.data(), string.size())
+    {}
+
+    InternedString (const char *string, size_t length);
+
+    const std::string &str () const noexcept
+    {
+      return *_string;
+    }
+
+    /**
+     * Lexically compares two strings, returning a negative number, zero, or
+     * a positive number like std::string::compare().
+     */
+    int compare (const InternedString &other) const noexcept
+    {
+      return _string == other._string ? 0 : _string->compare(*other._string);
+    }
+
+    bool operator== (const InternedString &other) const noexcept
+    {
+      return _string == other._string;
+    }
+
+    bool operator!= (const InternedString &other) const noexcept
+    {
+      return !(*this == other);
+    }
+
+    bool operator< (const InternedString &other) const noexcept
+    {
+      return compare(other) < 0;
+    }
+
+  private:
+    const std::string *_string;
+};
+
+} // namespace Arbiter
+
+namespace std {
+
+template<>
+struct hash<Arbiter::InternedString> final
+{
+  public:
+    size_t operator() (const Arbiter::InternedString &string) const noexcept
+    {
+      // Equal strings share the same storage, so the address is enough.
+      return hash<const std::string *>()(&string.str());
+    }
+};
+
+} // namespace std
+
+std::ostream &operator<< (std::ostream &os, const Arbiter::InternedString &string);
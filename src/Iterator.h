@@ -193,6 +193,16 @@ class PermutationIterator final : public std::iterator<std::forward_iterator_tag
       return values;
     }
 
+    /**
+     * Returns the current value of the range at `index`, without collecting
+     * the values of every range like operator* does.
+     */
+    typename std::iterator_traits<It>::reference current (size_t index) const
+    {
+      assert(static_cast<bool>(*this));
+      return *_iterators[index];
+    }
+
     /**
      * Returns whether the iterator is valid (i.e., dereferenceable).
      *
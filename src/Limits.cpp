@@ -0,0 +1,76 @@
+#include "Limits.h"
+
+#include "Exception.h"
+
+#include <chrono>
+#include <string>
+
+namespace Arbiter {
+
+ResolverLimits::ResolverLimits (const ArbiterResolverLimits &limits, std::shared_ptr<const void> context)
+  : _limits(limits)
+  , _context(std::move(context))
+  , _enabled(limits.timeLimitSeconds > 0 || limits.maxDeadEnds > 0 || limits.maxFetches > 0 || limits.progress)
+{}
+
+void ResolverLimits::reset () noexcept
+{
+  _depth = 0;
+  _lastProgress = None();
+  _cancellation = ArbiterResolverCancellationNone;
+}
+
+void ResolverLimits::check (const Stats &stats, size_t depth) noexcept(false)
+{
+  _depth = depth;
+
+  const uint64_t fetches = uint64_t(stats._availableVersionFetches) + stats._dependencyListFetches + stats._selectedVersionForMetadataFetches;
+
+  if (_limits.maxDeadEnds > 0 && stats._deadEnds > _limits.maxDeadEnds) {
+    cancel(ArbiterResolverCancellationDeadEndLimit, "too many dead ends");
+  }
+
+  if (_limits.maxFetches > 0 && fetches > _limits.maxFetches) {
+    cancel(ArbiterResolverCancellationFetchLimit, "too many fetches");
+  }
+
+  if (_limits.timeLimitSeconds <= 0 && !_limits.progress) {
+    return;
+  }
+
+  const Clock::time_point now = Clock::now();
+  const double elapsedSeconds = stats._startTime ? std::chrono::duration<double>(now - *stats._startTime).count() : 0;
+
+  if (_limits.timeLimitSeconds > 0 && elapsedSeconds > _limits.timeLimitSeconds) {
+    cancel(ArbiterResolverCancellationTimeLimit, "time limit exceeded");
+  }
+
+  if (!_limits.progress) {
+    return;
+  }
+
+  if (_lastProgress && std::chrono::duration<double>(now - *_lastProgress).count() < _limits.progressIntervalSeconds) {
+    return;
+  }
+
+  _lastProgress = now;
+
+  ArbiterResolverProgress progress;
+  progress.depth = depth;
+  progress.deadEnds = stats._deadEnds;
+  progress.fetches = fetches;
+  progress.fetchedProjects = stats._availableVersionFetches;
+  progress.elapsedSeconds = elapsedSeconds;
+
+  if (!_limits.progress(&progress, _context.get())) {
+    cancel(ArbiterResolverCancellationRequested, "cancelled by progress function");
+  }
+}
+
+void ResolverLimits::cancel (ArbiterResolverCancellation cancellation, const char *reason) noexcept(false)
+{
+  _cancellation = cancellation;
+  throw Exception::Cancelled(std::string("Resolution cancelled: ") + reason);
+}
+
+} // namespace Arbiter
@@ -0,0 +1,86 @@
+#pragma once
+
+#ifndef __cplusplus
+#error "This file must be compiled as C++."
+#endif
+
+#include <arbiter/Limits.h>
+
+#include "Stats.h"
+
+#include <memory>
+
+namespace Arbiter {
+
+/**
+ * Enforces ArbiterResolverLimits upon each resolution, if any have been set.
+ *
+ * Callers should check that limits are enabled before checking them, so that
+ * resolutions without limits cost nothing more than that branch.
+ */
+class ResolverLimits final
+{
+  public:
+    using Clock = Stats::Clock;
+
+    /**
+     * Creates disabled limits.
+     */
+    ResolverLimits () = default;
+
+    ResolverLimits (const ArbiterResolverLimits &limits, std::shared_ptr<const void> context);
+
+    bool enabled () const noexcept
+    {
+      return _enabled;
+    }
+
+    explicit operator bool () const noexcept
+    {
+      return enabled();
+    }
+
+    /**
+     * Prepares to check a new resolution.
+     */
+    void reset () noexcept;
+
+    /**
+     * Checks the progress of the resolution described by `stats`, which is
+     * currently at the given depth, invoking the progress function if it is
+     * due.
+     *
+     * Throws Exception::Cancelled if any limit has been exceeded, or if the
+     * progress function cancelled the resolution.
+     */
+    void check (const Stats &stats, size_t depth) noexcept(false);
+
+    /**
+     * Like check(), but at the depth of the last call to check().
+     */
+    void check (const Stats &stats) noexcept(false)
+    {
+      check(stats, _depth);
+    }
+
+    /**
+     * Returns why the current or last resolution was cancelled.
+     */
+    ArbiterResolverCancellation cancellation () const noexcept
+    {
+      return _cancellation;
+    }
+
+  private:
+    ArbiterResolverLimits _limits{};
+    std::shared_ptr<const void> _context;
+    bool _enabled = false;
+
+    size_t _depth = 0;
+    Optional<Clock::time_point> _lastProgress;
+    ArbiterResolverCancellation _cancellation = ArbiterResolverCancellationNone;
+
+    [[noreturn]] void cancel (ArbiterResolverCancellation cancellation, const char *reason) noexcept(false);
+};
+
+} // namespace Arbiter
@@ -0,0 +1,852 @@
+#include "Lockfile.h"
+
+#include "Exception.h"
+#include "Requirement.h"
+#include "ToString.h"
+#include "Value.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace Arbiter;
+
+namespace {
+
+const char Magic[8] = { 'A', 'R', 'B', 'L', 'O', 'C', 'K', '\0' };
+const uint32_t FormatVersion = 1;
+
+const size_t HeaderSize = 32;
+const size_t NodeSize = 44;
+const size_t EdgeSize = 4;
+
+// Offsets of the fields within a node record. Variable-length fields are
+// stored as an offset into the data section, followed by a length.
+const size_t ProjectField = 0;
+const size_t MetadataField = 8;
+const size_t VersionField = 16;
+const size_t RequirementField = 24;
+const size_t FirstEdgeField = 32;
+const size_t EdgeCountField = 36;
+const size_t FlagsField = 40;
+
+// How deeply compound and prioritized requirements may be nested, so that a
+// malformed file cannot exhaust the stack while decoding.
+const unsigned MaxRequirementDepth = 64;
+
+const uint32_t ProjectIsString = 1 << 0;
+const uint32_t MetadataIsString = 1 << 1;
+const uint32_t HasSemanticVersion = 1 << 2;
+
+enum class RequirementTag : uint8_t
+{
+  Any = 0,
+  AtLeast = 1,
+  CompatibleWith = 2,
+  Exactly = 3,
+  Unversioned = 4,
+  Compound = 5,
+  Prioritized = 6,
+};
+
+void appendU8 (std::string &bytes, uint8_t value)
+{
+  bytes.push_back(char(value));
+}
+
+void appendU32 (std::string &bytes, uint32_t value)
+{
+  for (unsigned shift = 0; shift < 32; shift += 8) {
+    bytes.push_back(char((value >> shift) & 0xFF));
+  }
+}
+
+void appendU64 (std::string &bytes, uint64_t value)
+{
+  appendU32(bytes, uint32_t(value));
+  appendU32(bytes, uint32_t(value >> 32));
+}
+
+uint32_t readU32 (const unsigned char *bytes) noexcept
+{
+  return uint32_t(bytes[0]) | (uint32_t(bytes[1]) << 8) | (uint32_t(bytes[2]) << 16) | (uint32_t(bytes[3]) << 24);
+}
+
+uint64_t readU64 (const unsigned char *bytes) noexcept
+{
+  return uint64_t(readU32(bytes)) | (uint64_t(readU32(bytes + 4)) << 32);
+}
+
+uint32_t checkedU32 (size_t value, const char *what) noexcept(false)
+{
+  if (value > std::numeric_limits<uint32_t>::max()) {
+    throw Exception::SerializationError(std::string("Too many ") + what + " to write into a lockfile");
+  }
+
+  return uint32_t(value);
+}
+
+void appendLengthPrefixed (std::string &bytes, const std::string &value)
+{
+  appendU32(bytes, checkedU32(value.size(), "bytes in one value"));
+  bytes.append(value);
+}
+
+/**
+ * Returns the bytes to write for the given value, and whether the value was
+ * created from a string.
+ */
+template<typename Owner>
+std::pair<std::string, bool> serializeValue (const SharedUserValue<Owner> &value, const char *what) noexcept(false)
+{
+  if (const auto &string = value.string()) {
+    return std::make_pair(*string, true);
+  }
+
+  if (auto bytes = value.serialize()) {
+    return std::make_pair(std::move(*bytes), false);
+  }
+
+  throw Exception::SerializationError(std::string(what) + " " + toString(value) + " cannot be serialized, as it has no createSerialization callback");
+}
+
+template<typename Owner>
+SharedUserValue<Owner> deserializeValue (const char *bytes, size_t length, bool isString, ArbiterUserValue (*create)(const void *, size_t, const void *), const void *context, const char *what) noexcept(false)
+{
+  if (isString) {
+    return SharedUserValue<Owner>(std::string(bytes, length));
+  }
+
+  if (!create) {
+    throw Exception::SerializationError(std::string("No callback was provided to read ") + what + " from the lockfile");
+  }
+
+  return SharedUserValue<Owner>(create(bytes, length, context));
+}
+
+void encodeRequirement (std::string &bytes, const ArbiterRequirement &requirement) noexcept(false)
+{
+  if (dynamic_cast<const Requirement::Any *>(&requirement)) {
+    appendU8(bytes, uint8_t(RequirementTag::Any));
+  } else if (const auto *atLeast = dynamic_cast<const Requirement::AtLeast *>(&requirement)) {
+    appendU8(bytes, uint8_t(RequirementTag::AtLeast));
+    appendLengthPrefixed(bytes, toString(atLeast->_minimumVersion));
+  } else if (const auto *compatible = dynamic_cast<const Requirement::CompatibleWith *>(&requirement)) {
+    appendU8(bytes, uint8_t(RequirementTag::CompatibleWith));
+    appendU8(bytes, uint8_t(compatible->_strictness));
+    appendLengthPrefixed(bytes, toString(compatible->_baseVersion));
+  } else if (const auto *exactly = dynamic_cast<const Requirement::Exactly *>(&requirement)) {
+    appendU8(bytes, uint8_t(RequirementTag::Exactly));
+    appendLengthPrefixed(bytes, toString(exactly->_version));
+  } else if (const auto *unversioned = dynamic_cast<const Requirement::Unversioned *>(&requirement)) {
+    auto metadata = serializeValue(unversioned->_metadata, "Version metadata");
+
+    appendU8(bytes, uint8_t(RequirementTag::Unversioned));
+    appendU8(bytes, metadata.second ? 1 : 0);
+    appendLengthPrefixed(bytes, metadata.first);
+  } else if (const auto *compound = dynamic_cast<const Requirement::Compound *>(&requirement)) {
+    appendU8(bytes, uint8_t(RequirementTag::Compound));
+    appendU32(bytes, checkedU32(compound->_requirements.size(), "compound requirements"));
+
+    for (const auto &child : compound->_requirements) {
+      encodeRequirement(bytes, *child);
+    }
+  } else if (const auto *prioritized = dynamic_cast<const Requirement::Prioritized *>(&requirement)) {
+    appendU8(bytes, uint8_t(RequirementTag::Prioritized));
+    appendU32(bytes, uint32_t(prioritized->priority()));
+    encodeRequirement(bytes, *prioritized->_requirement);
+  } else {
+    throw Exception::SerializationError("Requirement " + toString(requirement) + " cannot be serialized");
+  }
+}
+
+/**
+ * Reads values out of a range of bytes, throwing an exception rather than
+ * reading past the end.
+ */
+class Decoder final
+{
+  public:
+    Decoder (const unsigned char *bytes, size_t length) noexcept
+      : _current(bytes)
+      , _end(bytes + length)
+    {}
+
+    bool atEnd () const noexcept
+    {
+      return _current == _end;
+    }
+
+    uint8_t readU8 () noexcept(false)
+    {
+      return *take(1);
+    }
+
+    uint32_t readU32 () noexcept(false)
+    {
+      return ::readU32(take(4));
+    }
+
+    std::pair<const char *, size_t> readLengthPrefixed () noexcept(false)
+    {
+      size_t length = readU32();
+      return std::make_pair(reinterpret_cast<const char *>(take(length)), length);
+    }
+
+    ArbiterSemanticVersion readSemanticVersion () noexcept(false)
+    {
+      auto string = readLengthPrefixed();
+      return parseSemanticVersion(string.first, string.second);
+    }
+
+    static ArbiterSemanticVersion parseSemanticVersion (const char *string, size_t length) noexcept(false)
+    {
+      std::string error;
+
+      auto version = ArbiterSemanticVersion::fromString(string, length, &error);
+      if (!version) {
+        throw Exception::SerializationError("Malformed lockfile: " + error);
+      }
+
+      return std::move(*version);
+    }
+
+  private:
+    const unsigned char *_current;
+    const unsigned char *_end;
+
+    const unsigned char *take (size_t length) noexcept(false)
+    {
+      if (size_t(_end - _current) < length) {
+        throw Exception::SerializationError("Malformed lockfile: requirement is truncated");
+      }
+
+      const unsigned char *bytes = _current;
+      _current += length;
+      return bytes;
+    }
+};
+
+std::unique_ptr<ArbiterRequirement> decodeRequirement (Decoder &decoder, const ArbiterLockfileValueReaders &readers, unsigned depth = 0) noexcept(false)
+{
+  if (depth > MaxRequirementDepth) {
+    throw Exception::SerializationError("Malformed lockfile: requirements are nested more than " + toString(MaxRequirementDepth) + " levels deep");
+  }
+
+  switch (RequirementTag(decoder.readU8())) {
+    case RequirementTag::Any:
+      return std::make_unique<Requirement::Any>();
+
+    case RequirementTag::AtLeast:
+      return std::make_unique<Requirement::AtLeast>(decoder.readSemanticVersion());
+
+    case RequirementTag::CompatibleWith: {
+      auto strictness = ArbiterRequirementStrictness(decoder.readU8());
+      if (strictness != ArbiterRequirementStrictnessStrict && strictness != ArbiterRequirementStrictnessAllowVersionZeroPatches) {
+        throw Exception::SerializationError("Malformed lockfile: unknown requirement strictness " + toString(int(strictness)));
+      }
+
+      return std::make_unique<Requirement::CompatibleWith>(decoder.readSemanticVersion(), strictness);
+    }
+
+    case RequirementTag::Exactly:
+      return std::make_unique<Requirement::Exactly>(decoder.readSemanticVersion());
+
+    case RequirementTag::Unversioned: {
+      bool isString = decoder.readU8();
+      auto bytes = decoder.readLengthPrefixed();
+
+      return std::make_unique<Requirement::Unversioned>(deserializeValue<ArbiterSelectedVersion>(bytes.first, bytes.second, isString, readers.createSelectedVersionMetadata, readers.context, "version metadata"));
+    }
+
+    case RequirementTag::Compound: {
+      uint32_t count = decoder.readU32();
+
+      std::vector<std::shared_ptr<ArbiterRequirement>> requirements;
+      for (uint32_t i = 0; i < count; i++) {
+        requirements.emplace_back(decodeRequirement(decoder, readers, depth + 1));
+      }
+
+      return std::make_unique<Requirement::Compound>(std::move(requirements));
+    }
+
+    case RequirementTag::Prioritized: {
+      auto priority = int(int32_t(decoder.readU32()));
+      return std::make_unique<Requirement::Prioritized>(decodeRequirement(decoder, readers, depth + 1), priority);
+    }
+  }
+
+  throw Exception::SerializationError("Malformed lockfile: unknown requirement type");
+}
+
+template<typename Function>
+bool catchErrors (char **error, Function fn)
+{
+  try {
+    fn();
+    return true;
+  } catch (const std::exception &ex) {
+    if (error) {
+      *error = copyCString(ex.what()).release();
+    }
+
+    return false;
+  }
+}
+
+} // namespace
+
+void Lockfile::write (const ArbiterResolvedDependencyGraph &graph, const Sink &sink) noexcept(false)
+{
+  struct Node final
+  {
+    public:
+      const ArbiterResolvedDependencyGraph::NodeMap::value_type *_node;
+      std::pair<std::string, bool> _project;
+      std::pair<std::string, bool> _metadata;
+      std::string _version;
+      std::string _requirement;
+  };
+
+  std::vector<Node> nodes;
+  nodes.reserve(graph.nodes().size());
+
+  for (const auto &pair : graph.nodes()) {
+    const ArbiterSelectedVersion &version = pair.second._version;
+
+    Node node{ &pair, serializeValue(pair.first._value, "Project identifier"), serializeValue(version._metadata, "Version metadata"), {}, {} };
+    if (version._semanticVersion) {
+      node._version = toString(*version._semanticVersion);
+    }
+
+    encodeRequirement(node._requirement, pair.second.requirement());
+    nodes.emplace_back(std::move(node));
+  }
+
+  std::sort(nodes.begin(), nodes.end(), [](const Node &lhs, const Node &rhs) {
+    return lhs._project.first < rhs._project.first;
+  });
+
+  std::unordered_map<ArbiterProjectIdentifier, uint32_t> indexesByProject;
+  indexesByProject.reserve(nodes.size());
+
+  for (size_t index = 0; index < nodes.size(); index++) {
+    if (index > 0 && nodes[index - 1]._project.first == nodes[index]._project.first) {
+      throw Exception::SerializationError("Projects " + toString(nodes[index - 1]._node->first) + " and " + toString(nodes[index]._node->first) + " have the same serialization");
+    }
+
+    indexesByProject.emplace(nodes[index]._node->first, checkedU32(index, "nodes"));
+  }
+
+  std::string edges;
+  std::string records;
+  records.reserve(nodes.size() * NodeSize);
+
+  uint64_t dataSize = 0;
+  uint32_t edgeCount = 0;
+
+  auto appendField = [&records, &dataSize](const std::string &bytes) {
+    appendU32(records, checkedU32(dataSize, "bytes of data"));
+    appendU32(records, checkedU32(bytes.size(), "bytes in one value"));
+    dataSize += bytes.size();
+  };
+
+  for (const Node &node : nodes) {
+    std::vector<uint32_t> dependencies;
+
+    const auto it = graph.edges().find(node._node->first);
+    if (it != graph.edges().end()) {
+      for (const ArbiterProjectIdentifier &dependency : it->second) {
+        dependencies.emplace_back(indexesByProject.at(dependency));
+      }
+
+      std::sort(dependencies.begin(), dependencies.end());
+    }
+
+    appendField(node._project.first);
+    appendField(node._metadata.first);
+    appendField(node._version);
+    appendField(node._requirement);
+    appendU32(records, edgeCount);
+    appendU32(records, checkedU32(dependencies.size(), "edges"));
+
+    uint32_t flags = 0;
+    if (node._project.second) {
+      flags |= ProjectIsString;
+    }
+    if (node._metadata.second) {
+      flags |= MetadataIsString;
+    }
+    if (node._node->second._version._semanticVersion) {
+      flags |= HasSemanticVersion;
+    }
+
+    appendU32(records, flags);
+
+    for (uint32_t dependency : dependencies) {
+      appendU32(edges, dependency);
+    }
+
+    edgeCount = checkedU32(size_t(edgeCount) + dependencies.size(), "edges");
+  }
+
+  checkedU32(dataSize, "bytes of data");
+
+  std::string header(Magic, sizeof(Magic));
+  appendU32(header, FormatVersion);
+  appendU32(header, uint32_t(nodes.size()));
+  appendU32(header, edgeCount);
+  appendU32(header, 0);
+  appendU64(header, dataSize);
+  assert(header.size() == HeaderSize);
+
+  sink(header.data(), header.size());
+  sink(records.data(), records.size());
+  sink(edges.data(), edges.size());
+
+  for (const Node &node : nodes) {
+    for (const std::string *field : { &node._project.first, &node._metadata.first, &node._version, &node._requirement }) {
+      if (!field->empty()) {
+        sink(field->data(), field->size());
+      }
+    }
+  }
+}
+
+void Lockfile::writeDependencies (const ArbiterDependencyList &dependencies, const Sink &sink) noexcept(false)
+{
+  std::string bytes;
+  appendU32(bytes, checkedU32(dependencies._dependencies.size(), "dependencies"));
+
+  for (const ArbiterDependency &dependency : dependencies._dependencies) {
+    auto project = serializeValue(dependency._projectIdentifier._value, "Project identifier");
+
+    appendU8(bytes, project.second ? 1 : 0);
+    appendLengthPrefixed(bytes, project.first);
+    encodeRequirement(bytes, dependency.requirement());
+  }
+
+  sink(bytes.data(), bytes.size());
+}
+
+/**
+ * A read-only memory mapping of an entire file.
+ */
+class ArbiterLockfile::Mapping final
+{
+  public:
+    const unsigned char *_bytes = nullptr;
+    size_t _size = 0;
+
+    explicit Mapping (const std::string &path) noexcept(false)
+    {
+      int fd = open(path.c_str(), O_RDONLY);
+      if (fd < 0) {
+        throw Exception::SerializationError("Could not open lockfile " + path + ": " + std::strerror(errno));
+      }
+
+      struct stat info;
+      if (fstat(fd, &info) != 0) {
+        int code = errno;
+        close(fd);
+        throw Exception::SerializationError("Could not read lockfile " + path + ": " + std::strerror(code));
+      }
+
+      _size = size_t(info.st_size);
+      if (_size < HeaderSize) {
+        close(fd);
+        throw Exception::SerializationError("Malformed lockfile " + path + ": file is too small");
+      }
+
+      void *bytes = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+      int code = errno;
+      close(fd);
+
+      if (bytes == MAP_FAILED) {
+        throw Exception::SerializationError("Could not map lockfile " + path + ": " + std::strerror(code));
+      }
+
+      _bytes = static_cast<const unsigned char *>(bytes);
+    }
+
+    Mapping (const Mapping &) = delete;
+    Mapping &operator= (const Mapping &) = delete;
+
+    ~Mapping ()
+    {
+      munmap(const_cast<unsigned char *>(_bytes), _size);
+    }
+};
+
+ArbiterLockfile::ArbiterLockfile (const std::string &path, ArbiterLockfileValueReaders readers) noexcept(false)
+  : _path(path)
+  , _readers(readers)
+  , _mapping(std::make_shared<Mapping>(path))
+{
+  const unsigned char *bytes = _mapping->_bytes;
+
+  if (std::memcmp(bytes, Magic, sizeof(Magic)) != 0) {
+    throw Exception::SerializationError("Malformed lockfile " + path + ": not a lockfile");
+  }
+
+  uint32_t version = readU32(bytes + 8);
+  if (version != FormatVersion) {
+    throw Exception::SerializationError("Lockfile " + path + " has unsupported format version " + toString(version));
+  }
+
+  _nodeCount = readU32(bytes + 12);
+  _edgeCount = readU32(bytes + 16);
+  uint64_t dataSize = readU64(bytes + 24);
+
+  // The writer never produces more data than this, and bounding it keeps the
+  // offset checks in validate() from being defeated by a huge size.
+  if (dataSize > std::numeric_limits<uint32_t>::max()) {
+    throw Exception::SerializationError("Malformed lockfile " + path + ": data section of " + toString(dataSize) + " bytes is too large");
+  }
+
+  // Carve each section out of what remains of the file, rather than adding up
+  // the sizes from the header, which could overflow.
+  uint64_t remaining = _mapping->_size - HeaderSize;
+
+  uint64_t nodesSize = uint64_t(_nodeCount) * NodeSize;
+  if (nodesSize > remaining) {
+    throw Exception::SerializationError("Malformed lockfile " + path + ": node table is truncated");
+  }
+
+  remaining -= nodesSize;
+
+  uint64_t edgesSize = uint64_t(_edgeCount) * EdgeSize;
+  if (edgesSize > remaining) {
+    throw Exception::SerializationError("Malformed lockfile " + path + ": edge table is truncated");
+  }
+
+  remaining -= edgesSize;
+
+  if (dataSize != remaining) {
+    throw Exception::SerializationError("Malformed lockfile " + path + ": expected " + toString(dataSize) + " bytes of data, but found " + toString(remaining));
+  }
+
+  _nodes = bytes + HeaderSize;
+  _edges = _nodes + _nodeCount * NodeSize;
+  _data = _edges + _edgeCount * EdgeSize;
+  _dataSize = size_t(dataSize);
+
+  validate();
+}
+
+void ArbiterLockfile::validate () const noexcept(false)
+{
+  auto fail = [this](const std::string &reason) {
+    throw Exception::SerializationError("Malformed lockfile " + _path + ": " + reason);
+  };
+
+  for (size_t index = 0; index < _nodeCount; index++) {
+    const unsigned char *record = node(index);
+
+    for (size_t field : { ProjectField, MetadataField, VersionField, RequirementField }) {
+      uint64_t offset = readU32(record + field);
+      uint64_t length = readU32(record + field + 4);
+
+      if (offset + length > _dataSize) {
+        fail("node " + toString(index) + " refers to data out of bounds");
+      }
+    }
+
+    uint64_t firstEdge = readU32(record + FirstEdgeField);
+    uint64_t edgeCount = readU32(record + EdgeCountField);
+    if (firstEdge + edgeCount > _edgeCount) {
+      fail("node " + toString(index) + " refers to edges out of bounds");
+    }
+
+    if (index > 0) {
+      size_t previousLength = 0;
+      const char *previous = projectBytes(index - 1, &previousLength);
+
+      size_t length = 0;
+      const char *current = projectBytes(index, &length);
+
+      int order = std::memcmp(previous, current, std::min(previousLength, length));
+      if (order > 0 || (order == 0 && previousLength >= length)) {
+        fail("nodes are not sorted");
+      }
+    }
+  }
+
+  for (size_t edge = 0; edge < _edgeCount; edge++) {
+    if (readU32(_edges + edge * EdgeSize) >= _nodeCount) {
+      fail("edge " + toString(edge) + " refers to a nonexistent node");
+    }
+  }
+}
+
+const unsigned char *ArbiterLockfile::node (size_t index) const noexcept
+{
+  assert(index < _nodeCount);
+  return _nodes + index * NodeSize;
+}
+
+Optional<size_t> ArbiterLockfile::find (const void *bytes, size_t length) const noexcept
+{
+  size_t low = 0;
+  size_t high = _nodeCount;
+
+  while (low < high) {
+    size_t middle = low + (high - low) / 2;
+
+    size_t middleLength = 0;
+    const char *middleBytes = projectBytes(middle, &middleLength);
+
+    int order = std::memcmp(middleBytes, bytes, std::min(middleLength, length));
+    if (order == 0) {
+      order = (middleLength < length ? -1 : (middleLength > length ? 1 : 0));
+    }
+
+    if (order == 0) {
+      return makeOptional(middle);
+    } else if (order < 0) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+
+  return None();
+}
+
+const char *ArbiterLockfile::projectBytes (size_t index, size_t *length) const noexcept
+{
+  const unsigned char *record = node(index);
+
+  *length = readU32(record + ProjectField + 4);
+  return reinterpret_cast<const char *>(_data + readU32(record + ProjectField));
+}
+
+ArbiterProjectIdentifier ArbiterLockfile::project (size_t index) const noexcept(false)
+{
+  size_t length = 0;
+  const char *bytes = projectBytes(index, &length);
+
+  bool isString = readU32(node(index) + FlagsField) & ProjectIsString;
+  return ArbiterProjectIdentifier(deserializeValue<ArbiterProjectIdentifier>(bytes, length, isString, _readers.createProjectIdentifierValue, _readers.context, "project identifiers"));
+}
+
+ArbiterSelectedVersion ArbiterLockfile::version (size_t index) const noexcept(false)
+{
+  const unsigned char *record = node(index);
+  uint32_t flags = readU32(record + FlagsField);
+
+  Optional<ArbiterSemanticVersion> semanticVersion;
+  if (flags & HasSemanticVersion) {
+    const auto *bytes = reinterpret_cast<const char *>(_data + readU32(record + VersionField));
+    semanticVersion = Decoder::parseSemanticVersion(bytes, readU32(record + VersionField + 4));
+  }
+
+  const auto *metadata = reinterpret_cast<const char *>(_data + readU32(record + MetadataField));
+  size_t metadataLength = readU32(record + MetadataField + 4);
+
+  return ArbiterSelectedVersion(std::move(semanticVersion), deserializeValue<ArbiterSelectedVersion>(metadata, metadataLength, flags & MetadataIsString, _readers.createSelectedVersionMetadata, _readers.context, "version metadata"));
+}
+
+std::unique_ptr<ArbiterRequirement> ArbiterLockfile::requirement (size_t index) const noexcept(false)
+{
+  const unsigned char *record = node(index);
+
+  Decoder decoder(_data + readU32(record + RequirementField), readU32(record + RequirementField + 4));
+  auto requirement = decodeRequirement(decoder, _readers);
+
+  if (!decoder.atEnd()) {
+    throw Exception::SerializationError("Malformed lockfile " + _path + ": requirement of node " + toString(index) + " has trailing data");
+  }
+
+  return requirement;
+}
+
+size_t ArbiterLockfile::countDependencies (size_t index) const noexcept
+{
+  return readU32(node(index) + EdgeCountField);
+}
+
+size_t ArbiterLockfile::dependency (size_t index, size_t position) const noexcept
+{
+  assert(position < countDependencies(index));
+
+  size_t edge = readU32(node(index) + FirstEdgeField) + position;
+  return readU32(_edges + edge * EdgeSize);
+}
+
+ArbiterResolvedDependencyGraph ArbiterLockfile::graph () const noexcept(false)
+{
+  std::vector<ArbiterProjectIdentifier> projects;
+  projects.reserve(_nodeCount);
+
+  ArbiterResolvedDependencyGraph graph;
+
+  for (size_t index = 0; index < _nodeCount; index++) {
+    projects.emplace_back(project(index));
+
+    ArbiterSelectedVersion selectedVersion = version(index);
+    auto nodeRequirement = requirement(index);
+
+    if (!nodeRequirement->satisfiedBy(selectedVersion)) {
+      throw Exception::SerializationError("Malformed lockfile " + _path + ": " + toString(selectedVersion) + " does not satisfy " + toString(*nodeRequirement));
+    }
+
+    graph.addNode(ArbiterResolvedDependency(projects.back(), std::move(selectedVersion)), *nodeRequirement);
+  }
+
+  for (size_t index = 0; index < _nodeCount; index++) {
+    for (size_t position = 0; position < countDependencies(index); position++) {
+      graph.addEdge(projects[index], projects[dependency(index, position)]);
+    }
+  }
+
+  return graph;
+}
+
+std::unique_ptr<Arbiter::Base> ArbiterLockfile::clone () const
+{
+  return std::unique_ptr<ArbiterLockfile>(new ArbiterLockfile(*this));
+}
+
+std::ostream &ArbiterLockfile::describe (std::ostream &os) const
+{
+  return os << "ArbiterLockfile(" << _path << ", " << _nodeCount << " nodes)";
+}
+
+bool ArbiterLockfile::operator== (const Arbiter::Base &other) const
+{
+  auto ptr = dynamic_cast<const ArbiterLockfile *>(&other);
+  if (!ptr) {
+    return false;
+  }
+
+  return _mapping == ptr->_mapping;
+}
+
+bool ArbiterResolvedDependencyGraphWriteLockfile (const ArbiterResolvedDependencyGraph *graph, const char *path, char **error)
+{
+  return catchErrors(error, [&] {
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+    if (!stream) {
+      throw Exception::SerializationError(std::string("Could not open ") + path + " for writing: " + std::strerror(errno));
+    }
+
+    Lockfile::write(*graph, [&stream](const char *bytes, size_t length) {
+      stream.write(bytes, std::streamsize(length));
+    });
+
+    stream.close();
+    if (!stream) {
+      throw Exception::SerializationError(std::string("Could not write to ") + path);
+    }
+  });
+}
+
+bool ArbiterResolvedDependencyGraphWriteLockfileToFunction (const ArbiterResolvedDependencyGraph *graph, ArbiterLockfileWriteFunction write, void *context, char **error)
+{
+  return catchErrors(error, [&] {
+    Lockfile::write(*graph, [&](const char *bytes, size_t length) {
+      if (!write(bytes, length, context)) {
+        throw Exception::SerializationError("Lockfile write function reported an error");
+      }
+    });
+  });
+}
+
+ArbiterLockfile *ArbiterLockfileOpen (const char *path, ArbiterLockfileValueReaders readers, char **error)
+{
+  ArbiterLockfile *lockfile = nullptr;
+
+  catchErrors(error, [&] {
+    lockfile = new ArbiterLockfile(path, readers);
+  });
+
+  return lockfile;
+}
+
+size_t ArbiterLockfileCount (const ArbiterLockfile *lockfile)
+{
+  return lockfile->size();
+}
+
+bool ArbiterLockfileFind (const ArbiterLockfile *lockfile, const void *projectBytes, size_t length, size_t *index)
+{
+  auto found = lockfile->find(projectBytes, length);
+  if (!found) {
+    return false;
+  }
+
+  *index = *found;
+  return true;
+}
+
+const void *ArbiterLockfileProjectBytes (const ArbiterLockfile *lockfile, size_t index, size_t *length)
+{
+  return lockfile->projectBytes(index, length);
+}
+
+ArbiterProjectIdentifier *ArbiterLockfileCreateProjectIdentifier (const ArbiterLockfile *lockfile, size_t index, char **error)
+{
+  ArbiterProjectIdentifier *project = nullptr;
+
+  catchErrors(error, [&] {
+    project = new ArbiterProjectIdentifier(lockfile->project(index));
+  });
+
+  return project;
+}
+
+ArbiterSelectedVersion *ArbiterLockfileCreateSelectedVersion (const ArbiterLockfile *lockfile, size_t index, char **error)
+{
+  ArbiterSelectedVersion *version = nullptr;
+
+  catchErrors(error, [&] {
+    version = new ArbiterSelectedVersion(lockfile->version(index));
+  });
+
+  return version;
+}
+
+ArbiterRequirement *ArbiterLockfileCreateRequirement (const ArbiterLockfile *lockfile, size_t index, char **error)
+{
+  ArbiterRequirement *requirement = nullptr;
+
+  catchErrors(error, [&] {
+    requirement = lockfile->requirement(index).release();
+  });
+
+  return requirement;
+}
+
+size_t ArbiterLockfileCountDependencies (const ArbiterLockfile *lockfile, size_t index)
+{
+  return lockfile->countDependencies(index);
+}
+
+void ArbiterLockfileGetAllDependencies (const ArbiterLockfile *lockfile, size_t index, size_t *buffer)
+{
+  for (size_t position = 0; position < lockfile->countDependencies(index); position++) {
+    *(buffer++) = lockfile->dependency(index, position);
+  }
+}
+
+ArbiterResolvedDependencyGraph *ArbiterLockfileCreateResolvedDependencyGraph (const ArbiterLockfile *lockfile, char **error)
+{
+  ArbiterResolvedDependencyGraph *graph = nullptr;
+
+  catchErrors(error, [&] {
+    graph = new ArbiterResolvedDependencyGraph(lockfile->graph());
+  });
+
+  return graph;
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#ifndef __cplusplus
+#error "This file must be compiled as C++."
+#endif
+
+#include <arbiter/Lockfile.h>
+
+#include "Dependency.h"
+#include "Graph.h"
+#include "Optional.h"
+#include "Types.h"
+#include "Version.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+
+namespace Arbiter {
+namespace Lockfile {
+
+/**
+ * Receives sequential chunks of a lockfile being written.
+ */
+using Sink = std::function<void(const char *bytes, size_t length)>;
+
+/**
+ * Writes the given graph in the lockfile format, passing it to `sink` in
+ * sequential chunks.
+ *
+ * The format consists of a fixed-size header, a table of fixed-size node
+ * records sorted by the serializations of their project identifiers, a table
+ * of edges, and finally the variable-length data referenced by the node
+ * records. All integers are little-endian.
+ *
+ * Throws an exception if any part of the graph cannot be serialized.
+ */
+void write (const ArbiterResolvedDependencyGraph &graph, const Sink &sink) noexcept(false);
+
+/**
+ * Writes the given dependencies, in order, with their project identifiers and
+ * requirements encoded as they are in lockfiles, so that equal lists always
+ * produce the same bytes.
+ *
+ * Throws an exception if any dependency cannot be serialized.
+ */
+void writeDependencies (const ArbiterDependencyList &dependencies, const Sink &sink) noexcept(false);
+
+} // namespace Lockfile
+} // namespace Arbiter
+
+struct ArbiterLockfile final : public Arbiter::Base
+{
+  public:
+    /**
+     * Maps the lockfile at the given path into memory, and validates its
+     * structure.
+     *
+     * Throws an exception if the file cannot be read or is malformed.
+     */
+    ArbiterLockfile (const std::string &path, ArbiterLockfileValueReaders readers) noexcept(false);
+
+    size_t size () const noexcept
+    {
+      return _nodeCount;
+    }
+
+    /**
+     * Looks up a node by the serialization of its project identifier.
+     */
+    Arbiter::Optional<size_t> find (const void *projectBytes, size_t length) const noexcept;
+
+    /**
+     * Returns the serialization of the project identifier of the node at
+     * `index`, pointing into the mapped file.
+     */
+    const char *projectBytes (size_t index, size_t *length) const noexcept;
+
+    ArbiterProjectIdentifier project (size_t index) const noexcept(false);
+    ArbiterSelectedVersion version (size_t index) const noexcept(false);
+    std::unique_ptr<ArbiterRequirement> requirement (size_t index) const noexcept(false);
+
+    size_t countDependencies (size_t index) const noexcept;
+
+    /**
+     * Returns the index of the `position`th dependency of the node at `index`.
+     */
+    size_t dependency (size_t index, size_t position) const noexcept;
+
+    /**
+     * Reads the entire lockfile into a dependency graph.
+     */
+    ArbiterResolvedDependencyGraph graph () const noexcept(false);
+
+    std::unique_ptr<Arbiter::Base> clone () const override;
+    std::ostream &describe (std::ostream &os) const override;
+    bool operator== (const Arbiter::Base &other) const override;
+
+  private:
+    class Mapping;
+
+    std::string _path;
+    ArbiterLockfileValueReaders _readers;
+
+    // Shared with clones, as the mapping is read-only.
+    std::shared_ptr<const Mapping> _mapping;
+
+    size_t _nodeCount;
+    size_t _edgeCount;
+    const unsigned char *_nodes;
+    const unsigned char *_edges;
+    const unsigned char *_data;
+    size_t _dataSize;
+
+    ArbiterLockfile (const ArbiterLockfile &) = default;
+
+    const unsigned char *node (size_t index) const noexcept;
+
+    void validate () const noexcept(false);
+};
@@ -0,0 +1,162 @@
+#pragma once
+
+#ifndef __cplusplus
+#error "This file must be compiled as C++."
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace Arbiter {
+
+/**
+ * Tracks the number of bytes currently allocated for some purpose, and the
+ * most that were allocated at once.
+ *
+ * Memory counters are not thread-safe.
+ */
+class MemoryCounter final
+{
+  public:
+    void allocated (size_t bytes) noexcept
+    {
+      _current += bytes;
+      _peak = std::max(_peak, _current);
+    }
+
+    void deallocated (size_t bytes) noexcept
+    {
+      _current -= bytes;
+    }
+
+    size_t current () const noexcept
+    {
+      return _current;
+    }
+
+    size_t peak () const noexcept
+    {
+      return _peak;
+    }
+
+    /**
+     * Starts measuring the peak again from the current number of bytes.
+     */
+    void resetPeak () noexcept
+    {
+      _peak = _current;
+    }
+
+  private:
+    size_t _current = 0;
+    size_t _peak = 0;
+};
+
+/**
+ * Like MemoryCounter, but safe to update from multiple threads at once.
+ */
+class AtomicMemoryCounter final
+{
+  public:
+    void allocated (size_t bytes) noexcept
+    {
+      size_t current = _current.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+
+      size_t peak = _peak.load(std::memory_order_relaxed);
+      while (peak < current && !_peak.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {
+      }
+    }
+
+    void deallocated (size_t bytes) noexcept
+    {
+      _current.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+
+    size_t current () const noexcept
+    {
+      return _current.load(std::memory_order_relaxed);
+    }
+
+    size_t peak () const noexcept
+    {
+      return _peak.load(std::memory_order_relaxed);
+    }
+
+  private:
+    std::atomic<size_t> _current{0};
+    std::atomic<size_t> _peak{0};
+};
+
+/**
+ * A standard allocator which allocates from the heap, and records the size of
+ * every allocation in a MemoryCounter.
+ *
+ * An allocator without a counter behaves like std::allocator.
+ *
+ * This is not final, since standard containers may derive from their
+ * allocator.
+ */
+template<typename T>
+class CountingAllocator
+{
+  public:
+    using value_type = T;
+
+    CountingAllocator () noexcept = default;
+
+    explicit CountingAllocator (MemoryCounter *counter) noexcept
+      : _counter(counter)
+    {}
+
+    template<typename U>
+    CountingAllocator (const CountingAllocator<U> &other) noexcept
+      : _counter(other._counter)
+    {}
+
+    T *allocate (size_t count)
+    {
+      T *ptr = std::allocator<T>().allocate(count);
+
+      if (_counter) {
+        _counter->allocated(count * sizeof(T));
+      }
+
+      return ptr;
+    }
+
+    void deallocate (T *ptr, size_t count) noexcept
+    {
+      if (_counter) {
+        _counter->deallocated(count * sizeof(T));
+      }
+
+      std::allocator<T>().deallocate(ptr, count);
+    }
+
+    MemoryCounter *counter () const noexcept
+    {
+      return _counter;
+    }
+
+    template<typename U>
+    bool operator== (const CountingAllocator<U> &other) const noexcept
+    {
+      return _counter == other._counter;
+    }
+
+    template<typename U>
+    bool operator!= (const CountingAllocator<U> &other) const noexcept
+    {
+      return !(*this == other);
+    }
+
+  private:
+    template<typename U>
+    friend class CountingAllocator;
+
+    MemoryCounter *_counter = nullptr;
+};
+
+} // namespace Arbiter
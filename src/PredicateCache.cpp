@@ -0,0 +1,32 @@
+#include "PredicateCache.h"
+
+#include "Hash.h"
+
+namespace Arbiter {
+
+const std::vector<uint64_t> *PredicateCache::find (const Key &key)
+{
+  auto it = _masks.find(key);
+  if (it == _masks.end()) {
+    ++_misses;
+    return nullptr;
+  } else {
+    ++_hits;
+    return &it->second;
+  }
+}
+
+void PredicateCache::insert (Key key, std::vector<uint64_t> mask)
+{
+  _masks[std::move(key)] = std::move(mask);
+}
+
+size_t PredicateCache::KeyHash::operator() (const Key &key) const
+{
+  return hashOf(std::get<0>(key))
+    ^ hashOf(std::get<1>(key))
+    ^ hashOf(std::get<2>(key))
+    ^ hashOf(std::get<3>(key));
+}
+
+} // namespace Arbiter
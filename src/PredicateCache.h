@@ -0,0 +1,81 @@
+#pragma once
+
+#ifndef __cplusplus
+#error "This file must be compiled as C++."
+#endif
+
+#include <arbiter/Requirement.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace Arbiter {
+
+class VersionBlock;
+
+/**
+ * Remembers the results of evaluating custom requirement predicates against
+ * blocks of versions, so that checking the same predicate against the same
+ * domain again does not need to call back into user code.
+ *
+ * Results are keyed upon the address of the VersionBlock, so a cache must not
+ * outlive any of the blocks it has been used with.
+ *
+ * Only evaluations against a whole domain (by satisfiedByEach()) are
+ * memoized. Checking a single version with satisfiedBy(), including one
+ * outside of any block, always invokes the predicate.
+ */
+class PredicateCache final
+{
+  public:
+    using Key = std::tuple<const VersionBlock *, ArbiterRequirementPredicate, ArbiterRequirementBatchPredicate, const void *>;
+
+    /**
+     * Returns the cached mask for the given key, or `nullptr` if there is not
+     * one.
+     */
+    const std::vector<uint64_t> *find (const Key &key);
+
+    void insert (Key key, std::vector<uint64_t> mask);
+
+    /**
+     * Removes all cached masks, and resets the counts of hits and misses.
+     */
+    void clear () noexcept
+    {
+      _masks.clear();
+      _hits = 0;
+      _misses = 0;
+    }
+
+    /**
+     * The number of calls to find() which did and did not find a mask,
+     * respectively, since the cache was last cleared.
+     */
+    unsigned hits () const noexcept
+    {
+      return _hits;
+    }
+
+    unsigned misses () const noexcept
+    {
+      return _misses;
+    }
+
+  private:
+    unsigned _hits = 0;
+    unsigned _misses = 0;
+
+    struct KeyHash final
+    {
+      public:
+        size_t operator() (const Key &key) const;
+    };
+
+    std::unordered_map<Key, std::vector<uint64_t>, KeyHash> _masks;
+};
+
+} // namespace Arbiter
@@ -9,35 +9,31 @@ namespace Arbiter {
 
 std::shared_ptr<Instantiation> Project::addInstantiation (const ArbiterSelectedVersion &version, const ArbiterDependencyList &dependencyList)
 {
-  Instantiation::Dependencies dependencies(dependencyList._dependencies.begin(), dependencyList._dependencies.end());
+  // Instantiations share the counter of the list which holds them.
+  const Instantiations::allocator_type &allocator = _instantiations.get_allocator();
 
-  std::shared_ptr<Instantiation> inst = instantiationForDependencies(dependencies);
-  if (!inst) {
-    inst = std::make_shared<Instantiation>(std::move(dependencies));
-    _instantiations.emplace_back(inst);
-  }
-
-  inst->_versions.emplace(version);
-  return inst;
-}
+  Instantiation::Dependencies dependencies(dependencyList._dependencies.begin(), dependencyList._dependencies.end(), 0, Instantiation::Dependencies::hasher(), Instantiation::Dependencies::key_equal(), Instantiation::Dependencies::allocator_type(allocator));
 
-std::shared_ptr<Instantiation> Project::instantiationForVersion (const ArbiterSelectedVersion &version) const
-{
   auto it = std::find_if(_instantiations.begin(), _instantiations.end(), [&](const auto &instantiation) {
-    return instantiation->_versions.find(version) != instantiation->_versions.end();
+    return instantiation->dependencies() == dependencies;
   });
 
+  std::shared_ptr<Instantiation> inst;
   if (it == _instantiations.end()) {
-    return nullptr;
+    inst = std::allocate_shared<Instantiation>(CountingAllocator<Instantiation>(allocator), std::move(dependencies));
+    _instantiations.emplace_back(inst);
   } else {
-    return *it;
+    inst = *it;
   }
+
+  inst->_versions.emplace(version);
+  return inst;
 }
 
-std::shared_ptr<Instantiation> Project::instantiationForDependencies (const std::unordered_set<ArbiterDependency> &dependencies) const
+std::shared_ptr<Instantiation> Project::instantiationForVersion (const ArbiterSelectedVersion &version) const
 {
   auto it = std::find_if(_instantiations.begin(), _instantiations.end(), [&](const auto &instantiation) {
-    return instantiation->dependencies() == dependencies;
+    return instantiation->_versions.find(version) != instantiation->_versions.end();
   });
 
   if (it == _instantiations.end()) {
@@ -54,6 +50,11 @@ ArbiterProjectIdentifier *ArbiterCreateProjectIdentifier (ArbiterUserValue value
   return new ArbiterProjectIdentifier(ArbiterProjectIdentifier::Value(value));
 }
 
+ArbiterProjectIdentifier *ArbiterCreateProjectIdentifierFromString (const char *string, size_t length)
+{
+  return new ArbiterProjectIdentifier(ArbiterProjectIdentifier::Value(std::string(string, length)));
+}
+
 const void *ArbiterProjectIdentifierValue (const ArbiterProjectIdentifier *projectIdentifier)
 {
   return projectIdentifier->_value.data();
@@ -6,9 +6,11 @@
 
 #include <arbiter/Project.h>
 
+#include "Memory.h"
 #include "Types.h"
 #include "Value.h"
 #include "Version.h"
+#include "VersionBlock.h"
 
 #include <functional>
 #include <memory>
@@ -59,18 +61,44 @@ namespace Arbiter {
 class Project final
 {
   public:
-    using Domain = std::set<ArbiterSelectedVersion, std::greater<ArbiterSelectedVersion>>;
-    using Instantiations = std::vector<std::shared_ptr<Instantiation>>;
+    using Domain = std::set<ArbiterSelectedVersion, std::greater<ArbiterSelectedVersion>, CountingAllocator<ArbiterSelectedVersion>>;
+    using Instantiations = std::vector<std::shared_ptr<Instantiation>, CountingAllocator<std::shared_ptr<Instantiation>>>;
 
-    explicit Project (Domain domain)
+    /**
+     * Creates a project with the given domain.
+     *
+     * Memory used for the domain is counted by the domain's allocator, and
+     * memory used for instantiations is counted by `instantiationCounter` if
+     * it is not null.
+     */
+    explicit Project (Domain domain, MemoryCounter *instantiationCounter = nullptr)
       : _domain(std::move(domain))
+      , _domainBlock(_domain.begin(), _domain.end(), _domain.get_allocator().counter())
+      , _instantiations(Instantiations::allocator_type(instantiationCounter))
     {}
 
+    // The domain block points into the domain, which remains valid when moved,
+    // but not when copied.
+    Project (const Project &) = delete;
+    Project &operator= (const Project &) = delete;
+
+    Project (Project &&) = default;
+    Project &operator= (Project &&) = default;
+
     const Domain &domain () const
     {
       return _domain;
     }
 
+    /**
+     * The versions of the domain, in the same order, for evaluating
+     * requirements against all of them at once.
+     */
+    const VersionBlock &domainBlock () const
+    {
+      return _domainBlock;
+    }
+
     const Instantiations &instantiations () const
     {
       return _instantiations;
@@ -79,7 +107,6 @@ class Project final
     std::shared_ptr<Instantiation> addInstantiation (const ArbiterSelectedVersion &version, const ArbiterDependencyList &dependencyList);
 
     std::shared_ptr<Instantiation> instantiationForVersion (const ArbiterSelectedVersion &version) const;
-    std::shared_ptr<Instantiation> instantiationForDependencies (const std::unordered_set<ArbiterDependency> &dependencies) const;
 
   private:
     /**
@@ -87,6 +114,8 @@ class Project final
      */
     Domain _domain;
 
+    VersionBlock _domainBlock;
+
     /**
      * Instantiations that have been found so far. This set will only grow over
      * the course of resolution.
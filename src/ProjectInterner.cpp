@@ -0,0 +1,28 @@
+#include "ProjectInterner.h"
+
+#include <cassert>
+#include <limits>
+
+using namespace Arbiter;
+
+ProjectInterner::ID ProjectInterner::intern (const ArbiterProjectIdentifier &project)
+{
+  assert(_projects.size() < std::numeric_limits<ID>::max());
+
+  auto result = _ids.emplace(project, static_cast<ID>(_projects.size()));
+  if (result.second) {
+    _projects.emplace_back(&result.first->first);
+  }
+
+  return result.first->second;
+}
+
+Optional<ProjectInterner::ID> ProjectInterner::find (const ArbiterProjectIdentifier &project) const
+{
+  auto it = _ids.find(project);
+  if (it == _ids.end()) {
+    return None();
+  } else {
+    return makeOptional(it->second);
+  }
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#ifndef __cplusplus
+#error "This file must be compiled as C++."
+#endif
+
+#include "Optional.h"
+#include "Dependency.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Arbiter {
+
+/**
+ * Assigns dense integer IDs to project identifiers, so that state about each
+ * project can be keyed and compared without invoking user hash or equality
+ * callbacks.
+ *
+ * IDs are assigned sequentially from zero, in the order that projects are first
+ * interned, and remain valid for the lifetime of the interner.
+ */
+class ProjectInterner final
+{
+  public:
+    using ID = uint32_t;
+
+    ProjectInterner () = default;
+
+    // `_projects` points into `_ids`, which would not be valid for a copy.
+    ProjectInterner (const ProjectInterner &) = delete;
+    ProjectInterner &operator= (const ProjectInterner &) = delete;
+
+    /**
+     * Returns the ID for the given project, assigning a new one if the project
+     * has not been seen before.
+     */
+    ID intern (const ArbiterProjectIdentifier &project);
+
+    /**
+     * Returns the ID for the given project, or None if it has not been
+     * interned.
+     */
+    Optional<ID> find (const ArbiterProjectIdentifier &project) const;
+
+    /**
+     * Returns the project identifier that the given ID was assigned to.
+     *
+     * The returned reference remains valid for the lifetime of the interner.
+     */
+    const ArbiterProjectIdentifier &project (ID id) const noexcept
+    {
+      return *_projects[id];
+    }
+
+    /**
+     * Orders IDs by the project identifiers they were assigned to.
+     */
+    bool less (ID lhs, ID rhs) const
+    {
+      return project(lhs) < project(rhs);
+    }
+
+    size_t size () const noexcept
+    {
+      return _projects.size();
+    }
+
+  private:
+    std::unordered_map<ArbiterProjectIdentifier, ID> _ids;
+    std::vector<const ArbiterProjectIdentifier *> _projects;
+};
+
+} // namespace Arbiter
@@ -2,7 +2,9 @@
 
 #include "Hash.h"
 #include "Instantiation.h"
+#include "PredicateCache.h"
 #include "ToString.h"
+#include "VersionBlock.h"
 
 #include <algorithm>
 #include <limits>
@@ -278,6 +280,21 @@ std::unique_ptr<ArbiterRequirement> intersectRight(const Left &lhs, const Arbite
   }
 }
 
+/**
+ * Fills `mask` with the versions in `block` which have greater or equal
+ * precedence to `base`.
+ */
+void maskAtLeast (const VersionBlock &block, const VersionBlockComparison &comparison, const ArbiterSemanticVersion &base, uint64_t *mask)
+{
+  std::copy(comparison._atLeast.begin(), comparison._atLeast.end(), mask);
+
+  forEachSetBit(comparison._undecided.data(), block.wordCount(), [&](size_t index) {
+    if (*block.version(index)._semanticVersion >= base) {
+      maskSet(mask, index);
+    }
+  });
+}
+
 } // namespace
 
 std::ostream &Any::describe (std::ostream &os) const
@@ -285,11 +302,21 @@ std::ostream &Any::describe (std::ostream &os) const
   return os << "(any version)";
 }
 
+void Any::satisfiedByEach (const VersionBlock &block, uint64_t *mask, PredicateCache *) const
+{
+  block.fillMask(mask);
+}
+
 bool AtLeast::satisfiedBy (const ArbiterSemanticVersion &version) const noexcept
 {
   return version >= _minimumVersion;
 }
 
+void AtLeast::satisfiedByEach (const VersionBlock &block, uint64_t *mask, PredicateCache *) const
+{
+  maskAtLeast(block, VersionBlockComparison(block, _minimumVersion), _minimumVersion, mask);
+}
+
 bool AtLeast::operator== (const Base &other) const
 {
   if (auto *ptr = dynamic_cast<const AtLeast *>(&other)) {
@@ -342,6 +369,27 @@ bool CompatibleWith::satisfiedBy (const ArbiterSemanticVersion &version) const n
   return version >= _baseVersion;
 }
 
+void CompatibleWith::satisfiedByEach (const VersionBlock &block, uint64_t *mask, PredicateCache *) const
+{
+  VersionBlockComparison comparison(block, _baseVersion);
+  maskAtLeast(block, comparison, _baseVersion, mask);
+
+  // Mirrors the logic of the scalar satisfiedBy() above.
+  for (size_t word = 0; word < block.wordCount(); word++) {
+    uint64_t compatible = comparison._majorEqual[word];
+
+    if (_baseVersion._major == 0) {
+      compatible &= comparison._minorEqual[word];
+
+      if (_strictness == ArbiterRequirementStrictnessStrict) {
+        compatible &= comparison._patchEqual[word];
+      }
+    }
+
+    mask[word] &= compatible;
+  }
+}
+
 bool CompatibleWith::operator== (const Base &other) const
 {
   if (auto *ptr = dynamic_cast<const CompatibleWith *>(&other)) {
@@ -366,6 +414,25 @@ bool Exactly::satisfiedBy (const ArbiterSemanticVersion &version) const noexcept
   return version == _version;
 }
 
+void Exactly::satisfiedByEach (const VersionBlock &block, uint64_t *mask, PredicateCache *) const
+{
+  VersionBlockComparison comparison(block, _version);
+  std::fill(mask, mask + block.wordCount(), 0);
+
+  std::vector<uint64_t> candidates(block.wordCount());
+  for (size_t word = 0; word < block.wordCount(); word++) {
+    candidates[word] = comparison._majorEqual[word] & comparison._minorEqual[word] & comparison._patchEqual[word];
+  }
+
+  // Only versions with identical major, minor, and patch numbers need their
+  // prerelease versions and build metadata checked.
+  forEachSetBit(candidates.data(), block.wordCount(), [&](size_t index) {
+    if (satisfiedBy(*block.version(index)._semanticVersion)) {
+      maskSet(mask, index);
+    }
+  });
+}
+
 bool Exactly::operator== (const Base &other) const
 {
   if (auto *ptr = dynamic_cast<const Exactly *>(&other)) {
@@ -411,13 +478,52 @@ size_t Unversioned::hash () const noexcept
 
 bool Custom::satisfiedBy (const ArbiterSelectedVersion &selectedVersion) const
 {
-  return _predicate(&selectedVersion, _context.get());
+  if (_predicate) {
+    return _predicate(&selectedVersion, _context.get());
+  }
+
+  const ArbiterSelectedVersion *version = &selectedVersion;
+  bool result = false;
+  _batchPredicate(&version, 1, &result, _context.get());
+  return result;
+}
+
+void Custom::satisfiedByEach (const VersionBlock &block, uint64_t *mask, PredicateCache *cache) const
+{
+  PredicateCache::Key key(&block, _predicate, _batchPredicate, _context.get());
+
+  if (cache) {
+    if (const std::vector<uint64_t> *cached = cache->find(key)) {
+      std::copy(cached->begin(), cached->end(), mask);
+      return;
+    }
+  }
+
+  if (_batchPredicate) {
+    std::fill(mask, mask + block.wordCount(), 0);
+
+    // std::vector<bool> cannot provide a bool *.
+    std::unique_ptr<bool[]> results(new bool[block.size()]());
+    _batchPredicate(block.versions(), block.size(), results.get(), _context.get());
+
+    for (size_t i = 0; i < block.size(); i++) {
+      if (results[i]) {
+        maskSet(mask, i);
+      }
+    }
+  } else {
+    ArbiterRequirement::satisfiedByEach(block, mask, cache);
+  }
+
+  if (cache) {
+    cache->insert(std::move(key), std::vector<uint64_t>(mask, mask + block.wordCount()));
+  }
 }
 
 bool Custom::operator== (const Base &other) const
 {
   if (auto *ptr = dynamic_cast<const Custom *>(&other)) {
-    return _predicate == ptr->_predicate && _context == ptr->_context;
+    return _predicate == ptr->_predicate && _batchPredicate == ptr->_batchPredicate && _context == ptr->_context;
   } else {
     return false;
   }
@@ -425,7 +531,7 @@ bool Custom::operator== (const Base &other) const
 
 size_t Custom::hash () const noexcept
 {
-  return hashOf(_predicate) ^ hashOf(_context);
+  return hashOf(_predicate) ^ hashOf(_batchPredicate) ^ hashOf(_context);
 }
 
 bool Compound::satisfiedBy (const ArbiterSelectedVersion &selectedVersion) const
@@ -448,16 +554,37 @@ bool Compound::satisfiedBy (const ArbiterSelectedVersion &selectedVersion) const
   return true;
 }
 
+void Compound::satisfiedByEach (const VersionBlock &block, uint64_t *mask, PredicateCache *cache) const
+{
+  int minimumPriority = priority();
+  block.fillMask(mask);
+
+  std::vector<uint64_t> requirementMask(block.wordCount());
+
+  for (const auto &requirement : _requirements) {
+    // See satisfiedBy() above.
+    if (requirement->priority() > minimumPriority) {
+      continue;
+    }
+
+    requirement->satisfiedByEach(block, requirementMask.data(), cache);
+
+    for (size_t word = 0; word < block.wordCount(); word++) {
+      mask[word] &= requirementMask[word];
+    }
+  }
+}
+
 std::ostream &Compound::describe (std::ostream &os) const
 {
   os << "{ ";
 
   for (auto it = _requirements.begin(); it != _requirements.end(); ++it) {
-    if (it == _requirements.begin()) {
+    if (it != _requirements.begin()) {
       os << " && ";
     }
 
-    os << it->get();
+    os << **it;
   }
 
   return os << " }";
@@ -466,7 +593,9 @@ std::ostream &Compound::describe (std::ostream &os) const
 bool Compound::operator== (const Base &other) const
 {
   if (auto *ptr = dynamic_cast<const Compound *>(&other)) {
-    return _requirements == ptr->_requirements;
+    return std::equal(_requirements.begin(), _requirements.end(), ptr->_requirements.begin(), ptr->_requirements.end(), [](const auto &lhs, const auto &rhs) {
+      return *lhs == *rhs;
+    });
   } else {
     return false;
   }
@@ -508,6 +637,11 @@ bool Prioritized::satisfiedBy (const ArbiterSelectedVersion &selectedVersion) co
   return _requirement->satisfiedBy(selectedVersion);
 }
 
+void Prioritized::satisfiedByEach (const VersionBlock &block, uint64_t *mask, PredicateCache *cache) const
+{
+  _requirement->satisfiedByEach(block, mask, cache);
+}
+
 std::ostream &Prioritized::describe (std::ostream &os) const
 {
   return os << *_requirement << " (priority " << _priority << ")";
@@ -644,11 +778,21 @@ ArbiterRequirement *ArbiterCreateRequirementUnversioned (ArbiterUserValue metada
   return new Requirement::Unversioned(Requirement::Unversioned::Metadata(metadata));
 }
 
+ArbiterRequirement *ArbiterCreateRequirementUnversionedWithString (const char *metadata, size_t length)
+{
+  return new Requirement::Unversioned(Requirement::Unversioned::Metadata(std::string(metadata, length)));
+}
+
 ArbiterRequirement *ArbiterCreateRequirementCustom (ArbiterRequirementPredicate predicate, ArbiterUserContext context)
 {
   return new Requirement::Custom(std::move(predicate), shareUserContext(context));
 }
 
+ArbiterRequirement *ArbiterCreateRequirementCustomBatch (ArbiterRequirementPredicate predicate, ArbiterRequirementBatchPredicate batchPredicate, ArbiterUserContext context)
+{
+  return new Requirement::Custom(std::move(predicate), std::move(batchPredicate), shareUserContext(context));
+}
+
 ArbiterRequirement *ArbiterCreateRequirementCompound (const ArbiterRequirement * const *requirements, size_t count)
 {
   std::vector<std::shared_ptr<ArbiterRequirement>> vec;
@@ -671,11 +815,56 @@ bool ArbiterRequirementSatisfiedBy (const ArbiterRequirement *requirement, const
   return requirement->satisfiedBy(*version);
 }
 
+void ArbiterRequirementSatisfiedByEach (const ArbiterRequirement *requirement, const ArbiterSelectedVersionList *versions, uint64_t *bitmask)
+{
+  VersionBlock block(versions->_versions.begin(), versions->_versions.end());
+  requirement->satisfiedByEach(block, bitmask, nullptr);
+}
+
+namespace {
+
+AtomicMemoryCounter &requirementMemoryCounter () noexcept
+{
+  static AtomicMemoryCounter counter;
+  return counter;
+}
+
+} // namespace
+
+void *ArbiterRequirement::operator new (size_t size)
+{
+  void *ptr = ::operator new(size);
+  requirementMemoryCounter().allocated(size);
+  return ptr;
+}
+
+void ArbiterRequirement::operator delete (void *ptr, size_t size) noexcept
+{
+  requirementMemoryCounter().deallocated(size);
+  ::operator delete(ptr);
+}
+
+const AtomicMemoryCounter &ArbiterRequirement::memoryCounter () noexcept
+{
+  return requirementMemoryCounter();
+}
+
 std::unique_ptr<ArbiterRequirement> ArbiterRequirement::cloneRequirement () const
 {
   return std::unique_ptr<ArbiterRequirement>(dynamic_cast<ArbiterRequirement *>(clone().release()));
 }
 
+void ArbiterRequirement::satisfiedByEach (const VersionBlock &block, uint64_t *mask, PredicateCache *) const
+{
+  std::fill(mask, mask + block.wordCount(), 0);
+
+  for (size_t i = 0; i < block.size(); i++) {
+    if (satisfiedBy(block.version(i))) {
+      maskSet(mask, i);
+    }
+  }
+}
+
 void ArbiterRequirement::visit (Requirement::Visitor &visitor) const
 {
   visitor(*this);
@@ -6,10 +6,12 @@
 
 #include <arbiter/Requirement.h>
 
+#include "Memory.h"
 #include "Types.h"
 #include "Version.h"
 
 #include <cassert>
+#include <cstdint>
 #include <memory>
 #include <ostream>
 
@@ -24,6 +26,8 @@ class Visitor;
 namespace Arbiter {
 
 class Instantiation;
+class PredicateCache;
+class VersionBlock;
 
 } // namespace Arbiter
 
@@ -36,6 +40,20 @@ struct ArbiterRequirement : public Arbiter::Base
      */
     virtual bool satisfiedBy (const ArbiterSelectedVersion &selectedVersion) const = 0;
 
+    /**
+     * Determines which versions in the given block would satisfy this
+     * requirement, setting the corresponding bit in `mask` for each one.
+     *
+     * `mask` must have room for `block.wordCount()` words, and will be
+     * completely overwritten.
+     *
+     * If `cache` is not null, it will be used to look up and store the results
+     * of evaluating custom predicates against `block`.
+     *
+     * The default implementation invokes satisfiedBy() once per version.
+     */
+    virtual void satisfiedByEach (const Arbiter::VersionBlock &block, uint64_t *mask, Arbiter::PredicateCache *cache) const;
+
     /**
      * Returns the priority of this requirement.
      */
@@ -66,6 +84,18 @@ struct ArbiterRequirement : public Arbiter::Base
 
     std::unique_ptr<ArbiterRequirement> cloneRequirement () const;
     virtual size_t hash () const noexcept = 0;
+
+    /**
+     * Requirements are allocated individually, so they are counted here rather
+     * than by the containers which hold them.
+     */
+    static void *operator new (size_t size);
+    static void operator delete (void *ptr, size_t size) noexcept;
+
+    /**
+     * Counts the memory used by every requirement in the process.
+     */
+    static const Arbiter::AtomicMemoryCounter &memoryCounter () noexcept;
 };
 
 namespace Arbiter {
@@ -98,6 +128,8 @@ class Any final : public ArbiterRequirement
       return true;
     }
 
+    void satisfiedByEach (const VersionBlock &block, uint64_t *mask, PredicateCache *cache) const override;
+
     bool operator== (const Arbiter::Base &other) const override
     {
       return (bool)dynamic_cast<const Any *>(&other);
@@ -145,6 +177,7 @@ class AtLeast final : public ArbiterRequirement
     }
 
     bool satisfiedBy (const ArbiterSemanticVersion &version) const noexcept;
+    void satisfiedByEach (const VersionBlock &block, uint64_t *mask, PredicateCache *cache) const override;
     std::ostream &describe (std::ostream &os) const override;
     bool operator== (const Arbiter::Base &other) const override;
     std::unique_ptr<ArbiterRequirement> intersect (const ArbiterRequirement &rhs) const override;
@@ -181,6 +214,7 @@ class CompatibleWith final : public ArbiterRequirement
     }
 
     bool satisfiedBy (const ArbiterSemanticVersion &version) const noexcept;
+    void satisfiedByEach (const VersionBlock &block, uint64_t *mask, PredicateCache *cache) const override;
     std::ostream &describe (std::ostream &os) const override;
     bool operator== (const Arbiter::Base &other) const override;
     std::unique_ptr<ArbiterRequirement> intersect (const ArbiterRequirement &rhs) const override;
@@ -214,6 +248,7 @@ class Exactly final : public ArbiterRequirement
     }
 
     bool satisfiedBy (const ArbiterSemanticVersion &version) const noexcept;
+    void satisfiedByEach (const VersionBlock &block, uint64_t *mask, PredicateCache *cache) const override;
     std::ostream &describe (std::ostream &os) const override;
     bool operator== (const Arbiter::Base &other) const override;
     std::unique_ptr<ArbiterRequirement> intersect (const ArbiterRequirement &rhs) const override;
@@ -249,10 +284,15 @@ class Custom final : public ArbiterRequirement
 {
   public:
     explicit Custom (ArbiterRequirementPredicate predicate, std::shared_ptr<const void> context)
+      : Custom(std::move(predicate), nullptr, std::move(context))
+    {}
+
+    explicit Custom (ArbiterRequirementPredicate predicate, ArbiterRequirementBatchPredicate batchPredicate, std::shared_ptr<const void> context)
       : _predicate(std::move(predicate))
+      , _batchPredicate(std::move(batchPredicate))
       , _context(std::move(context))
     {
-      assert(_predicate);
+      assert(_predicate || _batchPredicate);
     }
 
     std::ostream &describe (std::ostream &os) const override
@@ -266,12 +306,20 @@ class Custom final : public ArbiterRequirement
     }
 
     bool satisfiedBy (const ArbiterSelectedVersion &selectedVersion) const override;
+
+    /**
+     * Evaluates the batch predicate, if there is one, with every version in
+     * the block at once.
+     */
+    void satisfiedByEach (const VersionBlock &block, uint64_t *mask, PredicateCache *cache) const override;
+
     std::unique_ptr<ArbiterRequirement> intersect (const ArbiterRequirement &rhs) const override;
     bool operator== (const Arbiter::Base &other) const override;
     size_t hash () const noexcept override;
 
   private:
     ArbiterRequirementPredicate _predicate;
+    ArbiterRequirementBatchPredicate _batchPredicate;
     std::shared_ptr<const void> _context;
 };
 
@@ -296,6 +344,7 @@ class Compound final : public ArbiterRequirement
     int priority () const noexcept override;
 
     bool satisfiedBy (const ArbiterSelectedVersion &selectedVersion) const override;
+    void satisfiedByEach (const VersionBlock &block, uint64_t *mask, PredicateCache *cache) const override;
     std::unique_ptr<ArbiterRequirement> intersect (const ArbiterRequirement &rhs) const override;
     std::ostream &describe (std::ostream &os) const override;
     bool operator== (const Arbiter::Base &other) const override;
@@ -324,6 +373,7 @@ class Prioritized final : public ArbiterRequirement
     }
 
     bool satisfiedBy (const ArbiterSelectedVersion &selectedVersion) const override;
+    void satisfiedByEach (const VersionBlock &block, uint64_t *mask, PredicateCache *cache) const override;
     std::unique_ptr<ArbiterRequirement> intersect (const ArbiterRequirement &rhs) const override;
     std::ostream &describe (std::ostream &os) const override;
     bool operator== (const Arbiter::Base &other) const override;
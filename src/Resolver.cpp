@@ -1,128 +1,281 @@
 #include "Resolver.h"
 
-#include "Algorithm.h"
+#include "Arena.h"
 #include "Exception.h"
 #include "Iterator.h"
 #include "Optional.h"
 #include "Requirement.h"
 #include "Stats.h"
 #include "ToString.h"
+#include "Trace.h"
+#include "VersionBlock.h"
 
 #include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <exception>
-#include <map>
-#include <set>
+#include <functional>
+#include <unordered_map>
 #include <unordered_set>
 
 using namespace Arbiter;
 
 namespace {
 
-struct UniqueDependencyHash final
+using ProjectID = ArbiterResolver::ProjectID;
+
+template<typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+template<typename Key, typename Value>
+using ArenaMap = std::unordered_map<Key, Value, std::hash<Key>, std::equal_to<Key>, ArenaAllocator<std::pair<const Key, Value>>>;
+
+/**
+ * A dependency graph under construction, keyed by interned project IDs.
+ *
+ * This mirrors ArbiterResolvedDependencyGraph, but avoids hashing and comparing
+ * project identifiers while candidate graphs are copied and extended. Its
+ * storage is allocated from the resolver's arena, and its nodes refer to
+ * versions and requirements owned elsewhere, so a candidate graph must not
+ * outlive the resolution that created it.
+ */
+class CandidateGraph final
 {
   public:
-    size_t operator() (const ArbiterDependency &dependency) const
+    struct Node final
     {
-      return hashOf(dependency._projectIdentifier);
+      public:
+        const ArbiterSelectedVersion *_version;
+
+        // Usually borrowed from a dependency list, unless the requirement was
+        // created by unifying several.
+        std::shared_ptr<const ArbiterRequirement> _requirement;
+    };
+
+    /**
+     * Creates a candidate graph from an existing dependency graph, interning
+     * each of its projects.
+     */
+    CandidateGraph (const ArbiterResolvedDependencyGraph &graph, ProjectInterner &interner, Arena &arena, MemoryCounter *counter)
+      : _nodes(graph.nodes().size(), ArenaAllocator<NodeMap::value_type>(arena, counter))
+      , _edges(ArenaAllocator<EdgeMap::value_type>(arena, counter))
+    {
+      for (const auto &pair : graph.nodes()) {
+        _nodes.emplace(interner.intern(pair.first), Node{ &pair.second._version, borrow(pair.second.requirement()) });
+      }
+
+      for (const auto &pair : graph.edges()) {
+        ProjectID dependent = interner.intern(pair.first);
+
+        for (const ArbiterProjectIdentifier &dependency : pair.second) {
+          addEdge(dependent, interner.intern(dependency));
+        }
+      }
     }
-};
 
-struct UniqueDependencyEqualTo final
-{
-  public:
-    bool operator() (const ArbiterDependency &lhs, const ArbiterDependency &rhs) const
+    /**
+     * Attempts to add the given node into the graph, with the same semantics as
+     * ArbiterResolvedDependencyGraph::addNode().
+     *
+     * `version` and `requirement` must remain valid for the lifetime of the
+     * graph.
+     */
+    void addNode (ProjectID project, const ArbiterSelectedVersion &version, const ArbiterRequirement &requirement) noexcept(false)
+    {
+      assert(requirement.satisfiedBy(version));
+
+      const auto it = _nodes.find(project);
+      if (it != _nodes.end()) {
+        Node &node = it->second;
+        node._requirement = ArbiterResolvedDependencyGraph::unifyRequirements(*node._version, *node._requirement, requirement);
+      } else {
+        _nodes.emplace(project, Node{ &version, borrow(requirement) });
+      }
+    }
+
+    bool contains (ProjectID project) const
     {
-      return lhs._projectIdentifier == rhs._projectIdentifier;
+      return _nodes.find(project) != _nodes.end();
+    }
+
+    size_t size () const noexcept
+    {
+      return _nodes.size();
+    }
+
+    /**
+     * Adds an edge from a dependent to its dependency.
+     */
+    void addEdge (ProjectID dependent, ProjectID dependency)
+    {
+      assert(_nodes.find(dependent) != _nodes.end());
+      assert(_nodes.find(dependency) != _nodes.end());
+
+      auto it = _edges.find(dependent);
+      if (it == _edges.end()) {
+        it = _edges.emplace(dependent, ArenaVector<ProjectID>(_edges.get_allocator())).first;
+      }
+
+      // Dependencies are kept sorted, without duplicates.
+      ArenaVector<ProjectID> &dependencies = it->second;
+      auto position = std::lower_bound(dependencies.begin(), dependencies.end(), dependency);
+      if (position == dependencies.end() || *position != dependency) {
+        dependencies.insert(position, dependency);
+      }
+    }
+
+    /**
+     * Converts this graph into public types, which are independent of the
+     * resolution.
+     */
+    ArbiterResolvedDependencyGraph toGraph (const ProjectInterner &interner) const
+    {
+      ArbiterResolvedDependencyGraph graph;
+
+      for (const auto &pair : _nodes) {
+        graph.addNode(ArbiterResolvedDependency(interner.project(pair.first), *pair.second._version), *pair.second._requirement);
+      }
+
+      for (const auto &pair : _edges) {
+        const ArbiterProjectIdentifier &dependent = interner.project(pair.first);
+
+        for (ProjectID dependency : pair.second) {
+          graph.addEdge(dependent, interner.project(dependency));
+        }
+      }
+
+      return graph;
+    }
+
+  private:
+    using NodeMap = ArenaMap<ProjectID, Node>;
+    using EdgeMap = ArenaMap<ProjectID, ArenaVector<ProjectID>>;
+
+    NodeMap _nodes;
+    EdgeMap _edges;
+
+    static std::shared_ptr<const ArbiterRequirement> borrow (const ArbiterRequirement &requirement) noexcept
+    {
+      // An empty owner makes copies free of reference counting.
+      return std::shared_ptr<const ArbiterRequirement>(std::shared_ptr<const ArbiterRequirement>(), &requirement);
     }
 };
 
 /**
- * Contains dependencies in a set where project identifier alone determines
- * uniqueness (i.e., any requirement is ignored).
+ * Dependencies awaiting resolution, where project alone determines uniqueness
+ * (i.e., any requirement is ignored, and the first dependency added for each
+ * project wins).
  */
-using UniqueDependencySet = std::unordered_set<ArbiterDependency, UniqueDependencyHash, UniqueDependencyEqualTo>;
+using UniqueDependencyMap = ArenaMap<ProjectID, const ArbiterDependency *>;
 
-ArbiterResolvedDependencyGraph resolveDependencies (ArbiterResolver &resolver, const ArbiterResolvedDependencyGraph &baseGraph, UniqueDependencySet dependencySet, const std::unordered_map<ArbiterProjectIdentifier, std::vector<ArbiterProjectIdentifier>> &dependentsByProject = {}) noexcept(false)
+using DependentsMap = ArenaMap<ProjectID, ArenaVector<ProjectID>>;
+
+/**
+ * The versions of one project which are being permuted, along with the
+ * requirement they were chosen to satisfy.
+ */
+struct Possibilities final
 {
-  if (dependencySet.empty()) {
-    return baseGraph;
-  }
+  public:
+    ProjectID _project;
+    const ArbiterRequirement *_requirement;
+    ArbiterResolver::SatisfyingVersions _versions;
+};
 
-  // This collection is reused when actually building the new dependency graph
-  // below.
-  std::unordered_map<ArbiterProjectIdentifier, std::unique_ptr<ArbiterRequirement>> requirementsByProject;
-  requirementsByProject.reserve(dependencySet.size());
+ArbiterResolvedDependencyGraph resolveDependencies (ArbiterResolver &resolver, const CandidateGraph &baseGraph, const UniqueDependencyMap &dependencyMap, const DependentsMap *dependentsByProject = nullptr, unsigned depth = 1) noexcept(false);
 
-  for (const ArbiterDependency &dependency : dependencySet) {
-    requirementsByProject[dependency._projectIdentifier] = dependency.requirement().cloneRequirement();
-  }
+ArbiterResolvedDependencyGraph resolveLevel (ArbiterResolver &resolver, const CandidateGraph &baseGraph, const UniqueDependencyMap &dependencyMap, const DependentsMap *dependentsByProject, unsigned depth) noexcept(false)
+{
+  const ProjectInterner &interner = resolver._interner;
 
-  assert(requirementsByProject.size() == dependencySet.size());
+  if (dependencyMap.empty()) {
+    // Convert the graph while every level of resolution is still alive, since
+    // its nodes refer to their versions.
+    return baseGraph.toGraph(interner);
+  }
 
-  // Free the dependencySet, as it will no longer be used.
-  reset(dependencySet);
+  Arena &arena = resolver._arena;
+  MemoryCounter *searchState = &resolver._memory._searchState;
+  Stats &stats = resolver._latestStats;
 
-  // This collection needs to exist for as long as the permuted iterators do below.
-  //
-  // It's important that this collection is ordered deterministically, since it
-  // affects which permutations we try first.
-  std::map<ArbiterProjectIdentifier, std::vector<ArbiterResolvedDependency>> possibilities;
+  stats._maxDepth = std::max(stats._maxDepth, depth);
 
-  for (const auto &pair : requirementsByProject) {
-    const ArbiterProjectIdentifier &project = pair.first;
-    const ArbiterRequirement &requirement = *pair.second;
+  TraceScope levelScope(resolver._tracer, ArbiterTraceEventKindResolveLevel);
 
-    std::vector<ArbiterSelectedVersion> versions = resolver.availableVersionsSatisfying(project, requirement);
-    if (versions.empty()) {
-      throw Exception::UnsatisfiableConstraints("Cannot satisfy " + toString(requirement) + " from available versions of " + toString(project));
-    }
+  // This collection needs to exist for as long as the permuted iterators and
+  // the graphs built from them do below.
+  ArenaVector<Possibilities> possibilities((ArenaAllocator<Possibilities>(arena, searchState)));
+  possibilities.reserve(dependencyMap.size());
 
-    // Sort the version list with highest precedence first, so we try the newest
-    // possible versions first.
-    std::sort(versions.begin(), versions.end(), std::greater<ArbiterSelectedVersion>());
+  size_t candidateCount = 0;
 
-    std::vector<ArbiterResolvedDependency> resolutions;
-    resolutions.reserve(versions.size());
+  for (const auto &pair : dependencyMap) {
+    ProjectID project = pair.first;
+    const ArbiterRequirement &requirement = pair.second->requirement();
 
-    for (ArbiterSelectedVersion &version : versions) {
-      resolutions.emplace_back(project, std::move(version));
+    // The versions are ordered with highest precedence first, so we try the
+    // newest possible versions first.
+    auto versions = resolver.availableVersionsSatisfying(project, requirement);
+    if (versions._versions.empty()) {
+      throw Exception::UnsatisfiableConstraints("Cannot satisfy " + toString(requirement) + " from available versions of " + toString(interner.project(project)));
     }
 
-    possibilities[project] = std::move(resolutions);
+    candidateCount += versions._versions.size();
+    possibilities.emplace_back(Possibilities{ project, &requirement, std::move(versions) });
   }
 
-  assert(possibilities.size() == requirementsByProject.size());
+  stats._peakCandidates = std::max(stats._peakCandidates, candidateCount);
+
+  // It's important that this collection is ordered deterministically, since it
+  // affects which permutations we try first.
+  std::sort(possibilities.begin(), possibilities.end(), [&interner](const Possibilities &lhs, const Possibilities &rhs) {
+    return interner.less(lhs._project, rhs._project);
+  });
 
-  using Iterator = std::vector<ArbiterResolvedDependency>::const_iterator;
+  using Iterator = decltype(ArbiterResolver::SatisfyingVersions::_versions)::const_iterator;
 
   std::vector<IteratorRange<Iterator>> ranges;
-  for (const auto &pair : possibilities) {
-    const std::vector<ArbiterResolvedDependency> &dependencies = pair.second;
-    ranges.emplace_back(dependencies.cbegin(), dependencies.cend());
-  }
+  ranges.reserve(possibilities.size());
 
-  assert(ranges.size() == possibilities.size());
+  for (const Possibilities &possibility : possibilities) {
+    ranges.emplace_back(possibility._versions._versions.cbegin(), possibility._versions._versions.cend());
+  }
 
-  std::exception_ptr lastException = std::make_exception_ptr(Exception::UnsatisfiableConstraints("No further combinations to attempt"));
+  std::exception_ptr lastException;
 
   for (PermutationIterator<Iterator> permuter(std::move(ranges)); permuter; ++permuter) {
+    // Everything allocated while trying this permutation is released in bulk
+    // if it fails.
+    const Arena::Mark mark = arena.mark();
+    ++stats._permutationsAttempted;
+
+    if (resolver._limits) {
+      resolver._limits.check(stats, depth);
+    }
+
     try {
-      std::vector<ArbiterResolvedDependency> choices = *permuter;
+      TraceScope permutationScope(resolver._tracer, ArbiterTraceEventKindPermutation);
 
-      ArbiterResolvedDependencyGraph candidate = baseGraph;
+      CandidateGraph candidate = baseGraph;
+      ++stats._graphCopies;
 
       // Add everything to the graph first, to throw any exceptions that would
       // occur before we perform the computation- and memory-expensive stuff for
       // transitive dependencies.
-      for (ArbiterResolvedDependency &dependency : choices) {
-        const ArbiterRequirement &requirement = *requirementsByProject.at(dependency._project);
-        candidate.addNode(dependency, requirement);
-
-        auto dependents = maybeAt(dependentsByProject, dependency._project);
-        if (dependents) {
-          for (const ArbiterProjectIdentifier &dependent : *dependents) {
-            candidate.addEdge(dependent, dependency._project);
+      for (size_t i = 0; i < possibilities.size(); i++) {
+        const Possibilities &possibility = possibilities[i];
+        if (candidate.contains(possibility._project)) {
+          ++stats._requirementIntersections;
+        }
+
+        candidate.addNode(possibility._project, *permuter.current(i), *possibility._requirement);
+
+        if (dependentsByProject) {
+          auto it = dependentsByProject->find(possibility._project);
+          if (it != dependentsByProject->end()) {
+            for (ProjectID dependent : it->second) {
+              candidate.addEdge(dependent, possibility._project);
+            }
           }
         }
       }
@@ -130,30 +283,62 @@ ArbiterResolvedDependencyGraph resolveDependencies (ArbiterResolver &resolver, c
       // Collect immediate children for the next phase of dependency resolution,
       // so we can permute their versions as a group (for something
       // approximating breadth-first search).
-      UniqueDependencySet collectedTransitives;
-      std::unordered_map<ArbiterProjectIdentifier, std::vector<ArbiterProjectIdentifier>> dependentsByTransitive;
+      UniqueDependencyMap collectedTransitives((ArenaAllocator<UniqueDependencyMap::value_type>(arena, searchState)));
+      DependentsMap dependentsByTransitive((ArenaAllocator<DependentsMap::value_type>(arena, searchState)));
 
-      for (ArbiterResolvedDependency &dependency : choices) {
-        const auto &transitives = resolver.fetchDependencies(dependency._project, dependency._version);
+      for (size_t i = 0; i < possibilities.size(); i++) {
+        ProjectID project = possibilities[i]._project;
+        const auto &transitives = resolver.fetchDependencies(project, *permuter.current(i));
 
-        dependentsByTransitive.reserve(dependentsByTransitive.size() + transitives.size());
-        for (const ArbiterDependency &transitive : transitives) {
-          dependentsByTransitive[transitive._projectIdentifier].emplace_back(dependency._project);
-        }
+        for (const ArbiterResolver::InternedDependency &transitive : transitives) {
+          auto it = dependentsByTransitive.find(transitive._project);
+          if (it == dependentsByTransitive.end()) {
+            it = dependentsByTransitive.emplace(transitive._project, ArenaVector<ProjectID>(dependentsByTransitive.get_allocator())).first;
+          }
 
-        collectedTransitives.insert(transitives.begin(), transitives.end());
+          it->second.emplace_back(project);
+          collectedTransitives.emplace(transitive._project, transitive._dependency);
+        }
       }
 
-      reset(choices);
-
-      return resolveDependencies(resolver, candidate, std::move(collectedTransitives), std::move(dependentsByTransitive));
+      return resolveDependencies(resolver, candidate, collectedTransitives, &dependentsByTransitive, depth + 1);
+    } catch (Arbiter::Exception::Cancelled &) {
+      // Cancellation is not a dead end, so don't try anything else.
+      throw;
     } catch (Arbiter::Exception::Base &ex) {
       lastException = std::current_exception();
-      ++resolver._latestStats._deadEnds;
+      ++stats._deadEnds;
+
+      if (resolver._tracer) {
+        resolver._tracer.emit(ArbiterTraceEventKindConflict, ArbiterTraceEventPhaseInstant, nullptr, ex.what());
+      }
     }
+
+    // The candidate and everything built from it were destroyed upon leaving
+    // the try block.
+    arena.rewind(mark);
   }
 
-  std::rethrow_exception(lastException);
+  if (lastException) {
+    std::rethrow_exception(lastException);
+  } else {
+    throw Exception::UnsatisfiableConstraints("No further combinations to attempt");
+  }
+}
+
+ArbiterResolvedDependencyGraph resolveDependencies (ArbiterResolver &resolver, const CandidateGraph &baseGraph, const UniqueDependencyMap &dependencyMap, const DependentsMap *dependentsByProject, unsigned depth) noexcept(false)
+{
+  try {
+    return resolveLevel(resolver, baseGraph, dependencyMap, dependentsByProject, depth);
+  } catch (Arbiter::Exception::Cancelled &) {
+    // Cancellation unwinds from the deepest level first, which has the most
+    // complete graph, so only that one needs converting.
+    if (!resolver._partialGraph) {
+      resolver._partialGraph = baseGraph.toGraph(resolver._interner);
+    }
+
+    throw;
+  }
 }
 
 class UnversionedRequirementVisitor final : public Requirement::Visitor
@@ -198,61 +383,261 @@ ArbiterResolvedDependencyGraph *ArbiterResolverCreateResolvedDependencyGraph (Ar
   return new ArbiterResolvedDependencyGraph(std::move(*dependencies));
 }
 
+ArbiterDependencyList *ArbiterResolverCreateUnsatisfiedDependencyList (ArbiterResolver *resolver, char **error)
+{
+  Optional<ArbiterDependencyList> unsatisfied;
+
+  try {
+    unsatisfied = resolver->unsatisfiedDependencies();
+  } catch (const std::exception &ex) {
+    if (error) {
+      *error = copyCString(ex.what()).release();
+    }
+
+    return nullptr;
+  }
+
+  return new ArbiterDependencyList(std::move(*unsatisfied));
+}
+
+namespace {
+
+ArbiterMemoryUsage copyMemoryUsage (const Stats::MemoryUsage &usage)
+{
+  return ArbiterMemoryUsage{ usage._current, usage._peak };
+}
+
+template<typename Counter>
+Stats::MemoryUsage memoryUsage (const Counter &counter)
+{
+  Stats::MemoryUsage usage;
+  usage._current = counter.current();
+  usage._peak = counter.peak();
+  return usage;
+}
+
+} // namespace
+
+bool ArbiterResolverCopyStatistics (const ArbiterResolver *resolver, ArbiterResolverStatistics *statistics, size_t structSize)
+{
+  const Stats &stats = resolver->_latestStats;
+  if (!stats._endTime) {
+    return false;
+  }
+
+  using Seconds = std::chrono::duration<double>;
+
+  ArbiterResolverStatistics result;
+  result.durationSeconds = std::chrono::duration_cast<Seconds>(stats.duration()).count();
+  result.behaviorSeconds = std::chrono::duration_cast<Seconds>(stats._behaviorDuration).count();
+  result.availableVersionFetches = stats._availableVersionFetches;
+  result.dependencyListFetches = stats._dependencyListFetches;
+  result.selectedVersionForMetadataFetches = stats._selectedVersionForMetadataFetches;
+  result.availableVersionCacheHits = stats._availableVersionCacheHits;
+  result.dependencyListCacheHits = stats._dependencyListCacheHits;
+  result.predicateCacheHits = stats._predicateCacheHits;
+  result.predicateCacheMisses = stats._predicateCacheMisses;
+  result.permutationsAttempted = stats._permutationsAttempted;
+  result.deadEnds = stats._deadEnds;
+  result.graphCopies = stats._graphCopies;
+  result.requirementIntersections = stats._requirementIntersections;
+  result.maxDepth = stats._maxDepth;
+  result.peakCandidates = stats._peakCandidates;
+  result.availableVersionsMemory = copyMemoryUsage(stats._availableVersionsMemory);
+  result.dependencyListsMemory = copyMemoryUsage(stats._dependencyListsMemory);
+  result.candidateGraphMemory = copyMemoryUsage(stats._candidateGraphMemory);
+  result.searchStateMemory = copyMemoryUsage(stats._searchStateMemory);
+  result.requirementMemory = copyMemoryUsage(stats._requirementMemory);
+  result.arenaReservedBytes = stats._arenaReservedBytes;
+  result.resultCacheHits = stats._resultCacheHits;
+
+  std::memcpy(statistics, &result, std::min(structSize, sizeof(result)));
+  return true;
+}
+
+void ArbiterResolverSetResultCache (ArbiterResolver *resolver, const ArbiterResultCache *cache, const void *registryEpoch, size_t epochLength)
+{
+  std::string epoch;
+  if (registryEpoch) {
+    epoch.assign(static_cast<const char *>(registryEpoch), epochLength);
+  }
+
+  resolver->setResultCache(cache, epoch);
+}
+
+void ArbiterResolverSetLimits (ArbiterResolver *resolver, const ArbiterResolverLimits *limits, ArbiterUserContext context)
+{
+  if (limits) {
+    resolver->_limits = ResolverLimits(*limits, shareUserContext(context));
+  } else {
+    resolver->_limits = ResolverLimits();
+  }
+}
+
+ArbiterResolverCancellation ArbiterResolverGetCancellation (const ArbiterResolver *resolver)
+{
+  return resolver->_limits.cancellation();
+}
+
+ArbiterResolvedDependencyGraph *ArbiterResolverCreatePartialDependencyGraph (const ArbiterResolver *resolver)
+{
+  if (resolver->_limits.cancellation() == ArbiterResolverCancellationNone || !resolver->_partialGraph) {
+    return nullptr;
+  }
+
+  return new ArbiterResolvedDependencyGraph(*resolver->_partialGraph);
+}
+
+void ArbiterResolverSetTraceFunction (ArbiterResolver *resolver, ArbiterTraceFunction function, ArbiterUserContext context)
+{
+  resolver->setTraceFunction(function, shareUserContext(context));
+}
+
+bool ArbiterResolverSetTraceFile (ArbiterResolver *resolver, const char *path, char **error)
+{
+  try {
+    resolver->setTraceFile(path);
+    return true;
+  } catch (const std::exception &ex) {
+    if (error) {
+      *error = copyCString(ex.what()).release();
+    }
+
+    return false;
+  }
+}
+
 void ArbiterFreeResolver (ArbiterResolver *resolver)
 {
   delete resolver;
 }
 
-const Arbiter::Instantiation::Dependencies &ArbiterResolver::fetchDependencies (const ArbiterProjectIdentifier &projectIdentifier, const ArbiterSelectedVersion &version) noexcept(false)
+const ArbiterResolver::InternedDependencies &ArbiterResolver::fetchDependencies (ProjectID projectID, const ArbiterSelectedVersion &version) noexcept(false)
 {
   // This project should already be present, as its domain must have been known
   // to obtain `version`.
-  Project &project = _projects.at(projectIdentifier);
+  assert(projectID < _projects.size() && _projects[projectID]);
+  Project &project = *_projects[projectID];
 
-  if (auto inst = project.instantiationForVersion(version)) {
-    return inst->dependencies();
+  std::shared_ptr<Instantiation> instantiation = project.instantiationForVersion(version);
+  if (instantiation) {
+    ++_latestStats._dependencyListCacheHits;
+  } else {
+    std::unique_ptr<ArbiterDependencyList> dependencyList = fetchDependencyList(_interner.project(projectID), version);
+    instantiation = project.addInstantiation(version, std::move(*dependencyList));
   }
 
+  auto it = _internedDependencies.find(instantiation.get());
+  if (it == _internedDependencies.end()) {
+    InternedDependencies dependencies((InternedDependencies::allocator_type(&_memory._dependencyLists)));
+    dependencies.reserve(instantiation->dependencies().size());
+
+    for (const ArbiterDependency &dependency : instantiation->dependencies()) {
+      dependencies.emplace_back(InternedDependency{ _interner.intern(dependency._projectIdentifier), &dependency });
+    }
+
+    it = _internedDependencies.emplace(instantiation.get(), std::move(dependencies)).first;
+  }
+
+  return it->second;
+}
+
+std::unique_ptr<ArbiterDependencyList> ArbiterResolver::fetchDependencyList (const ArbiterProjectIdentifier &project, const ArbiterSelectedVersion &version) noexcept(false)
+{
   char *error = nullptr;
-  std::unique_ptr<ArbiterDependencyList> dependencyList(_behaviors.createDependencyList(this, &projectIdentifier, &version, &error));
+  const auto start = Stats::Clock::now();
+
+  std::unique_ptr<ArbiterDependencyList> dependencyList;
+  {
+    TraceScope scope(_tracer, ArbiterTraceEventKindFetchDependencyList, &project);
+    dependencyList.reset(_behaviors.createDependencyList(this, &project, &version, &error));
+  }
+
+  // Take ownership before anything else can throw.
+  auto ownedError = acquireCString(error);
 
+  _latestStats._behaviorDuration += Stats::Clock::now() - start;
   ++_latestStats._dependencyListFetches;
 
-  if (dependencyList) {
-    assert(!error);
+  if (_limits) {
+    _limits.check(_latestStats);
+  }
 
-    return project.addInstantiation(version, std::move(*dependencyList))->dependencies();
-  } else if (error) {
-    throw Exception::UserError(copyAcquireCString(error));
+  if (dependencyList) {
+    assert(!ownedError);
+    return dependencyList;
+  } else if (ownedError) {
+    throw Exception::UserError(ownedError.get());
   } else {
     throw Exception::UserError();
   }
 }
 
-const Arbiter::Project::Domain &ArbiterResolver::fetchAvailableVersions (const ArbiterProjectIdentifier &projectIdentifier) noexcept(false)
+const Arbiter::Project::Domain &ArbiterResolver::fetchAvailableVersions (ProjectID project) noexcept(false)
+{
+  return fetchProject(project).domain();
+}
+
+const Project &ArbiterResolver::fetchProject (ProjectID projectID) noexcept(false)
 {
-  auto it = _projects.find(projectIdentifier);
-  if (it == _projects.end()) {
+  if (projectID >= _projects.size()) {
+    _projects.resize(_interner.size());
+  }
+
+  std::unique_ptr<Project> &project = _projects[projectID];
+  if (project) {
+    ++_latestStats._availableVersionCacheHits;
+  } else {
+    const ArbiterProjectIdentifier &projectIdentifier = _interner.project(projectID);
+
     char *error = nullptr;
-    std::unique_ptr<ArbiterSelectedVersionList> versionList(_behaviors.createAvailableVersionsList(this, &projectIdentifier, &error));
+    const auto start = Stats::Clock::now();
+
+    std::unique_ptr<ArbiterSelectedVersionList> versionList;
+    {
+      TraceScope scope(_tracer, ArbiterTraceEventKindFetchAvailableVersions, &projectIdentifier);
+      versionList.reset(_behaviors.createAvailableVersionsList(this, &projectIdentifier, &error));
+    }
 
+    // Take ownership before anything else can throw.
+    auto ownedError = acquireCString(error);
+
+    _latestStats._behaviorDuration += Stats::Clock::now() - start;
     ++_latestStats._availableVersionFetches;
 
+    if (_limits) {
+      _limits.check(_latestStats);
+    }
+
     if (!versionList) {
-      if (error) {
-        throw Exception::UserError(copyAcquireCString(error));
+      if (ownedError) {
+        throw Exception::UserError(ownedError.get());
       } else {
         throw Exception::UserError();
       }
     }
 
-    assert(!error);
+    assert(!ownedError);
+
+    Project::Domain domain(std::make_move_iterator(versionList->_versions.begin()), std::make_move_iterator(versionList->_versions.end()), Project::Domain::key_compare(), Project::Domain::allocator_type(&_memory._availableVersions));
+    project = std::make_unique<Project>(std::move(domain), &_memory._dependencyLists);
 
-    Project::Domain domain(std::make_move_iterator(versionList->_versions.begin()), std::make_move_iterator(versionList->_versions.end()));
-    it = _projects.emplace(std::make_pair(projectIdentifier, Project(std::move(domain)))).first;
+    // Adopt any dependency lists which were fetched before the domain was.
+    auto pending = _pendingDependencyLists.find(projectID);
+    if (pending != _pendingDependencyLists.end()) {
+      for (const auto &pair : pending->second) {
+        project->addInstantiation(pair.first, pair.second);
+      }
+
+      _pendingDependencyLists.erase(pending);
+    }
+
+    // Projects are never released before the resolver, so count them here
+    // rather than giving them an allocator.
+    _memory._availableVersions.allocated(sizeof(Project));
   }
 
-  return it->second.domain();
+  return *project;
 }
 
 Optional<ArbiterSelectedVersion> ArbiterResolver::fetchSelectedVersionForMetadata (const ArbiterProjectIdentifier &project, const Arbiter::SharedUserValue<ArbiterSelectedVersion> &metadata)
@@ -262,7 +647,15 @@ Optional<ArbiterSelectedVersion> ArbiterResolver::fetchSelectedVersionForMetadat
     return None();
   }
 
+  const auto start = Stats::Clock::now();
   std::unique_ptr<ArbiterSelectedVersion> version(behavior(this, &project, metadata.data()));
+
+  _latestStats._behaviorDuration += Stats::Clock::now() - start;
+  ++_latestStats._selectedVersionForMetadataFetches;
+
+  if (_limits) {
+    _limits.check(_latestStats);
+  }
   if (version) {
     return makeOptional(std::move(*version));
   } else {
@@ -272,12 +665,39 @@ Optional<ArbiterSelectedVersion> ArbiterResolver::fetchSelectedVersionForMetadat
 
 ArbiterResolvedDependencyGraph ArbiterResolver::resolve () noexcept(false)
 {
-  UniqueDependencySet dependencySet(_dependenciesToResolve._dependencies.begin(), _dependenciesToResolve._dependencies.end());
-
   startStats();
 
+  if (_resultFingerprint) {
+    if (auto cached = _resultCache->find(*_resultFingerprint)) {
+      _latestStats._resultCacheHits++;
+      endStats();
+      return std::move(*cached);
+    }
+  }
+
+  // Nothing from any previous resolution remains in the arena.
+  _arena.reset();
+
   try {
-    ArbiterResolvedDependencyGraph graph = resolveDependencies(*this, _initialGraph, std::move(dependencySet));
+    ArbiterResolvedDependencyGraph graph;
+
+    // Release the search state before measuring it.
+    {
+      CandidateGraph initialGraph(_initialGraph, _interner, _arena, &_memory._candidateGraphs);
+
+      UniqueDependencyMap dependencyMap(_dependenciesToResolve._dependencies.size(), ArenaAllocator<UniqueDependencyMap::value_type>(_arena, &_memory._searchState));
+
+      for (const ArbiterDependency &dependency : _dependenciesToResolve._dependencies) {
+        dependencyMap.emplace(_interner.intern(dependency._projectIdentifier), &dependency);
+      }
+
+      graph = resolveDependencies(*this, initialGraph, dependencyMap);
+    }
+
+    if (_resultFingerprint) {
+      _resultCache->insert(*_resultFingerprint, graph);
+    }
+
     endStats();
     return graph;
   } catch (...) {
@@ -287,6 +707,145 @@ ArbiterResolvedDependencyGraph ArbiterResolver::resolve () noexcept(false)
   }
 }
 
+ArbiterDependencyList ArbiterResolver::unsatisfiedDependencies () noexcept(false)
+{
+  startStats();
+
+  try {
+    using Node = ArbiterResolvedDependencyGraph::NodeMap::value_type;
+
+    const auto &nodes = _initialGraph.nodes();
+    const auto &edges = _initialGraph.edges();
+
+    std::vector<ArbiterDependency> unsatisfied;
+
+    // Several dependents may share the same unsatisfied dependency, which
+    // should only be reported once.
+    std::unordered_set<ArbiterDependency> reported;
+    auto report = [&](const ArbiterDependency &dependency) {
+      if (reported.insert(dependency).second) {
+        unsatisfied.emplace_back(dependency);
+      }
+    };
+
+    // Each node is visited at most once, and only if some dependency it
+    // satisfies was reached from the dependencies to resolve.
+    std::unordered_set<const Node *> visited;
+    std::vector<const Node *> queue;
+
+    // Records `dependency` if the graph does not satisfy it, otherwise queues
+    // the node which does. Returns whether the dependency was satisfied.
+    auto visit = [&](const ArbiterDependency &dependency) {
+      const auto it = nodes.find(dependency._projectIdentifier);
+      if (it == nodes.end() || !dependency.requirement().satisfiedBy(it->second._version)) {
+        report(dependency);
+        return false;
+      }
+
+      if (visited.insert(&*it).second) {
+        queue.emplace_back(&*it);
+      }
+
+      return true;
+    };
+
+    for (const ArbiterDependency &dependency : _dependenciesToResolve._dependencies) {
+      visit(dependency);
+    }
+
+    for (size_t index = 0; index < queue.size(); index++) {
+      const ArbiterProjectIdentifier &project = queue[index]->first;
+      const ArbiterSelectedVersion &version = queue[index]->second._version;
+
+      const auto edgesIt = edges.find(project);
+
+      // A dependency is also unsatisfied if the graph is missing the edge to
+      // it, since installing in graph order could then be wrong.
+      auto visitDependency = [&](const ArbiterDependency &dependency) {
+        if (visit(dependency) && (edgesIt == edges.end() || edgesIt->second.count(dependency._projectIdentifier) == 0)) {
+          report(dependency);
+        }
+      };
+
+      // Reuse the dependencies from an earlier resolution or check if we have
+      // them, and otherwise keep what we fetch for the next one.
+      ProjectID projectID = _interner.intern(project);
+
+      if (projectID < _projects.size() && _projects[projectID]) {
+        Project &cached = *_projects[projectID];
+
+        std::shared_ptr<Instantiation> instantiation = cached.instantiationForVersion(version);
+        if (instantiation) {
+          ++_latestStats._dependencyListCacheHits;
+        } else {
+          instantiation = cached.addInstantiation(version, *fetchDependencyList(project, version));
+        }
+
+        for (const ArbiterDependency &dependency : instantiation->dependencies()) {
+          visitDependency(dependency);
+        }
+      } else {
+        // The project's available versions are not needed for this check, so
+        // hold on to the list until they are fetched.
+        auto &pending = _pendingDependencyLists[projectID];
+        auto it = std::find_if(pending.begin(), pending.end(), [&version](const auto &pair) {
+          return pair.first == version;
+        });
+
+        if (it != pending.end()) {
+          ++_latestStats._dependencyListCacheHits;
+        } else {
+          std::unique_ptr<ArbiterDependencyList> dependencyList = fetchDependencyList(project, version);
+          pending.emplace_back(version, std::move(*dependencyList));
+          it = pending.end() - 1;
+        }
+
+        for (const ArbiterDependency &dependency : it->second._dependencies) {
+          visitDependency(dependency);
+        }
+      }
+    }
+
+    endStats();
+    return ArbiterDependencyList(std::move(unsatisfied));
+  } catch (...) {
+    endStats();
+    throw;
+  }
+}
+
+void ArbiterResolver::setTraceFunction (ArbiterTraceFunction function, std::shared_ptr<const void> context)
+{
+  _traceFile.reset();
+
+  if (function) {
+    _tracer = Tracer(function, std::move(context));
+  } else {
+    _tracer = Tracer();
+  }
+}
+
+void ArbiterResolver::setTraceFile (const char *path) noexcept(false)
+{
+  // Finish any existing file before opening a new one, in case they're the
+  // same.
+  setTraceFunction(nullptr, nullptr);
+
+  _traceFile = std::make_shared<ChromeTraceFile>(path);
+  _tracer = Tracer(&ChromeTraceFile::traceFunction, _traceFile);
+}
+
+void ArbiterResolver::setResultCache (const ArbiterResultCache *cache, const std::string &registryEpoch)
+{
+  if (cache) {
+    _resultCache = *cache;
+    _resultFingerprint = ArbiterResultCache::fingerprint(_dependenciesToResolve, _initialGraph, registryEpoch);
+  } else {
+    _resultCache = None();
+    _resultFingerprint = None();
+  }
+}
+
 std::unique_ptr<Arbiter::Base> ArbiterResolver::clone () const
 {
   return std::make_unique<ArbiterResolver>(_behaviors, _initialGraph, _dependenciesToResolve, _context);
@@ -302,58 +861,87 @@ bool ArbiterResolver::operator== (const Arbiter::Base &other) const
   return this == &other;
 }
 
-std::vector<ArbiterSelectedVersion> ArbiterResolver::availableVersionsSatisfying (const ArbiterProjectIdentifier &project, const ArbiterRequirement &requirement) noexcept(false)
+ArbiterResolver::SatisfyingVersions ArbiterResolver::availableVersionsSatisfying (ProjectID project, const ArbiterRequirement &requirement) noexcept(false)
 {
-  std::vector<ArbiterSelectedVersion> versions;
+  SatisfyingVersions result(&_memory._searchState);
+  auto &fetched = result._fetched;
 
   if (_behaviors.createSelectedVersionForMetadata) {
     UnversionedRequirementVisitor visitor;
     requirement.visit(visitor);
 
     for (const auto &metadata : visitor._allMetadata) {
-      Optional<ArbiterSelectedVersion> version = fetchSelectedVersionForMetadata(project, metadata);
+      Optional<ArbiterSelectedVersion> version = fetchSelectedVersionForMetadata(_interner.project(project), metadata);
       if (version) {
-        versions.emplace_back(std::move(*version));
+        fetched.emplace_back(std::move(*version));
       }
     }
   }
 
-  const auto &fetchedVersions = fetchAvailableVersions(project);
-  versions.insert(versions.end(), fetchedVersions.begin(), fetchedVersions.end());
-
-  auto removeStart = std::remove_if(versions.begin(), versions.end(), [&requirement](const ArbiterSelectedVersion &version) {
+  auto removeStart = std::remove_if(fetched.begin(), fetched.end(), [&requirement](const ArbiterSelectedVersion &version) {
     return !requirement.satisfiedBy(version);
   });
 
-  versions.erase(removeStart, versions.end());
-  return versions;
+  fetched.erase(removeStart, fetched.end());
+  std::sort(fetched.begin(), fetched.end(), std::greater<ArbiterSelectedVersion>());
+
+  // The domain can be large, so evaluate the requirement against all of it at
+  // once.
+  const VersionBlock &block = fetchProject(project).domainBlock();
+
+  std::vector<uint64_t, CountingAllocator<uint64_t>> mask(block.wordCount(), 0, CountingAllocator<uint64_t>(&_memory._searchState));
+  requirement.satisfiedByEach(block, mask.data(), &_predicateCache);
+
+  // The domain is sorted with highest precedence first, so visiting the bits
+  // in order yields the versions in order. Fetched versions (usually none)
+  // are merged in among them.
+  auto &versions = result._versions;
+  auto fetchedIt = fetched.cbegin();
+
+  forEachSetBit(mask.data(), mask.size(), [&](size_t index) {
+    const ArbiterSelectedVersion &version = block.version(index);
+
+    for (; fetchedIt != fetched.cend() && *fetchedIt > version; ++fetchedIt) {
+      versions.emplace_back(&*fetchedIt);
+    }
+
+    versions.emplace_back(&version);
+  });
+
+  for (; fetchedIt != fetched.cend(); ++fetchedIt) {
+    versions.emplace_back(&*fetchedIt);
+  }
+
+  return result;
 }
 
 void ArbiterResolver::startStats ()
 {
   _latestStats = Stats(Stats::Clock::now());
+  _predicateCache.clear();
+  _limits.reset();
+  _partialGraph = None();
+
+  _memory._availableVersions.resetPeak();
+  _memory._dependencyLists.resetPeak();
+  _memory._candidateGraphs.resetPeak();
+  _memory._searchState.resetPeak();
 }
 
 void ArbiterResolver::endStats ()
 {
   _latestStats._endTime = Stats::Clock::now();
+  _latestStats._predicateCacheHits = _predicateCache.hits();
+  _latestStats._predicateCacheMisses = _predicateCache.misses();
 
-  size_t depsSize = 0;
-  size_t versionsSize = _projects.size() * sizeof(decltype(_projects)::key_type);
-
-  // These size estimates are a holdover from a previous representation, where
-  // we cached simple maps of project identifiers to versions and dependency
-  // sets. Do our best to maintain compatibility with those measurements.
-  for (const auto &pair : _projects) {
-    const Project &project = pair.second;
-    versionsSize += project.domain().size() * sizeof(Project::Domain::value_type);
-
-    for (const std::shared_ptr<Instantiation> &instantiation : project.instantiations()) {
-      depsSize += instantiation->dependencies().size() * sizeof(Instantiation::Dependencies::value_type);
-      depsSize += instantiation->_versions.size() * sizeof(Instantiation::Versions::value_type);
-    }
+  if (_traceFile) {
+    _traceFile->flush();
   }
 
-  _latestStats._cachedDependenciesSizeEstimate = depsSize;
-  _latestStats._cachedAvailableVersionsSizeEstimate = versionsSize;
+  _latestStats._availableVersionsMemory = memoryUsage(_memory._availableVersions);
+  _latestStats._dependencyListsMemory = memoryUsage(_memory._dependencyLists);
+  _latestStats._candidateGraphMemory = memoryUsage(_memory._candidateGraphs);
+  _latestStats._searchStateMemory = memoryUsage(_memory._searchState);
+  _latestStats._requirementMemory = memoryUsage(ArbiterRequirement::memoryCounter());
+  _latestStats._arenaReservedBytes = _arena.capacity();
 }
@@ -6,14 +6,22 @@
 
 #include <arbiter/Resolver.h>
 
+#include "Arena.h"
 #include "Dependency.h"
 #include "Graph.h"
 #include "Instantiation.h"
+#include "Limits.h"
+#include "Optional.h"
+#include "PredicateCache.h"
 #include "Project.h"
+#include "ProjectInterner.h"
+#include "ResultCache.h"
 #include "Stats.h"
+#include "Trace.h"
 #include "Types.h"
 #include "Version.h"
 
+#include <functional>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -26,11 +34,23 @@ struct ArbiterResolver final : public Arbiter::Base
     // Statistics from the latest dependency resolution.
     Arbiter::Stats _latestStats;
 
+    // Receives events describing the progress of each resolution, if enabled.
+    Arbiter::Tracer _tracer;
+
+    // Limits on the work done by each resolution, if any.
+    Arbiter::ResolverLimits _limits;
+
+    // The largest consistent graph built by the latest resolution, if it had
+    // limits.
+    Arbiter::Optional<ArbiterResolvedDependencyGraph> _partialGraph;
+
     ArbiterResolver (ArbiterResolverBehaviors behaviors, ArbiterResolvedDependencyGraph initialGraph, ArbiterDependencyList dependenciesToResolve, std::shared_ptr<const void> context)
       : _context(std::move(context))
       , _behaviors(std::move(behaviors))
       , _initialGraph(std::move(initialGraph))
       , _dependenciesToResolve(std::move(dependenciesToResolve))
+      , _projects(Projects::allocator_type(&_memory._availableVersions))
+      , _internedDependencies(0, InternedDependenciesMap::hasher(), InternedDependenciesMap::key_equal(), InternedDependenciesMap::allocator_type(&_memory._dependencyLists))
     {
       assert(_behaviors.createDependencyList);
       assert(_behaviors.createAvailableVersionsList);
@@ -39,19 +59,102 @@ struct ArbiterResolver final : public Arbiter::Base
     ArbiterResolver (const ArbiterResolver &) = delete;
     ArbiterResolver &operator= (const ArbiterResolver &) = delete;
 
+    using ProjectID = Arbiter::ProjectInterner::ID;
+
+    /**
+     * A dependency of a project instantiation, along with the interned ID of
+     * the project it refers to.
+     */
+    struct InternedDependency final
+    {
+      public:
+        ProjectID _project;
+        const ArbiterDependency *_dependency;
+    };
+
+    using InternedDependencies = std::vector<InternedDependency, Arbiter::CountingAllocator<InternedDependency>>;
+
+    /**
+     * The versions of a project which satisfy a requirement, ordered from
+     * highest to lowest precedence.
+     */
+    struct SatisfyingVersions final
+    {
+      public:
+        /**
+         * Versions fetched for the metadata of unversioned requirements, which
+         * are not part of the project's domain.
+         */
+        std::vector<ArbiterSelectedVersion, Arbiter::CountingAllocator<ArbiterSelectedVersion>> _fetched;
+
+        /**
+         * Pointers into the project's domain, or into `_fetched`.
+         */
+        std::vector<const ArbiterSelectedVersion *, Arbiter::CountingAllocator<const ArbiterSelectedVersion *>> _versions;
+
+        explicit SatisfyingVersions (Arbiter::MemoryCounter *counter)
+          : _fetched(decltype(_fetched)::allocator_type(counter))
+          , _versions(decltype(_versions)::allocator_type(counter))
+        {}
+
+        // Moving keeps the pointers into `_fetched` valid, but copying would
+        // not.
+        SatisfyingVersions (SatisfyingVersions &&) = default;
+        SatisfyingVersions &operator= (SatisfyingVersions &&) = default;
+    };
+
+    /**
+     * Counts the memory allocated by the resolver for each purpose.
+     */
+    struct MemoryCounters final
+    {
+      public:
+        Arbiter::MemoryCounter _availableVersions;
+        Arbiter::MemoryCounter _dependencyLists;
+        Arbiter::MemoryCounter _candidateGraphs;
+        Arbiter::MemoryCounter _searchState;
+    };
+
+    // Declared before any of the containers which refer to them, so that the
+    // counters outlive those containers.
+    MemoryCounters _memory;
+
+    /**
+     * Maps project identifiers to the IDs used for them during resolution.
+     *
+     * IDs remain valid for the lifetime of the resolver, so that information
+     * fetched about each project can be reused across resolutions.
+     */
+    Arbiter::ProjectInterner _interner;
+
+    /**
+     * Scratch memory for the transient state of a resolution, which is reset
+     * when each resolution begins, and rewound whenever a combination of
+     * versions fails.
+     */
+    Arbiter::Arena _arena;
+
     /**
      * Fetches the dependencies for the given project and version.
      *
      * Returns the dependencies or throws an exception.
      */
-    const Arbiter::Instantiation::Dependencies &fetchDependencies (const ArbiterProjectIdentifier &projectIdentifier, const ArbiterSelectedVersion &version) noexcept(false);
+    const InternedDependencies &fetchDependencies (ProjectID project, const ArbiterSelectedVersion &version) noexcept(false);
 
     /**
      * Fetches the available versions for the given project.
      *
      * Returns the versions or throws an exception.
      */
-    const Arbiter::Project::Domain &fetchAvailableVersions (const ArbiterProjectIdentifier &projectIdentifier) noexcept(false);
+    const Arbiter::Project::Domain &fetchAvailableVersions (ProjectID project) noexcept(false);
+
+    /**
+     * Fetches the available versions for the given project, returning the
+     * project information which contains them.
+     *
+     * Returns the project or throws an exception.
+     */
+    const Arbiter::Project &fetchProject (ProjectID project) noexcept(false);
 
     /**
      * Fetches a selected version for the given metadata string.
@@ -63,14 +166,49 @@ struct ArbiterResolver final : public Arbiter::Base
     /**
      * Computes a list of available versions for the specified project which
      * satisfy the given requirement.
+     *
+     * Versions from the project's domain are not copied, and since the domain
+     * is already sorted, none are compared unless versions had to be fetched
+     * for unversioned requirements.
      */
-    std::vector<ArbiterSelectedVersion> availableVersionsSatisfying (const ArbiterProjectIdentifier &project, const ArbiterRequirement &requirement) noexcept(false);
+    SatisfyingVersions availableVersionsSatisfying (ProjectID project, const ArbiterRequirement &requirement) noexcept(false);
 
     /**
      * Attempts to resolve all dependencies.
      */
     ArbiterResolvedDependencyGraph resolve () noexcept(false);
 
+    /**
+     * Checks whether the initial graph already satisfies all dependencies to
+     * resolve, and all of their transitive dependencies, without searching
+     * for other versions. Only the dependency lists of the projects reachable
+     * in the initial graph are fetched, and they are kept for later calls to
+     * resolve().
+     *
+     * Returns every dependency which the initial graph does not satisfy, once
+     * each, which is empty if resolution would not change the graph.
+     */
+    ArbiterDependencyList unsatisfiedDependencies () noexcept(false);
+
+    /**
+     * Replaces any existing tracing with the given trace function.
+     */
+    void setTraceFunction (ArbiterTraceFunction function, std::shared_ptr<const void> context);
+
+    /**
+     * Replaces any existing tracing with a trace file at `path`.
+     *
+     * Throws an exception if the file cannot be opened.
+     */
+    void setTraceFile (const char *path) noexcept(false);
+
+    /**
+     * Makes subsequent resolutions consult `cache` (if not null) for results
+     * stored under the given registry epoch, and store their own results
+     * there.
+     */
+    void setResultCache (const ArbiterResultCache *cache, const std::string &registryEpoch);
+
     std::unique_ptr<Arbiter::Base> clone () const override;
     std::ostream &describe (std::ostream &os) const override;
     bool operator== (const Arbiter::Base &other) const override;
@@ -80,7 +218,50 @@ struct ArbiterResolver final : public Arbiter::Base
     const ArbiterResolvedDependencyGraph _initialGraph;
     const ArbiterDependencyList _dependenciesToResolve;
 
-    std::unordered_map<ArbiterProjectIdentifier, Arbiter::Project> _projects;
+    /**
+     * Information fetched about each project, indexed by ID. Projects whose
+     * available versions have not been fetched are null.
+     */
+    using Projects = std::vector<std::unique_ptr<Arbiter::Project>, Arbiter::CountingAllocator<std::unique_ptr<Arbiter::Project>>>;
+    Projects _projects;
+
+    /**
+     * The dependencies of each instantiation in `_projects`, with their
+     * project identifiers interned.
+     */
+    using InternedDependenciesMap = std::unordered_map<const Arbiter::Instantiation *, InternedDependencies, std::hash<const Arbiter::Instantiation *>, std::equal_to<const Arbiter::Instantiation *>, Arbiter::CountingAllocator<std::pair<const Arbiter::Instantiation *const, InternedDependencies>>>;
+    InternedDependenciesMap _internedDependencies;
+
+    /**
+     * Dependency lists fetched by unsatisfiedDependencies() for projects whose
+     * available versions were not known yet, keyed by project ID. They are
+     * added to the project's instantiations once it is fetched, so that
+     * resolve() does not fetch them again.
+     */
+    using PendingDependencyLists = std::unordered_map<ProjectID, std::vector<std::pair<ArbiterSelectedVersion, ArbiterDependencyList>>>;
+    PendingDependencyLists _pendingDependencyLists;
+
+    /**
+     * Results of custom requirement predicates evaluated against the domains
+     * in `_projects`, for the duration of one resolution.
+     */
+    Arbiter::PredicateCache _predicateCache;
+
+    // The file being written by `_tracer`, if any, which is flushed after each
+    // resolution.
+    std::shared_ptr<Arbiter::ChromeTraceFile> _traceFile;
+
+    // The cache of resolved graphs, if any, and the fingerprint of this
+    // resolver's inputs within it. The fingerprint is None if the inputs
+    // cannot be serialized, in which case the cache is not used.
+    Arbiter::Optional<ArbiterResultCache> _resultCache;
+    Arbiter::Optional<ArbiterResultCache::Fingerprint> _resultFingerprint;
+
+    /**
+     * Invokes the user's behavior to fetch the dependencies for the given
+     * project and version, without caching them.
+     */
+    std::unique_ptr<ArbiterDependencyList> fetchDependencyList (const ArbiterProjectIdentifier &project, const ArbiterSelectedVersion &version) noexcept(false);
 
     void startStats ();
     void endStats ();
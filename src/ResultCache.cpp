@@ -0,0 +1,293 @@
+#include "ResultCache.h"
+
+#include "Exception.h"
+#include "Lockfile.h"
+#include "ToString.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace Arbiter;
+
+namespace {
+
+using Fingerprint = ArbiterResultCache::Fingerprint;
+
+struct FingerprintHash final
+{
+  public:
+    size_t operator() (const Fingerprint &fingerprint) const noexcept
+    {
+      // The fingerprint is already uniformly distributed.
+      size_t hash;
+      std::memcpy(&hash, fingerprint.data(), sizeof(hash));
+      return hash;
+    }
+};
+
+/**
+ * Writes `graph` as a lockfile at `path`, by way of a temporary file in the
+ * same directory, so that readers never see a partially-written lockfile.
+ */
+void writeLockfileAtomically (const std::string &path, const ArbiterResolvedDependencyGraph &graph) noexcept(false)
+{
+  std::vector<char> temporaryPath(path.begin(), path.end());
+  for (char c : std::string(".XXXXXX")) {
+    temporaryPath.push_back(c);
+  }
+
+  temporaryPath.push_back('\0');
+
+  int fd = mkstemp(temporaryPath.data());
+  if (fd < 0) {
+    throw Exception::SerializationError("Could not create a temporary file for " + path + ": " + std::strerror(errno));
+  }
+
+  try {
+    Lockfile::write(graph, [&](const char *bytes, size_t length) {
+      while (length > 0) {
+        ssize_t written = ::write(fd, bytes, length);
+        if (written < 0) {
+          if (errno == EINTR) {
+            continue;
+          }
+
+          throw Exception::SerializationError("Could not write to " + std::string(temporaryPath.data()) + ": " + std::strerror(errno));
+        }
+
+        bytes += written;
+        length -= size_t(written);
+      }
+    });
+
+    if (close(fd) != 0) {
+      fd = -1;
+      throw Exception::SerializationError("Could not write to " + std::string(temporaryPath.data()) + ": " + std::strerror(errno));
+    }
+
+    fd = -1;
+
+    if (rename(temporaryPath.data(), path.c_str()) != 0) {
+      throw Exception::SerializationError("Could not move lockfile to " + path + ": " + std::strerror(errno));
+    }
+  } catch (...) {
+    if (fd >= 0) {
+      close(fd);
+    }
+
+    unlink(temporaryPath.data());
+    throw;
+  }
+}
+
+} // namespace
+
+class ArbiterResultCache::Storage final
+{
+  public:
+    Storage (size_t capacity, Optional<std::string> directory, ArbiterLockfileValueReaders readers)
+      : _capacity(capacity)
+      , _directory(std::move(directory))
+      , _readers(readers)
+    {}
+
+    Optional<ArbiterResolvedDependencyGraph> find (const Fingerprint &fingerprint)
+    {
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        auto it = _index.find(fingerprint);
+        if (it != _index.end()) {
+          _entries.splice(_entries.begin(), _entries, it->second);
+          return it->second->second;
+        }
+      }
+
+      if (!_directory) {
+        return None();
+      }
+
+      ArbiterResolvedDependencyGraph graph;
+      try {
+        graph = ArbiterLockfile(path(fingerprint), _readers).graph();
+      } catch (const Exception::Base &) {
+        // Missing or unreadable lockfiles are just misses.
+        return None();
+      }
+
+      remember(fingerprint, graph);
+      return graph;
+    }
+
+    void insert (const Fingerprint &fingerprint, const ArbiterResolvedDependencyGraph &graph)
+    {
+      remember(fingerprint, graph);
+
+      if (_directory) {
+        try {
+          writeLockfileAtomically(path(fingerprint), graph);
+        } catch (const Exception::Base &) {
+          // The graph is still cached in memory, which is the best that can be
+          // done.
+        }
+      }
+    }
+
+    size_t size ()
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      return _entries.size();
+    }
+
+    const Optional<std::string> &directory () const noexcept
+    {
+      return _directory;
+    }
+
+  private:
+    using Entry = std::pair<Fingerprint, ArbiterResolvedDependencyGraph>;
+
+    std::mutex _mutex;
+    const size_t _capacity;
+    const Optional<std::string> _directory;
+    const ArbiterLockfileValueReaders _readers;
+
+    // From most to least recently used.
+    std::list<Entry> _entries;
+    std::unordered_map<Fingerprint, std::list<Entry>::iterator, FingerprintHash> _index;
+
+    std::string path (const Fingerprint &fingerprint) const
+    {
+      return *_directory + Sha256::hex(fingerprint) + ".lock";
+    }
+
+    void remember (const Fingerprint &fingerprint, const ArbiterResolvedDependencyGraph &graph)
+    {
+      if (_capacity == 0) {
+        return;
+      }
+
+      std::lock_guard<std::mutex> lock(_mutex);
+
+      auto it = _index.find(fingerprint);
+      if (it != _index.end()) {
+        it->second->second = graph;
+        _entries.splice(_entries.begin(), _entries, it->second);
+        return;
+      }
+
+      if (_entries.size() == _capacity) {
+        _index.erase(_entries.back().first);
+        _entries.pop_back();
+      }
+
+      _entries.emplace_front(fingerprint, graph);
+      _index.emplace(fingerprint, _entries.begin());
+    }
+};
+
+ArbiterResultCache::ArbiterResultCache (size_t capacity, Optional<std::string> directory, ArbiterLockfileValueReaders readers) noexcept(false)
+{
+  if (directory) {
+    struct stat info;
+    if (stat(directory->c_str(), &info) != 0 || !S_ISDIR(info.st_mode)) {
+      throw Exception::SerializationError("Result cache directory " + *directory + " does not exist");
+    }
+
+    if (directory->empty() || directory->back() != '/') {
+      directory->push_back('/');
+    }
+  }
+
+  _storage = std::make_shared<Storage>(capacity, std::move(directory), readers);
+}
+
+Optional<Fingerprint> ArbiterResultCache::fingerprint (const ArbiterDependencyList &dependenciesToResolve, const ArbiterResolvedDependencyGraph &initialGraph, const std::string &registryEpoch) noexcept
+{
+  Sha256 hash;
+  auto sink = [&hash](const char *bytes, size_t length) {
+    hash.update(bytes, length);
+  };
+
+  try {
+    Lockfile::writeDependencies(dependenciesToResolve, sink);
+    Lockfile::write(initialGraph, sink);
+  } catch (const Exception::Base &) {
+    return None();
+  } catch (const std::bad_alloc &) {
+    return None();
+  }
+
+  uint64_t epochLength = registryEpoch.size();
+  hash.update(&epochLength, sizeof(epochLength));
+  hash.update(registryEpoch.data(), registryEpoch.size());
+
+  return hash.finish();
+}
+
+Optional<ArbiterResolvedDependencyGraph> ArbiterResultCache::find (const Fingerprint &fingerprint) const
+{
+  return _storage->find(fingerprint);
+}
+
+void ArbiterResultCache::insert (const Fingerprint &fingerprint, const ArbiterResolvedDependencyGraph &graph) const
+{
+  _storage->insert(fingerprint, graph);
+}
+
+size_t ArbiterResultCache::size () const
+{
+  return _storage->size();
+}
+
+std::unique_ptr<Arbiter::Base> ArbiterResultCache::clone () const
+{
+  return std::unique_ptr<ArbiterResultCache>(new ArbiterResultCache(*this));
+}
+
+std::ostream &ArbiterResultCache::describe (std::ostream &os) const
+{
+  os << "ArbiterResultCache(" << size() << " in memory";
+
+  if (const auto &directory = _storage->directory()) {
+    os << ", " << *directory;
+  }
+
+  return os << ")";
+}
+
+bool ArbiterResultCache::operator== (const Arbiter::Base &other) const
+{
+  auto ptr = dynamic_cast<const ArbiterResultCache *>(&other);
+  if (!ptr) {
+    return false;
+  }
+
+  return _storage == ptr->_storage;
+}
+
+ArbiterResultCache *ArbiterCreateResultCache (size_t capacity, const char *directory, ArbiterLockfileValueReaders readers, char **error)
+{
+  try {
+    return new ArbiterResultCache(capacity, (directory ? makeOptional(std::string(directory)) : Optional<std::string>()), readers);
+  } catch (const std::exception &ex) {
+    if (error) {
+      *error = copyCString(ex.what()).release();
+    }
+
+    return nullptr;
+  }
+}
+
+size_t ArbiterResultCacheCount (const ArbiterResultCache *cache)
+{
+  return cache->size();
+}
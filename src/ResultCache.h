@@ -0,0 +1,72 @@
+#pragma once
+
+#ifndef __cplusplus
+#error "This file must be compiled as C++."
+#endif
+
+#include <arbiter/ResultCache.h>
+
+#include "Dependency.h"
+#include "Graph.h"
+#include "Optional.h"
+#include "Sha256.h"
+#include "Types.h"
+
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string>
+
+struct ArbiterResultCache final : public Arbiter::Base
+{
+  public:
+    using Fingerprint = Arbiter::Sha256::Digest;
+
+    /**
+     * Creates a cache holding up to `capacity` graphs in memory, and any number
+     * in `directory`, if one is given.
+     *
+     * Throws an exception if `directory` does not exist.
+     */
+    ArbiterResultCache (size_t capacity, Arbiter::Optional<std::string> directory, ArbiterLockfileValueReaders readers) noexcept(false);
+
+    /**
+     * Creates another reference to the same cache.
+     */
+    ArbiterResultCache (const ArbiterResultCache &) = default;
+
+    /**
+     * Returns a fingerprint of the inputs to a resolution, or None if they
+     * cannot be serialized.
+     */
+    static Arbiter::Optional<Fingerprint> fingerprint (const ArbiterDependencyList &dependenciesToResolve, const ArbiterResolvedDependencyGraph &initialGraph, const std::string &registryEpoch) noexcept;
+
+    /**
+     * Looks up the graph stored for the given fingerprint, first in memory and
+     * then on disk, marking it as the most recently used.
+     */
+    Arbiter::Optional<ArbiterResolvedDependencyGraph> find (const Fingerprint &fingerprint) const;
+
+    /**
+     * Stores a graph for the given fingerprint, replacing any graph already
+     * stored for it.
+     *
+     * Graphs which cannot be written to disk are kept only in memory.
+     */
+    void insert (const Fingerprint &fingerprint, const ArbiterResolvedDependencyGraph &graph) const;
+
+    /**
+     * Returns the number of graphs held in memory.
+     */
+    size_t size () const;
+
+    std::unique_ptr<Arbiter::Base> clone () const override;
+    std::ostream &describe (std::ostream &os) const override;
+    bool operator== (const Arbiter::Base &other) const override;
+
+  private:
+    class Storage;
+
+    // Shared with clones, and synchronized internally.
+    std::shared_ptr<Storage> _storage;
+};
@@ -0,0 +1,289 @@
+#include "Scheduler.h"
+
+#include "CompactGraph.h"
+#include "Exception.h"
+#include "ToString.h"
+#include "Value.h"
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+#include <unordered_set>
+
+using namespace Arbiter;
+
+ArbiterResolvedDependencyScheduler::ArbiterResolvedDependencyScheduler (const ArbiterResolvedDependencyGraph &graph, const CostFunction &costFunction, size_t workerCount) noexcept(false)
+  : _workerCount(workerCount)
+  , _inProgressCount(0)
+  , _completedCount(0)
+{
+  auto compact = graph.compact();
+
+  // Compact graph nodes are already sorted by project identifier.
+  _nodes.reserve(compact->size());
+  _indexesByProject.reserve(compact->size());
+
+  for (CompactGraph::Index index = 0; index < compact->size(); index++) {
+    const ArbiterProjectIdentifier &project = compact->project(index);
+    _nodes.emplace_back(compact->node(index));
+    _indexesByProject.emplace(project, index);
+
+    Node &node = _nodes.back();
+    node._remainingDependencies = compact->dependencies(index).size();
+    node._dependents.assign(compact->dependents(index).begin(), compact->dependents(index).end());
+  }
+
+  // Find a topological order (dependencies first) with Kahn's algorithm.
+  std::vector<size_t> remainingDependencies;
+  std::vector<size_t> order;
+  remainingDependencies.reserve(_nodes.size());
+  order.reserve(_nodes.size());
+
+  for (size_t index = 0; index < _nodes.size(); index++) {
+    remainingDependencies.emplace_back(_nodes[index]._remainingDependencies);
+    if (remainingDependencies.back() == 0) {
+      order.emplace_back(index);
+    }
+  }
+
+  for (size_t position = 0; position < order.size(); position++) {
+    for (size_t dependentIndex : _nodes[order[position]]._dependents) {
+      if (--remainingDependencies[dependentIndex] == 0) {
+        order.emplace_back(dependentIndex);
+      }
+    }
+  }
+
+  if (order.size() != _nodes.size()) {
+    std::unordered_set<ArbiterProjectIdentifier> unplaced;
+    for (size_t index = 0; index < _nodes.size(); index++) {
+      if (remainingDependencies[index] != 0) {
+        unplaced.emplace(_nodes[index]._dependency._project);
+      }
+    }
+
+    graph.throwDependencyCycle(unplaced);
+  }
+
+  // Walking backwards, every node's dependents have been costed already.
+  for (auto it = order.rbegin(); it != order.rend(); ++it) {
+    Node &node = _nodes[*it];
+
+    double dependentsCost = 0;
+    for (size_t dependentIndex : node._dependents) {
+      dependentsCost = std::max(dependentsCost, _nodes[dependentIndex]._criticalPathCost);
+    }
+
+    double cost = (costFunction ? costFunction(node._dependency) : 1);
+    node._criticalPathCost = std::max(cost, 0.0) + dependentsCost;
+  }
+
+  for (size_t index = 0; index < _nodes.size(); index++) {
+    if (_nodes[index]._remainingDependencies == 0) {
+      makeReady(index);
+    }
+  }
+}
+
+ArbiterResolvedDependencyScheduler::ArbiterResolvedDependencyScheduler (const ArbiterResolvedDependencyScheduler &other)
+{
+  std::lock_guard<std::mutex> guard(other._mutex);
+
+  _nodes = other._nodes;
+  _indexesByProject = other._indexesByProject;
+  _ready = other._ready;
+  _workerCount = other._workerCount;
+  _inProgressCount = other._inProgressCount;
+  _completedCount = other._completedCount;
+}
+
+const ArbiterResolvedDependency *ArbiterResolvedDependencyScheduler::next ()
+{
+  std::lock_guard<std::mutex> guard(_mutex);
+
+  if (canStart()) {
+    return start();
+  } else {
+    return nullptr;
+  }
+}
+
+const ArbiterResolvedDependency *ArbiterResolvedDependencyScheduler::waitForNext ()
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+
+  _condition.wait(lock, [this] {
+    return canStart() || _completedCount == _nodes.size();
+  });
+
+  if (canStart()) {
+    return start();
+  } else {
+    return nullptr;
+  }
+}
+
+void ArbiterResolvedDependencyScheduler::markCompleted (const ArbiterProjectIdentifier &project) noexcept(false)
+{
+  {
+    std::lock_guard<std::mutex> guard(_mutex);
+
+    auto it = _indexesByProject.find(project);
+    if (it == _indexesByProject.end() || _nodes[it->second]._state != State::InProgress) {
+      throw std::invalid_argument(toString(project) + " is not being installed");
+    }
+
+    Node &node = _nodes[it->second];
+    node._state = State::Completed;
+
+    --_inProgressCount;
+    ++_completedCount;
+
+    for (size_t dependentIndex : node._dependents) {
+      if (--_nodes[dependentIndex]._remainingDependencies == 0) {
+        makeReady(dependentIndex);
+      }
+    }
+  }
+
+  // Completing a node frees up a worker even if nothing new became ready, and
+  // the last completion needs to wake everyone up.
+  _condition.notify_all();
+}
+
+bool ArbiterResolvedDependencyScheduler::finished () const
+{
+  std::lock_guard<std::mutex> guard(_mutex);
+  return _completedCount == _nodes.size();
+}
+
+double ArbiterResolvedDependencyScheduler::criticalPathCost (const ArbiterProjectIdentifier &project) const noexcept(false)
+{
+  // Costs never change after construction.
+  return _nodes.at(_indexesByProject.at(project))._criticalPathCost;
+}
+
+std::unique_ptr<Arbiter::Base> ArbiterResolvedDependencyScheduler::clone () const
+{
+  return std::make_unique<ArbiterResolvedDependencyScheduler>(*this);
+}
+
+std::ostream &ArbiterResolvedDependencyScheduler::describe (std::ostream &os) const
+{
+  std::lock_guard<std::mutex> guard(_mutex);
+
+  return os << "ArbiterResolvedDependencyScheduler: "
+    << _completedCount << " completed, "
+    << _inProgressCount << " in progress, "
+    << _ready.size() << " ready, of "
+    << _nodes.size() << " total";
+}
+
+bool ArbiterResolvedDependencyScheduler::operator== (const Arbiter::Base &other) const
+{
+  return this == &other;
+}
+
+bool ArbiterResolvedDependencyScheduler::readyAfter (size_t lhs, size_t rhs) const noexcept
+{
+  double lhsCost = _nodes[lhs]._criticalPathCost;
+  double rhsCost = _nodes[rhs]._criticalPathCost;
+
+  if (lhsCost != rhsCost) {
+    return lhsCost < rhsCost;
+  }
+
+  // Nodes are sorted by project identifier.
+  return lhs > rhs;
+}
+
+bool ArbiterResolvedDependencyScheduler::canStart () const noexcept
+{
+  return !_ready.empty() && (_workerCount == 0 || _inProgressCount < _workerCount);
+}
+
+const ArbiterResolvedDependency *ArbiterResolvedDependencyScheduler::start ()
+{
+  assert(canStart());
+
+  auto comparator = [this](size_t lhs, size_t rhs) {
+    return readyAfter(lhs, rhs);
+  };
+
+  std::pop_heap(_ready.begin(), _ready.end(), comparator);
+  size_t index = _ready.back();
+  _ready.pop_back();
+
+  Node &node = _nodes[index];
+  assert(node._state == State::Ready);
+
+  node._state = State::InProgress;
+  ++_inProgressCount;
+
+  return &node._dependency;
+}
+
+void ArbiterResolvedDependencyScheduler::makeReady (size_t index)
+{
+  Node &node = _nodes[index];
+  assert(node._state == State::Waiting);
+  assert(node._remainingDependencies == 0);
+
+  node._state = State::Ready;
+  _ready.emplace_back(index);
+
+  std::push_heap(_ready.begin(), _ready.end(), [this](size_t lhs, size_t rhs) {
+    return readyAfter(lhs, rhs);
+  });
+}
+
+ArbiterResolvedDependencyScheduler *ArbiterResolvedDependencySchedulerCreate (const ArbiterResolvedDependencyGraph *graph, ArbiterResolvedDependencyCostFunction costFunction, ArbiterUserContext context, size_t workerCount, char **error)
+{
+  std::shared_ptr<void> sharedContext = shareUserContext(context);
+
+  ArbiterResolvedDependencyScheduler::CostFunction function;
+  if (costFunction) {
+    function = [costFunction, &sharedContext](const ArbiterResolvedDependency &dependency) {
+      return costFunction(&dependency, sharedContext.get());
+    };
+  }
+
+  try {
+    return new ArbiterResolvedDependencyScheduler(*graph, function, workerCount);
+  } catch (const Exception::Base &ex) {
+    if (error) {
+      *error = copyCString(ex.what()).release();
+    }
+
+    return nullptr;
+  }
+}
+
+const ArbiterResolvedDependency *ArbiterResolvedDependencySchedulerNext (ArbiterResolvedDependencyScheduler *scheduler)
+{
+  return scheduler->next();
+}
+
+const ArbiterResolvedDependency *ArbiterResolvedDependencySchedulerWaitForNext (ArbiterResolvedDependencyScheduler *scheduler)
+{
+  return scheduler->waitForNext();
+}
+
+bool ArbiterResolvedDependencySchedulerMarkCompleted (ArbiterResolvedDependencyScheduler *scheduler, const ArbiterResolvedDependency *dependency, char **error)
+{
+  try {
+    scheduler->markCompleted(dependency->_project);
+    return true;
+  } catch (const std::invalid_argument &ex) {
+    if (error) {
+      *error = copyCString(ex.what()).release();
+    }
+
+    return false;
+  }
+}
+
+bool ArbiterResolvedDependencySchedulerIsFinished (const ArbiterResolvedDependencyScheduler *scheduler)
+{
+  return scheduler->finished();
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#ifndef __cplusplus
+#error "This file must be compiled as C++."
+#endif
+
+#include <arbiter/Graph.h>
+
+#include "Dependency.h"
+#include "Graph.h"
+#include "Types.h"
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Hands out the nodes of a resolved dependency graph for installation as soon
+ * as all of their dependencies have been installed, without waiting for whole
+ * phases to complete.
+ *
+ * When several nodes are ready at once, the one with the most expensive chain
+ * of dependents (the critical path) is handed out first.
+ *
+ * All methods are thread-safe.
+ */
+struct ArbiterResolvedDependencyScheduler final : public Arbiter::Base
+{
+  public:
+    /**
+     * Estimates how expensive a node will be to install.
+     */
+    using CostFunction = std::function<double(const ArbiterResolvedDependency &)>;
+
+    /**
+     * Creates a scheduler for the given graph, which may be freed afterward.
+     *
+     * If `costFunction` is empty, every node is assumed to cost the same.
+     * `workerCount` limits how many nodes may be in progress at once, with zero
+     * meaning no limit.
+     *
+     * Throws an exception if the graph contains a cycle.
+     */
+    ArbiterResolvedDependencyScheduler (const ArbiterResolvedDependencyGraph &graph, const CostFunction &costFunction, size_t workerCount) noexcept(false);
+
+    ArbiterResolvedDependencyScheduler (const ArbiterResolvedDependencyScheduler &other);
+    ArbiterResolvedDependencyScheduler &operator= (const ArbiterResolvedDependencyScheduler &) = delete;
+
+    /**
+     * Returns the highest-priority node which is ready to be installed, marking
+     * it as in progress, or `nullptr` if no node can be started right now.
+     */
+    const ArbiterResolvedDependency *next ();
+
+    /**
+     * Like next(), but blocks until a node can be started. Returns `nullptr`
+     * only once every node has been completed.
+     */
+    const ArbiterResolvedDependency *waitForNext ();
+
+    /**
+     * Records that a node returned from next() or waitForNext() has finished
+     * installing, which may make its dependents ready.
+     *
+     * Throws an exception if the node is not in progress.
+     */
+    void markCompleted (const ArbiterProjectIdentifier &project) noexcept(false);
+
+    /**
+     * Whether every node has been completed.
+     */
+    bool finished () const;
+
+    /**
+     * The total cost of the given node and its most expensive chain of
+     * dependents, which determines the order in which ready nodes are handed
+     * out.
+     */
+    double criticalPathCost (const ArbiterProjectIdentifier &project) const noexcept(false);
+
+    std::unique_ptr<Arbiter::Base> clone () const override;
+    std::ostream &describe (std::ostream &os) const override;
+    bool operator== (const Arbiter::Base &other) const override;
+
+  private:
+    enum class State
+    {
+      Waiting,
+      Ready,
+      InProgress,
+      Completed
+    };
+
+    struct Node final
+    {
+      public:
+        ArbiterResolvedDependency _dependency;
+        double _criticalPathCost;
+        size_t _remainingDependencies;
+        std::vector<size_t> _dependents;
+        State _state;
+
+        explicit Node (ArbiterResolvedDependency dependency)
+          : _dependency(std::move(dependency))
+          , _criticalPathCost(0)
+          , _remainingDependencies(0)
+          , _state(State::Waiting)
+        {}
+    };
+
+    /**
+     * Nodes in ascending order of their project identifiers.
+     */
+    std::vector<Node> _nodes;
+    std::unordered_map<ArbiterProjectIdentifier, size_t> _indexesByProject;
+
+    /**
+     * A heap of ready node indexes, ordered by readyAfter().
+     */
+    std::vector<size_t> _ready;
+
+    size_t _workerCount;
+    size_t _inProgressCount;
+    size_t _completedCount;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _condition;
+
+    /**
+     * Heap comparator which places higher critical path costs first, breaking
+     * ties by project identifier so that scheduling is deterministic.
+     */
+    bool readyAfter (size_t lhs, size_t rhs) const noexcept;
+
+    bool canStart () const noexcept;
+    const ArbiterResolvedDependency *start ();
+    void makeReady (size_t index);
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#ifndef __cplusplus
+#error "This file must be compiled as C++."
+#endif
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Arbiter {
+
+/**
+ * Computes SHA-256 digests incrementally.
+ */
+class Sha256 final
+{
+  public:
+    using Digest = std::array<unsigned char, 32>;
+
+    Sha256 () noexcept;
+
+    /**
+     * Appends `length` bytes to the message being digested.
+     */
+    void update (const void *bytes, size_t length) noexcept;
+
+    /**
+     * Finishes the message and returns its digest. The object must not be
+     * updated afterward.
+     */
+    Digest finish () noexcept;
+
+    /**
+     * Returns the given digest as lowercase hexadecimal.
+     */
+    static std::string hex (const Digest &digest);
+
+  private:
+    std::array<uint32_t, 8> _state;
+    std::array<unsigned char, 64> _block;
+    size_t _blockLength = 0;
+    uint64_t _messageLength = 0;
+
+    void compress (const unsigned char *block) noexcept;
+};
+
+} // namespace Arbiter
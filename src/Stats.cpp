@@ -2,16 +2,38 @@
 
 namespace Arbiter {
 
+namespace {
+
+std::ostream &operator<< (std::ostream &os, const Stats::MemoryUsage &usage)
+{
+  return os << usage._current << " bytes (peak " << usage._peak << " bytes)";
+}
+
+} // namespace
+
 std::ostream &operator<< (std::ostream &os, const Stats &stats)
 {
-  auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(*stats._endTime - *stats._startTime);
+  auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(stats.duration());
+  auto behaviorMs = std::chrono::duration_cast<std::chrono::milliseconds>(stats._behaviorDuration);
 
   return os
-    << "Duration: " << ms.count() << "ms\n"
-    << "Available version fetches: " << stats._availableVersionFetches << "\n"
-    << "Dependency list fetches: " << stats._dependencyListFetches << "\n"
-    << "Cached available versions size: ~" << stats._cachedAvailableVersionsSizeEstimate << " bytes (excl. user data)\n"
-    << "Cached dependency lists size: ~" << stats._cachedDependenciesSizeEstimate << " bytes (excl. user data)\n"
+    << "Duration: " << ms.count() << "ms (" << behaviorMs.count() << "ms in behaviors)\n"
+    << "Available version fetches: " << stats._availableVersionFetches << " (" << stats._availableVersionCacheHits << " cache hits)\n"
+    << "Dependency list fetches: " << stats._dependencyListFetches << " (" << stats._dependencyListCacheHits << " cache hits)\n"
+    << "Result cache hits: " << stats._resultCacheHits << "\n"
+    << "Selected version for metadata fetches: " << stats._selectedVersionForMetadataFetches << "\n"
+    << "Predicate cache: " << stats._predicateCacheHits << " hits, " << stats._predicateCacheMisses << " misses\n"
+    << "Cached available versions: " << stats._availableVersionsMemory << " (excl. user data)\n"
+    << "Cached dependency lists: " << stats._dependencyListsMemory << " (excl. user data)\n"
+    << "Candidate graphs: " << stats._candidateGraphMemory << "\n"
+    << "Search state: " << stats._searchStateMemory << "\n"
+    << "Requirements: " << stats._requirementMemory << " (process-wide)\n"
+    << "Arena reserved: " << stats._arenaReservedBytes << " bytes\n"
+    << "Permutations attempted: " << stats._permutationsAttempted << "\n"
+    << "Graph copies: " << stats._graphCopies << "\n"
+    << "Requirement intersections: " << stats._requirementIntersections << "\n"
+    << "Maximum depth: " << stats._maxDepth << "\n"
+    << "Peak candidates: " << stats._peakCandidates << "\n"
     << "Dead ends encountered: " << stats._deadEnds;
 }
 
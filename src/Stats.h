@@ -28,10 +28,68 @@ struct Stats final
     unsigned _deadEnds{0};
     unsigned _availableVersionFetches{0};
     unsigned _dependencyListFetches{0};
-    size_t _cachedDependenciesSizeEstimate{0};
-    size_t _cachedAvailableVersionsSizeEstimate{0};
+    unsigned _selectedVersionForMetadataFetches{0};
+
+    // Lookups which were answered without invoking the user's behaviors.
+    unsigned _availableVersionCacheHits{0};
+    unsigned _dependencyListCacheHits{0};
+
+    // Resolutions which were answered by an ArbiterResultCache.
+    unsigned _resultCacheHits{0};
+
+    // Lookups of custom predicate results in the PredicateCache.
+    unsigned _predicateCacheHits{0};
+    unsigned _predicateCacheMisses{0};
+
+    unsigned _permutationsAttempted{0};
+    unsigned _graphCopies{0};
+    unsigned _requirementIntersections{0};
+    unsigned _maxDepth{0};
+
+    // The most candidate versions permuted together at any one depth.
+    size_t _peakCandidates{0};
+
+    /**
+     * Bytes allocated for one purpose, when the measurement ended and at most
+     * during the measurement.
+     */
+    struct MemoryUsage final
+    {
+      public:
+        size_t _current{0};
+        size_t _peak{0};
+    };
+
+    // Memory used to cache available versions and dependency lists (excluding
+    // user data), to represent candidate graphs, for the rest of the search,
+    // and for requirements (across the whole process).
+    MemoryUsage _availableVersionsMemory;
+    MemoryUsage _dependencyListsMemory;
+    MemoryUsage _candidateGraphMemory;
+    MemoryUsage _searchStateMemory;
+    MemoryUsage _requirementMemory;
+
+    // Bytes reserved by the resolver's arena, whether in use or not.
+    size_t _arenaReservedBytes{0};
+
     Optional<Clock::time_point> _startTime;
     Optional<Clock::time_point> _endTime;
+
+    // Time spent waiting for the user's behaviors to return.
+    Clock::duration _behaviorDuration{0};
+
+    /**
+     * Returns the total time taken, or zero if the measurement has not
+     * finished.
+     */
+    Clock::duration duration () const noexcept
+    {
+      if (!_startTime || !_endTime) {
+        return Clock::duration(0);
+      }
+
+      return *_endTime - *_startTime;
+    }
 };
 
 std::ostream &operator<< (std::ostream &os, const Stats &stats);
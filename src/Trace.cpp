@@ -0,0 +1,185 @@
+#include "Trace.h"
+
+#include "Exception.h"
+#include "Project.h"
+#include "ToString.h"
+
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+namespace Arbiter {
+
+namespace {
+
+/**
+ * Appends `string` to `output` as a quoted JSON string.
+ */
+void appendJSONString (std::string &output, const std::string &string)
+{
+  output += '"';
+
+  for (char ch : string) {
+    switch (ch) {
+      case '"':
+        output += "\\\"";
+        break;
+
+      case '\\':
+        output += "\\\\";
+        break;
+
+      case '\n':
+        output += "\\n";
+        break;
+
+      case '\t':
+        output += "\\t";
+        break;
+
+      default:
+        if (static_cast<unsigned char>(ch) < 0x20) {
+          char escaped[8];
+          std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(static_cast<unsigned char>(ch)));
+          output += escaped;
+        } else {
+          output += ch;
+        }
+    }
+  }
+
+  output += '"';
+}
+
+char chromePhase (ArbiterTraceEventPhase phase) noexcept
+{
+  switch (phase) {
+    case ArbiterTraceEventPhaseBegin:
+      return 'B';
+
+    case ArbiterTraceEventPhaseEnd:
+      return 'E';
+
+    case ArbiterTraceEventPhaseInstant:
+      return 'i';
+  }
+
+  return 'i';
+}
+
+} // namespace
+
+const char *traceEventName (ArbiterTraceEventKind kind) noexcept
+{
+  switch (kind) {
+    case ArbiterTraceEventKindResolveLevel:
+      return "resolve level";
+
+    case ArbiterTraceEventKindPermutation:
+      return "permutation";
+
+    case ArbiterTraceEventKindFetchDependencyList:
+      return "createDependencyList";
+
+    case ArbiterTraceEventKindFetchAvailableVersions:
+      return "createAvailableVersionsList";
+
+    case ArbiterTraceEventKindConflict:
+      return "conflict";
+  }
+
+  return "unknown";
+}
+
+void Tracer::emit (ArbiterTraceEventKind kind, ArbiterTraceEventPhase phase, const ArbiterProjectIdentifier *project, const char *message) const
+{
+  assert(enabled());
+
+  if (kind == ArbiterTraceEventKindResolveLevel && phase == ArbiterTraceEventPhaseBegin) {
+    ++_depth;
+  }
+
+  ArbiterTraceEvent event;
+  event.kind = kind;
+  event.phase = phase;
+  event.name = traceEventName(kind);
+  event.timestampMicroseconds = std::chrono::duration<double, std::micro>(Clock::now() - _startTime).count();
+  event.depth = _depth;
+  event.project = project;
+  event.message = message;
+
+  if (kind == ArbiterTraceEventKindResolveLevel && phase == ArbiterTraceEventPhaseEnd) {
+    assert(_depth > 0);
+    --_depth;
+  }
+
+  _function(&event, _context.get());
+}
+
+ChromeTraceFile::ChromeTraceFile (const char *path) noexcept(false)
+  : _file(std::fopen(path, "w"))
+{
+  if (!_file) {
+    throw Exception::UserError(std::string("Could not open trace file ") + path + ": " + std::strerror(errno));
+  }
+
+  std::fputs("{\"traceEvents\":[", _file);
+}
+
+ChromeTraceFile::~ChromeTraceFile ()
+{
+  std::fputs("\n]}\n", _file);
+  std::fclose(_file);
+}
+
+void ChromeTraceFile::write (const ArbiterTraceEvent &event)
+{
+  std::string line(_first ? "\n" : ",\n");
+  _first = false;
+
+  line += "{\"name\":";
+  appendJSONString(line, event.name);
+  line += ",\"cat\":\"arbiter\",\"ph\":\"";
+  line += chromePhase(event.phase);
+  line += "\",\"ts\":";
+  char timestamp[32];
+  std::snprintf(timestamp, sizeof(timestamp), "%.3f", event.timestampMicroseconds);
+  line += timestamp;
+  line += ",\"pid\":1,\"tid\":1";
+
+  if (event.phase == ArbiterTraceEventPhaseInstant) {
+    // Scope instant events to the thread, rather than the whole process.
+    line += ",\"s\":\"t\"";
+  }
+
+  line += ",\"args\":{\"depth\":";
+  line += toString(event.depth);
+
+  if (event.project) {
+    line += ",\"project\":";
+    appendJSONString(line, toString(*event.project));
+  }
+
+  if (event.message) {
+    line += ",\"message\":";
+    appendJSONString(line, event.message);
+  }
+
+  line += "}}";
+
+  std::fwrite(line.data(), 1, line.size(), _file);
+}
+
+void ChromeTraceFile::flush ()
+{
+  std::fflush(_file);
+}
+
+void ChromeTraceFile::traceFunction (const ArbiterTraceEvent *event, const void *context)
+{
+  // The file is only ever shared with the tracer that writes to it.
+  const_cast<ChromeTraceFile *>(static_cast<const ChromeTraceFile *>(context))->write(*event);
+}
+
+} // namespace Arbiter
@@ -0,0 +1,144 @@
+#pragma once
+
+#ifndef __cplusplus
+#error "This file must be compiled as C++."
+#endif
+
+#include <arbiter/Trace.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+
+namespace Arbiter {
+
+/**
+ * Emits trace events to a user-provided function, if one has been set.
+ *
+ * Callers should check that the tracer is enabled before preparing an event,
+ * so that tracing costs nothing more than that branch while disabled.
+ */
+class Tracer final
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Creates a disabled tracer.
+     */
+    Tracer () = default;
+
+    Tracer (ArbiterTraceFunction function, std::shared_ptr<const void> context)
+      : _function(function)
+      , _context(std::move(context))
+      , _startTime(Clock::now())
+    {}
+
+    bool enabled () const noexcept
+    {
+      return _function != nullptr;
+    }
+
+    explicit operator bool () const noexcept
+    {
+      return enabled();
+    }
+
+    /**
+     * Emits an event with the current time, at the depth of the innermost
+     * resolve level which has begun but not ended.
+     *
+     * The tracer must be enabled.
+     */
+    void emit (ArbiterTraceEventKind kind, ArbiterTraceEventPhase phase, const ArbiterProjectIdentifier *project = nullptr, const char *message = nullptr) const;
+
+    /**
+     * Returns the context that the trace function was set with.
+     */
+    const std::shared_ptr<const void> &context () const noexcept
+    {
+      return _context;
+    }
+
+  private:
+    ArbiterTraceFunction _function = nullptr;
+    std::shared_ptr<const void> _context;
+    Clock::time_point _startTime;
+    mutable size_t _depth = 0;
+};
+
+/**
+ * Emits a begin event when constructed and the matching end event when
+ * destroyed (including during exception unwinding), if the tracer is enabled.
+ */
+class TraceScope final
+{
+  public:
+    TraceScope (const Tracer &tracer, ArbiterTraceEventKind kind, const ArbiterProjectIdentifier *project = nullptr)
+      : _tracer(tracer.enabled() ? &tracer : nullptr)
+      , _kind(kind)
+      , _project(project)
+    {
+      if (_tracer) {
+        _tracer->emit(_kind, ArbiterTraceEventPhaseBegin, _project);
+      }
+    }
+
+    TraceScope (const TraceScope &) = delete;
+    TraceScope &operator= (const TraceScope &) = delete;
+
+    ~TraceScope ()
+    {
+      if (_tracer) {
+        _tracer->emit(_kind, ArbiterTraceEventPhaseEnd, _project);
+      }
+    }
+
+  private:
+    const Tracer *_tracer;
+    ArbiterTraceEventKind _kind;
+    const ArbiterProjectIdentifier *_project;
+};
+
+/**
+ * Writes trace events to a file in the Chrome trace event format.
+ */
+class ChromeTraceFile final
+{
+  public:
+    /**
+     * Opens the file at `path` for writing, replacing anything already there.
+     *
+     * Throws an exception if the file cannot be opened.
+     */
+    explicit ChromeTraceFile (const char *path) noexcept(false);
+
+    ChromeTraceFile (const ChromeTraceFile &) = delete;
+    ChromeTraceFile &operator= (const ChromeTraceFile &) = delete;
+
+    /**
+     * Completes and closes the file.
+     */
+    ~ChromeTraceFile ();
+
+    void write (const ArbiterTraceEvent &event);
+    void flush ();
+
+    /**
+     * An ArbiterTraceFunction which writes to the ChromeTraceFile given as its
+     * context.
+     */
+    static void traceFunction (const ArbiterTraceEvent *event, const void *context);
+
+  private:
+    std::FILE *_file;
+    bool _first = true;
+};
+
+/**
+ * Returns a name describing events of the given kind.
+ */
+const char *traceEventName (ArbiterTraceEventKind kind) noexcept;
+
+} // namespace Arbiter
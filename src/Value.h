@@ -6,12 +6,16 @@
 
 #include <arbiter/Value.h>
 
+#include "Optional.h"
 #include "ToString.h"
 
 #include <cassert>
+#include <cstdlib>
+#include <cstring>
 #include <functional>
 #include <memory>
 #include <ostream>
+#include <string>
 
 namespace Arbiter {
 
@@ -36,14 +40,50 @@ class SharedUserValue final
       , _lessThan(value.lessThan)
       , _hash(value.hash)
       , _createDescription(value.createDescription)
+      , _createSerialization(value.createSerialization)
     {
       assert(_equalTo);
       assert(_lessThan);
       assert(_hash);
+
+      _hashValue = _hash(data());
+    }
+
+    /**
+     * Creates a value which holds the given string natively, so that it can be
+     * hashed and compared without any indirect calls.
+     *
+     * data() will return the string as a NUL-terminated C string. The string
+     * is shared between copies of the value, and freed along with the last
+     * one.
+     *
+     * String values always order before values created from an
+     * ArbiterUserValue, and are never equal to them.
+     */
+    explicit SharedUserValue (std::string string)
+      : _string(std::make_shared<const std::string>(std::move(string)))
+      , _equalTo(&stringEqualTo)
+      , _lessThan(&stringLessThan)
+      , _hash(&stringHash)
+      , _createDescription(&stringCreateDescription)
+    {
+      _data = std::shared_ptr<void>(_string, const_cast<char *>(_string->c_str()));
+      _hashValue = std::hash<std::string>()(*_string);
     }
 
     bool operator== (const SharedUserValue &other) const
     {
+      // Avoid calling into user code when the answer is already known.
+      if (data() == other.data()) {
+        return true;
+      } else if (_hashValue != other._hashValue) {
+        return false;
+      } else if (bool(_string) != bool(other._string)) {
+        return false;
+      } else if (_string) {
+        return *_string == *other._string;
+      }
+
       assert(_equalTo == other._equalTo);
       return _equalTo(data(), other.data());
     }
@@ -55,6 +95,14 @@ class SharedUserValue final
 
     bool operator< (const SharedUserValue &other) const
     {
+      // Order by kind first, so that user code is only ever passed values
+      // that it created.
+      if (bool(_string) != bool(other._string)) {
+        return bool(_string);
+      } else if (_string) {
+        return *_string < *other._string;
+      }
+
       assert(_lessThan == other._lessThan);
       return _lessThan(data(), other.data());
     }
@@ -86,27 +134,87 @@ class SharedUserValue final
 
     std::string description () const
     {
-      if (_createDescription) {
+      if (_string) {
+        return *_string;
+      } else if (_createDescription) {
         return Arbiter::copyAcquireCString(_createDescription(data()));
       } else {
         return "Arbiter::SharedUserValue";
       }
     }
 
-    size_t hash () const
+    /**
+     * Returns the string that this value was created from, or null if it was
+     * created from an ArbiterUserValue.
+     */
+    const std::string *string () const noexcept
+    {
+      return _string.get();
+    }
+
+    /**
+     * Serializes a value created from an ArbiterUserValue, using its
+     * `createSerialization` callback.
+     *
+     * Returns None if the value has no such callback.
+     */
+    Optional<std::string> serialize () const
+    {
+      if (!_createSerialization) {
+        return None();
+      }
+
+      size_t length = 0;
+      std::unique_ptr<char[], decltype(&free)> bytes(static_cast<char *>(_createSerialization(data(), &length)), &free);
+
+      return makeOptional(bytes ? std::string(bytes.get(), length) : std::string());
+    }
+
+    /**
+     * Returns the hash of the value, which is computed once upon creation.
+     */
+    size_t hash () const noexcept
     {
-      return _hash(data());
+      return _hashValue;
     }
 
   private:
+    // Set if this value was created from a string, instead of an
+    // ArbiterUserValue. `_data` points into it.
+    std::shared_ptr<const std::string> _string;
+
     std::shared_ptr<void> _data;
     bool (*_equalTo)(const void *first, const void *second);
     bool (*_lessThan)(const void *first, const void *second);
     size_t (*_hash)(const void *data);
     char *(*_createDescription)(const void *data);
+    void *(*_createSerialization)(const void *data, size_t *length) = nullptr;
+    size_t _hashValue = 0;
 
     static void noOpDestructor (void *)
     {}
+
+    static bool stringEqualTo (const void *first, const void *second)
+    {
+      return std::strcmp(static_cast<const char *>(first), static_cast<const char *>(second)) == 0;
+    }
+
+    static bool stringLessThan (const void *first, const void *second)
+    {
+      return std::strcmp(static_cast<const char *>(first), static_cast<const char *>(second)) < 0;
+    }
+
+    static size_t stringHash (const void *data)
+    {
+      return std::hash<std::string>()(static_cast<const char *>(data));
+    }
+
+    static char *stringCreateDescription (const void *data)
+    {
+      // Descriptions are freed with free().
+      size_t size = std::strlen(static_cast<const char *>(data)) + 1;
+      return static_cast<char *>(std::memcpy(std::malloc(size), data, size));
+    }
 };
 
 /**
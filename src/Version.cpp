@@ -1,9 +1,12 @@
 #include "Version.h"
 
 #include "Hash.h"
+#include "ToString.h"
 
+#include <algorithm>
+#include <cstring>
+#include <limits>
 #include <ostream>
-#include <regex>
 #include <sstream>
 #include <string>
 
@@ -23,45 +26,240 @@ size_t std::hash<ArbiterSelectedVersion>::operator() (const ArbiterSelectedVersi
   return hashOf(version._semanticVersion) ^ hashOf(version._metadata);
 }
 
-Optional<ArbiterSemanticVersion> ArbiterSemanticVersion::fromString (const std::string &versionString)
+namespace {
+
+/**
+ * The pieces of a semantic version string, as found by parseVersion().
+ *
+ * The prerelease version and build metadata refer into the original string,
+ * and are null if not present.
+ */
+struct ParsedVersion final
+{
+  public:
+    unsigned _major = 0;
+    unsigned _minor = 0;
+    unsigned _patch = 0;
+
+    const char *_prereleaseVersion = nullptr;
+    size_t _prereleaseLength = 0;
+
+    const char *_buildMetadata = nullptr;
+    size_t _buildMetadataLength = 0;
+};
+
+bool isDigit (char ch) noexcept
+{
+  return ch >= '0' && ch <= '9';
+}
+
+bool isIdentifierCharacter (char ch) noexcept
+{
+  return isDigit(ch) || (ch >= 'A' && ch <= 'Z') || (ch >= 'a' && ch <= 'z') || ch == '-';
+}
+
+/**
+ * Parses a version number starting at `cursor`, advancing it past the number.
+ *
+ * Returns a description of the problem if parsing fails, in which case
+ * `cursor` will point at the offending character.
+ */
+const char *parseNumber (const char *&cursor, const char *end, unsigned &value) noexcept
+{
+  if (cursor == end || !isDigit(*cursor)) {
+    return "expected a digit";
+  }
+
+  // Versions cannot have a leading zero.
+  if (*cursor == '0' && cursor + 1 != end && isDigit(cursor[1])) {
+    return "version numbers cannot have a leading zero";
+  }
+
+  const char *start = cursor;
+  unsigned long long result = 0;
+
+  do {
+    result = result * 10 + unsigned(*cursor - '0');
+    if (result > std::numeric_limits<unsigned>::max()) {
+      cursor = start;
+      return "version number is too large";
+    }
+
+    ++cursor;
+  } while (cursor != end && isDigit(*cursor));
+
+  value = unsigned(result);
+  return nullptr;
+}
+
+/**
+ * Parses a dot-separated list of identifiers starting at `cursor`, advancing it
+ * to the first character after the list, which will either be `terminator` or
+ * the end of the string.
+ *
+ * Returns a description of the problem if parsing fails, in which case
+ * `cursor` will point at the offending character.
+ */
+const char *parseDottedIdentifier (const char *&cursor, const char *end, char terminator) noexcept
 {
-  // Versions and identifiers cannot have a leading zero.
-  #define VERSION "(0|[1-9][0-9]*)"
-  #define IDENTIFIER "(?:0|[1-9A-Za-z-][0-9A-Za-z-]*)"
-  #define DOTTED_IDENTIFIER "(" IDENTIFIER "(?:\\." IDENTIFIER ")*)"
+  while (true) {
+    const char *start = cursor;
+
+    while (cursor != end && isIdentifierCharacter(*cursor)) {
+      ++cursor;
+    }
+
+    if (cursor == start) {
+      return "expected an identifier";
+    }
+
+    // Identifiers cannot have a leading zero.
+    if (*start == '0' && cursor - start > 1) {
+      cursor = start;
+      return "identifiers cannot have a leading zero";
+    }
 
-  std::regex pattern {
-    VERSION "\\." VERSION "\\." VERSION
-    // prerelease begins with a hyphen followed by a dot separated identifier
-    "(?:"   "-" DOTTED_IDENTIFIER ")?"
-    // metadata begins with a plus sign followed by a dot separated identifier
-    "(?:" "\\+" DOTTED_IDENTIFIER ")?"
-  };
+    if (cursor == end || *cursor == terminator) {
+      return nullptr;
+    } else if (*cursor != '.') {
+      return "invalid character in identifier";
+    }
 
-  #undef DOTTED_IDENTIFIER
-  #undef IDENTIFIER
-  #undef VERSION
+    ++cursor;
+  }
+}
 
-  std::smatch match;
-  if (!std::regex_match(versionString, match, pattern)) {
-    return Optional<ArbiterSemanticVersion>();
+/**
+ * Parses a complete semantic version from the given range of characters,
+ * without allocating.
+ *
+ * Returns a description of the problem if parsing fails, in which case
+ * `failure` will be set to the offending character.
+ */
+const char *parseVersion (const char *begin, const char *end, ParsedVersion &parsed, const char *&failure) noexcept
+{
+  const char *cursor = begin;
+  const char *reason = nullptr;
+
+  if ((reason = parseNumber(cursor, end, parsed._major))) {
+    failure = cursor;
+    return reason;
+  }
+
+  if (cursor == end || *cursor != '.') {
+    failure = cursor;
+    return "expected '.' after major version";
   }
 
-  unsigned major = std::stoul(match.str(1));
-  unsigned minor = std::stoul(match.str(2));
-  unsigned patch = std::stoul(match.str(3));
+  ++cursor;
+
+  if ((reason = parseNumber(cursor, end, parsed._minor))) {
+    failure = cursor;
+    return reason;
+  }
+
+  if (cursor == end || *cursor != '.') {
+    failure = cursor;
+    return "expected '.' after minor version";
+  }
+
+  ++cursor;
+
+  if ((reason = parseNumber(cursor, end, parsed._patch))) {
+    failure = cursor;
+    return reason;
+  }
+
+  // prerelease begins with a hyphen followed by a dot separated identifier
+  if (cursor != end && *cursor == '-') {
+    parsed._prereleaseVersion = ++cursor;
+
+    if ((reason = parseDottedIdentifier(cursor, end, '+'))) {
+      failure = cursor;
+      return reason;
+    }
+
+    parsed._prereleaseLength = size_t(cursor - parsed._prereleaseVersion);
+  }
+
+  // metadata begins with a plus sign followed by a dot separated identifier
+  if (cursor != end && *cursor == '+') {
+    parsed._buildMetadata = ++cursor;
+
+    if ((reason = parseDottedIdentifier(cursor, end, '\0'))) {
+      failure = cursor;
+      return reason;
+    }
+
+    parsed._buildMetadataLength = size_t(cursor - parsed._buildMetadata);
+  }
+
+  if (cursor != end) {
+    failure = cursor;
+    return "expected '-', '+', or end of version after patch version";
+  }
+
+  return nullptr;
+}
+
+/**
+ * Splits a string of dot-separated identifiers, appending each one to
+ * `identifiers`.
+ */
+void splitIdentifiers (const std::string &string, std::vector<VersionIdentifier> &identifiers)
+{
+  size_t start = 0;
+
+  while (true) {
+    size_t dot = string.find('.', start);
+    size_t end = (dot == std::string::npos ? string.size() : dot);
+
+    identifiers.emplace_back(string.data() + start, end - start);
+
+    if (dot == std::string::npos) {
+      break;
+    }
+
+    start = dot + 1;
+  }
+}
+
+} // namespace
+
+Optional<ArbiterSemanticVersion> ArbiterSemanticVersion::fromString (const std::string &versionString, std::string *error)
+{
+  return fromString(versionString.data(), versionString.size(), error);
+}
+
+Optional<ArbiterSemanticVersion> ArbiterSemanticVersion::fromString (const char *string, size_t length, std::string *error)
+{
+  ParsedVersion parsed;
+  const char *failure = nullptr;
+
+  if (const char *reason = parseVersion(string, string + length, parsed, failure)) {
+    if (error) {
+      std::ostringstream stream;
+      stream << reason << " at offset " << (failure - string) << " in version \"";
+      stream.write(string, std::streamsize(length));
+      stream << "\"";
+
+      *error = stream.str();
+    }
+
+    return None();
+  }
 
   Optional<std::string> prereleaseVersion;
   Optional<std::string> buildMetadata;
 
-  if (match.length(4) > 0) {
-    prereleaseVersion = Optional<std::string>(match.str(4));
+  if (parsed._prereleaseVersion) {
+    prereleaseVersion = Optional<std::string>(std::string(parsed._prereleaseVersion, parsed._prereleaseLength));
   }
-  if (match.length(5) > 0) {
-    buildMetadata = Optional<std::string>(match.str(5));
+  if (parsed._buildMetadata) {
+    buildMetadata = Optional<std::string>(std::string(parsed._buildMetadata, parsed._buildMetadataLength));
   }
 
-  return ArbiterSemanticVersion(major, minor, patch, prereleaseVersion, buildMetadata);
+  return ArbiterSemanticVersion(parsed._major, parsed._minor, parsed._patch, std::move(prereleaseVersion), std::move(buildMetadata));
 }
 
 std::unique_ptr<Arbiter::Base> ArbiterSemanticVersion::clone () const
@@ -91,94 +289,130 @@ bool ArbiterSemanticVersion::operator== (const Arbiter::Base &other) const
     return false;
   }
 
-  return _major == ptr->_major && _minor == ptr->_minor && _patch == ptr->_patch && _prereleaseVersion == ptr->_prereleaseVersion && _buildMetadata == ptr->_buildMetadata;
+  // Comparing the interned identifiers is equivalent to comparing the
+  // original prerelease strings, as long as presence is checked too.
+  return _precedenceKey == ptr->_precedenceKey
+    && _major == ptr->_major
+    && _minor == ptr->_minor
+    && _patch == ptr->_patch
+    && bool(_prereleaseVersion) == bool(ptr->_prereleaseVersion)
+    && _prereleaseIdentifiers == ptr->_prereleaseIdentifiers
+    && _buildMetadata == ptr->_buildMetadata;
 }
 
 bool ArbiterSemanticVersion::operator< (const ArbiterSemanticVersion &other) const noexcept
 {
-  if (_major < other._major) {
-    return true;
-  } else if (_major > other._major) {
-    return false;
-  }
-
-  if (_minor < other._minor) {
-    return true;
-  } else if (_minor > other._minor) {
-    return false;
+  if (_precedenceKey != other._precedenceKey) {
+    return _precedenceKey < other._precedenceKey;
   }
 
-  if (_patch < other._patch) {
-    return true;
-  } else if (_patch > other._patch) {
-    return false;
+  if (!_precedenceKeyExact || !other._precedenceKeyExact) {
+    // At least one component was saturated, so the keys may be equal even if
+    // the components are not.
+    if (_major != other._major) {
+      return _major < other._major;
+    } else if (_minor != other._minor) {
+      return _minor < other._minor;
+    } else if (_patch != other._patch) {
+      return _patch < other._patch;
+    }
   }
 
   if (_prereleaseVersion) {
     if (!other._prereleaseVersion) {
       return true;
     }
-    
-    std::istringstream left(*_prereleaseVersion);
-    std::istringstream right(*other._prereleaseVersion);
-
-    while (true) {
-      std::string leftPiece;
-      std::string rightPiece;
-
-      if (!std::getline(left, leftPiece, '.')) {
-        if (std::getline(right, rightPiece, '.')) {
-          // `left` is shorter, therefore lower precedence
-          return true;
-        } else {
-          // Equivalent prerelease versions
-          return false;
-        }
-      } else if (!std::getline(right, rightPiece, '.')) {
-        // `right` is shorter, therefore `left` is higher precedence
-        return false;
-      }
+  } else {
+    // Build metadata does not participate in precedence.
+    return false;
+  }
 
-      Optional<unsigned long> leftNum;
-      Optional<unsigned long> rightNum;
+  size_t count = std::min(_prereleaseIdentifiers.size(), other._prereleaseIdentifiers.size());
 
-      try {
-        leftNum = std::stoul(leftPiece);
-      } catch (std::invalid_argument &ex) {
-      }
+  for (size_t i = 0; i < count; i++) {
+    int order = _prereleaseIdentifiers[i].compare(other._prereleaseIdentifiers[i]);
+    if (order != 0) {
+      return order < 0;
+    }
+  }
 
-      try {
-        rightNum = std::stoul(rightPiece);
-      } catch (std::invalid_argument &ex) {
-      }
+  // If all else is equal, the shorter prerelease version has lower precedence.
+  return _prereleaseIdentifiers.size() < other._prereleaseIdentifiers.size();
+}
 
-      if (leftNum) {
-        if (rightNum) {
-          if (*leftNum < *rightNum) {
-            return true;
-          } else if (*leftNum > *rightNum) {
-            return false;
-          }
-        } else {
-          // `left` has lower precedence because it is numeric
-          return true;
-        }
-      } else if (rightNum) {
-        // `left` has higher precedence because it is non-numeric
-        return false;
-      } else {
-        // Compare strings lexically
-        if (leftPiece < rightPiece) {
-          return true;
-        } else if (leftPiece > rightPiece) {
-          return false;
-        }
-      }
+void ArbiterSemanticVersion::precompute ()
+{
+  constexpr unsigned componentBits = 21;
+  constexpr uint64_t componentMax = (uint64_t(1) << componentBits) - 1;
+
+  // A component which doesn't fit is saturated to the maximum value, and
+  // everything after it left as zero, so that the key still never orders
+  // versions incorrectly. Versions which reach this point are compared by
+  // their components instead.
+  _precedenceKeyExact = true;
+  _precedenceKey = 0;
+
+  const unsigned components[] = { _major, _minor, _patch };
+  for (unsigned component : components) {
+    _precedenceKey <<= componentBits;
+
+    if (!_precedenceKeyExact) {
+      continue;
+    }
+
+    if (component >= componentMax) {
+      _precedenceKey |= componentMax;
+      _precedenceKeyExact = false;
+    } else {
+      _precedenceKey |= component;
+    }
+  }
+
+  _precedenceKey <<= 1;
+  if (_precedenceKeyExact && !_prereleaseVersion) {
+    _precedenceKey |= 1;
+  }
+
+  _prereleaseIdentifiers.clear();
+  if (_prereleaseVersion) {
+    splitIdentifiers(*_prereleaseVersion, _prereleaseIdentifiers);
+  }
+}
+
+VersionIdentifier::VersionIdentifier (const char *string, size_t length)
+  : _numeric(length > 0)
+  , _number(0)
+  , _string(string, length)
+{
+  for (size_t i = 0; i < length; i++) {
+    char ch = string[i];
+    uint64_t digit = uint64_t(ch - '0');
+
+    if (!isDigit(ch) || _number > (std::numeric_limits<uint64_t>::max() - digit) / 10) {
+      _numeric = false;
+      _number = 0;
+      break;
     }
+
+    _number = _number * 10 + digit;
   }
+}
+
+int VersionIdentifier::compare (const VersionIdentifier &other) const noexcept
+{
+  if (_numeric) {
+    if (!other._numeric) {
+      // Numeric identifiers have lower precedence than alphanumeric ones.
+      return -1;
+    }
 
-  // Build metadata does not participate in precedence.
-  return false;
+    return (_number > other._number) - (_number < other._number);
+  } else if (other._numeric) {
+    return 1;
+  } else {
+    // Compare strings lexically
+    return _string.compare(other._string);
+  }
 }
 
 std::unique_ptr<Arbiter::Base> ArbiterSelectedVersion::clone () const
@@ -213,6 +447,8 @@ bool ArbiterSelectedVersion::operator< (const ArbiterSelectedVersion &other) con
     if (other._semanticVersion) {
       if (*_semanticVersion < *other._semanticVersion) {
         return true;
+      } else if (*other._semanticVersion < *_semanticVersion) {
+        return false;
       }
     } else {
       // Versions with a semantic version component should have higher
@@ -276,14 +512,39 @@ ArbiterSemanticVersion *ArbiterCreateSemanticVersion (unsigned major, unsigned m
 
 ArbiterSemanticVersion *ArbiterCreateSemanticVersionFromString (const char *string)
 {
-  auto version = ArbiterSemanticVersion::fromString(string);
+  return ArbiterCreateSemanticVersionFromBuffer(string, strlen(string), nullptr);
+}
+
+ArbiterSemanticVersion *ArbiterCreateSemanticVersionFromBuffer (const char *buffer, size_t length, char **error)
+{
+  std::string errorString;
+
+  auto version = ArbiterSemanticVersion::fromString(buffer, length, (error ? &errorString : nullptr));
   if (version) {
     return new ArbiterSemanticVersion(std::move(version.value()));
   } else {
+    if (error) {
+      *error = copyCString(errorString).release();
+    }
+
     return nullptr;
   }
 }
 
+size_t ArbiterCreateSemanticVersionsFromStrings (const char * const *strings, size_t count, ArbiterSemanticVersion **versions)
+{
+  size_t parsedCount = 0;
+
+  for (size_t i = 0; i < count; i++) {
+    versions[i] = ArbiterCreateSemanticVersionFromBuffer(strings[i], strlen(strings[i]), nullptr);
+    if (versions[i]) {
+      ++parsedCount;
+    }
+  }
+
+  return parsedCount;
+}
+
 unsigned ArbiterGetMajorVersion (const ArbiterSemanticVersion *version)
 {
   return version->_major;
@@ -333,6 +594,11 @@ ArbiterSelectedVersion *ArbiterCreateSelectedVersion (const ArbiterSemanticVersi
   return new ArbiterSelectedVersion(Optional<ArbiterSemanticVersion>::fromPointer(semanticVersion), ArbiterSelectedVersion::Metadata(metadata));
 }
 
+ArbiterSelectedVersion *ArbiterCreateSelectedVersionWithStringMetadata (const ArbiterSemanticVersion *semanticVersion, const char *metadata, size_t length)
+{
+  return new ArbiterSelectedVersion(Optional<ArbiterSemanticVersion>::fromPointer(semanticVersion), ArbiterSelectedVersion::Metadata(std::string(metadata, length)));
+}
+
 const ArbiterSemanticVersion *ArbiterSelectedVersionSemanticVersion (const ArbiterSelectedVersion *version)
 {
   return version->_semanticVersion.pointer();
@@ -354,3 +620,8 @@ ArbiterSelectedVersionList *ArbiterCreateSelectedVersionList (const ArbiterSelec
 
   return new ArbiterSelectedVersionList(std::move(vec));
 }
+
+size_t ArbiterSelectedVersionListCount (const ArbiterSelectedVersionList *versionList)
+{
+  return versionList->_versions.size();
+}
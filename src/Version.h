@@ -6,14 +6,61 @@
 
 #include <arbiter/Version.h>
 
+#include "InternedString.h"
 #include "Optional.h"
 #include "Types.h"
 #include "Value.h"
 
+#include <cstdint>
 #include <functional>
 #include <string>
 #include <vector>
 
+namespace Arbiter {
+
+/**
+ * One dot-separated identifier from a prerelease version, classified ahead of
+ * time so that comparing versions does not need to
+ * re-parse it.
+ */
+struct VersionIdentifier final
+{
+  public:
+    /**
+     * Whether the identifier consists only of digits. Numeric identifiers which
+     * do not fit into 64 bits are treated as alphanumeric.
+     */
+    bool _numeric;
+
+    /**
+     * The value of a numeric identifier, or zero otherwise.
+     */
+    uint64_t _number;
+
+    InternedString _string;
+
+    VersionIdentifier (const char *string, size_t length);
+
+    /**
+     * Orders two identifiers by semver precedence, returning a negative number,
+     * zero, or a positive number if this identifier is lower than, equal to, or
+     * higher than `other`, respectively.
+     */
+    int compare (const VersionIdentifier &other) const noexcept;
+
+    bool operator== (const VersionIdentifier &other) const noexcept
+    {
+      return _string == other._string;
+    }
+
+    bool operator!= (const VersionIdentifier &other) const noexcept
+    {
+      return !(*this == other);
+    }
+};
+
+} // namespace Arbiter
+
 struct ArbiterSemanticVersion final : public Arbiter::Base
 {
   public:
@@ -24,19 +71,50 @@ struct ArbiterSemanticVersion final : public Arbiter::Base
     Arbiter::Optional<std::string> _prereleaseVersion;
     Arbiter::Optional<std::string> _buildMetadata;
 
+    /**
+     * The major, minor, and patch components packed into 21 bits each, followed
+     * by a bit which is set if there is no prerelease version.
+     *
+     * If two versions have different keys, comparing the keys orders the
+     * versions correctly. If a component does not fit into 21 bits, the key
+     * cannot represent the version completely, `_precedenceKeyExact` is false,
+     * and versions with equal keys must compare their components instead.
+     */
+    uint64_t _precedenceKey;
+    bool _precedenceKeyExact;
+
+    /**
+     * The dot-separated identifiers of `_prereleaseVersion`, which are only
+     * compared when two versions otherwise have the same precedence.
+     */
+    std::vector<Arbiter::VersionIdentifier> _prereleaseIdentifiers;
+
     ArbiterSemanticVersion (unsigned major, unsigned minor, unsigned patch, Arbiter::Optional<std::string> prereleaseVersion = Arbiter::Optional<std::string>(), Arbiter::Optional<std::string> buildMetadata = Arbiter::Optional<std::string>())
       : _major(major)
       , _minor(minor)
       , _patch(patch)
       , _prereleaseVersion(prereleaseVersion)
       , _buildMetadata(buildMetadata)
-    {}
+    {
+      precompute();
+    }
 
     /**
      * Attempts to parse a well-formed semantic version from a string.
+     *
+     * If parsing fails and `error` is not null, it will be set to a message
+     * describing the problem and where it occurred.
      */
-    // TODO: Add error reporting
-    static Arbiter::Optional<ArbiterSemanticVersion> fromString (const std::string &versionString);
+    static Arbiter::Optional<ArbiterSemanticVersion> fromString (const std::string &versionString, std::string *error = nullptr);
+
+    /**
+     * Attempts to parse a well-formed semantic version from the first `length`
+     * characters of `string`, which need not be NUL-terminated.
+     *
+     * The string is scanned in a single pass, and memory is only allocated for
+     * the resulting prerelease version and build metadata (or error message).
+     */
+    static Arbiter::Optional<ArbiterSemanticVersion> fromString (const char *string, size_t length, std::string *error = nullptr);
 
     std::unique_ptr<Arbiter::Base> clone () const override;
     std::ostream &describe (std::ostream &os) const override;
@@ -58,6 +136,17 @@ struct ArbiterSemanticVersion final : public Arbiter::Base
     {
       return other >= *this;
     }
+
+  private:
+    /**
+     * Fills in the precedence key and prerelease identifiers from the other
+     * components.
+     *
+     * Build metadata is left as an owned string rather than being split into
+     * interned identifiers, since it often holds unique values (like commit
+     * SHAs) which would otherwise accumulate in the global pool forever.
+     */
+    void precompute ();
 };
 
 struct ArbiterSelectedVersion final : public Arbiter::Base
@@ -0,0 +1,144 @@
+#include "VersionBlock.h"
+
+#include <algorithm>
+#include <limits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace Arbiter {
+
+static_assert(sizeof(unsigned) == 4, "SIMD comparisons assume 32-bit version components");
+
+void compareComponents (const unsigned *values, size_t count, unsigned base, uint64_t *equal, uint64_t *greater) noexcept
+{
+  std::fill(equal, equal + maskWordCount(count), 0);
+  std::fill(greater, greater + maskWordCount(count), 0);
+
+  size_t i = 0;
+
+  // SIMD integer comparisons are signed, so both sides are biased by flipping
+  // their sign bits, which preserves unsigned ordering.
+  //
+  // Lanes are processed in groups which evenly divide 64, so one group never
+  // straddles two words of the output masks.
+#if defined(__AVX2__)
+  const __m256i bias = _mm256_set1_epi32(std::numeric_limits<int>::min());
+  const __m256i biasedBase = _mm256_xor_si256(_mm256_set1_epi32(static_cast<int>(base)), bias);
+
+  for (; i + 8 <= count; i += 8) {
+    __m256i biased = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + i)), bias);
+
+    uint64_t eq = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(biased, biasedBase))));
+    uint64_t gt = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(biased, biasedBase))));
+
+    equal[i / 64] |= eq << (i % 64);
+    greater[i / 64] |= gt << (i % 64);
+  }
+#elif defined(__SSE2__)
+  const __m128i bias = _mm_set1_epi32(std::numeric_limits<int>::min());
+  const __m128i biasedBase = _mm_xor_si128(_mm_set1_epi32(static_cast<int>(base)), bias);
+
+  for (; i + 4 <= count; i += 4) {
+    __m128i biased = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(values + i)), bias);
+
+    uint64_t eq = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(biased, biasedBase))));
+    uint64_t gt = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(biased, biasedBase))));
+
+    equal[i / 64] |= eq << (i % 64);
+    greater[i / 64] |= gt << (i % 64);
+  }
+#endif
+
+  for (; i < count; i++) {
+    if (values[i] == base) {
+      maskSet(equal, i);
+    } else if (values[i] > base) {
+      maskSet(greater, i);
+    }
+  }
+}
+
+void VersionBlock::append (const ArbiterSelectedVersion &version)
+{
+  size_t index = _versions.size();
+  if (index % 64 == 0) {
+    _semantic.emplace_back(0);
+    _prerelease.emplace_back(0);
+  }
+
+  _versions.emplace_back(&version);
+
+  if (const ArbiterSemanticVersion *semanticVersion = version._semanticVersion.pointer()) {
+    _majors.emplace_back(semanticVersion->_major);
+    _minors.emplace_back(semanticVersion->_minor);
+    _patches.emplace_back(semanticVersion->_patch);
+
+    maskSet(_semantic.data(), index);
+    if (semanticVersion->_prereleaseVersion) {
+      maskSet(_prerelease.data(), index);
+    }
+  } else {
+    _majors.emplace_back(0);
+    _minors.emplace_back(0);
+    _patches.emplace_back(0);
+  }
+}
+
+void VersionBlock::fillMask (uint64_t *mask) const noexcept
+{
+  size_t words = wordCount();
+  std::fill(mask, mask + words, ~uint64_t(0));
+
+  if (size_t remainder = size() % 64) {
+    mask[words - 1] = (uint64_t(1) << remainder) - 1;
+  }
+}
+
+VersionBlockComparison::VersionBlockComparison (const VersionBlock &block, const ArbiterSemanticVersion &base)
+  : _majorEqual(block.wordCount())
+  , _minorEqual(block.wordCount())
+  , _patchEqual(block.wordCount())
+  , _atLeast(block.wordCount())
+  , _undecided(block.wordCount())
+{
+  const size_t count = block.size();
+  const size_t words = block.wordCount();
+
+  std::vector<uint64_t> majorGreater(words);
+  std::vector<uint64_t> minorGreater(words);
+  std::vector<uint64_t> patchGreater(words);
+
+  compareComponents(block.majors(), count, base._major, _majorEqual.data(), majorGreater.data());
+  compareComponents(block.minors(), count, base._minor, _minorEqual.data(), minorGreater.data());
+  compareComponents(block.patches(), count, base._patch, _patchEqual.data(), patchGreater.data());
+
+  const bool basePrerelease = static_cast<bool>(base._prereleaseVersion);
+
+  for (size_t word = 0; word < words; word++) {
+    const uint64_t semantic = block.semanticMask()[word];
+    const uint64_t prerelease = block.prereleaseMask()[word];
+
+    _majorEqual[word] &= semantic;
+    _minorEqual[word] &= semantic;
+    _patchEqual[word] &= semantic;
+
+    const uint64_t greater = semantic & (majorGreater[word] | (_majorEqual[word] & (minorGreater[word] | (_minorEqual[word] & patchGreater[word]))));
+    const uint64_t same = _majorEqual[word] & _minorEqual[word] & _patchEqual[word];
+
+    // A version without a prerelease component always has greater or equal
+    // precedence to one with identical major, minor, and patch numbers.
+    _atLeast[word] = greater | (same & ~prerelease);
+
+    // If neither side has a prerelease component, the above was sufficient.
+    // Otherwise, if the base version has no prerelease component, any
+    // prerelease version is lower precedence, and need not be considered
+    // further.
+    _undecided[word] = basePrerelease ? (same & prerelease) : 0;
+  }
+}
+
+} // namespace Arbiter
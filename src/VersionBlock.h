@@ -0,0 +1,221 @@
+#pragma once
+
+#ifndef __cplusplus
+#error "This file must be compiled as C++."
+#endif
+
+#include "Memory.h"
+#include "Version.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Arbiter {
+
+/**
+ * Returns the number of 64-bit words needed for a bitmask with one bit for each
+ * of `count` elements.
+ */
+constexpr size_t maskWordCount (size_t count) noexcept
+{
+  return (count + 63) / 64;
+}
+
+/**
+ * Returns whether bit `index` is set in the given bitmask.
+ */
+inline bool maskTest (const uint64_t *mask, size_t index) noexcept
+{
+  return (mask[index / 64] >> (index % 64)) & 1;
+}
+
+/**
+ * Sets bit `index` in the given bitmask.
+ */
+inline void maskSet (uint64_t *mask, size_t index) noexcept
+{
+  mask[index / 64] |= uint64_t(1) << (index % 64);
+}
+
+/**
+ * Invokes `fn` with the index of each bit set in the given bitmask, in
+ * ascending order.
+ */
+template<typename Function>
+void forEachSetBit (const uint64_t *mask, size_t wordCount, Function fn)
+{
+  for (size_t word = 0; word < wordCount; word++) {
+    uint64_t bits = mask[word];
+
+    while (bits) {
+      fn(word * 64 + __builtin_ctzll(bits));
+      bits &= bits - 1;
+    }
+  }
+}
+
+/**
+ * Compares every element of `values` against `base`, setting the corresponding
+ * bit in `equal` or `greater` for elements which are equal to or greater than
+ * `base`, respectively.
+ *
+ * `equal` and `greater` must each have room for maskWordCount(count) words,
+ * and will be completely overwritten.
+ *
+ * This uses SIMD comparisons when available (AVX2 or SSE2), falling back to
+ * scalar comparisons otherwise.
+ */
+void compareComponents (const unsigned *values, size_t count, unsigned base, uint64_t *equal, uint64_t *greater) noexcept;
+
+/**
+ * A structure-of-arrays representation of a list of selected versions, which
+ * allows requirements to be evaluated against many versions at once.
+ *
+ * The block refers to the versions it was created from, which must outlive it
+ * and not be moved.
+ */
+class VersionBlock final
+{
+  public:
+    VersionBlock () = default;
+
+    /**
+     * Creates a block from a range of ArbiterSelectedVersions.
+     *
+     * If `counter` is not null, it will count the memory used by the block.
+     */
+    template<typename It>
+    VersionBlock (It begin, It end, MemoryCounter *counter = nullptr)
+      : _versions(Vector<const ArbiterSelectedVersion *>::allocator_type(counter))
+      , _majors(Vector<unsigned>::allocator_type(counter))
+      , _minors(Vector<unsigned>::allocator_type(counter))
+      , _patches(Vector<unsigned>::allocator_type(counter))
+      , _semantic(Vector<uint64_t>::allocator_type(counter))
+      , _prerelease(Vector<uint64_t>::allocator_type(counter))
+    {
+      for (It it = begin; it != end; ++it) {
+        append(*it);
+      }
+    }
+
+    size_t size () const noexcept
+    {
+      return _versions.size();
+    }
+
+    bool empty () const noexcept
+    {
+      return _versions.empty();
+    }
+
+    /**
+     * Returns the number of words needed for a bitmask over this block.
+     */
+    size_t wordCount () const noexcept
+    {
+      return maskWordCount(size());
+    }
+
+    const ArbiterSelectedVersion &version (size_t index) const noexcept
+    {
+      return *_versions[index];
+    }
+
+    /**
+     * Pointers to every version in the block, in order.
+     */
+    const ArbiterSelectedVersion * const *versions () const noexcept
+    {
+      return _versions.data();
+    }
+
+    /**
+     * Major, minor, and patch components of each version. These are zero for
+     * versions without a semantic version component.
+     */
+    const unsigned *majors () const noexcept
+    {
+      return _majors.data();
+    }
+
+    const unsigned *minors () const noexcept
+    {
+      return _minors.data();
+    }
+
+    const unsigned *patches () const noexcept
+    {
+      return _patches.data();
+    }
+
+    /**
+     * A bitmask of the versions which have a semantic version component.
+     */
+    const uint64_t *semanticMask () const noexcept
+    {
+      return _semantic.data();
+    }
+
+    /**
+     * A bitmask of the versions which have a prerelease version.
+     */
+    const uint64_t *prereleaseMask () const noexcept
+    {
+      return _prerelease.data();
+    }
+
+    /**
+     * Fills `mask` with a bit set for every version in the block.
+     */
+    void fillMask (uint64_t *mask) const noexcept;
+
+  private:
+    template<typename T>
+    using Vector = std::vector<T, CountingAllocator<T>>;
+
+    Vector<const ArbiterSelectedVersion *> _versions;
+    Vector<unsigned> _majors;
+    Vector<unsigned> _minors;
+    Vector<unsigned> _patches;
+    Vector<uint64_t> _semantic;
+    Vector<uint64_t> _prerelease;
+
+    void append (const ArbiterSelectedVersion &version);
+};
+
+/**
+ * The result of comparing every semantic version in a VersionBlock against one
+ * base version.
+ *
+ * Each mask has one bit per version in the block, and versions without
+ * a semantic version component never have any bits set.
+ */
+struct VersionBlockComparison final
+{
+  public:
+    VersionBlockComparison (const VersionBlock &block, const ArbiterSemanticVersion &base);
+
+    /**
+     * Versions whose major, minor, or patch component (respectively) is equal
+     * to that of the base version.
+     */
+    std::vector<uint64_t> _majorEqual;
+    std::vector<uint64_t> _minorEqual;
+    std::vector<uint64_t> _patchEqual;
+
+    /**
+     * Versions which are known to have greater or equal precedence to the base
+     * version.
+     */
+    std::vector<uint64_t> _atLeast;
+
+    /**
+     * Versions which are equal to the base version in their major, minor, and
+     * patch components, but cannot be ordered without comparing prerelease
+     * identifiers. These are never set in `_atLeast`.
+     */
+    std::vector<uint64_t> _undecided;
+};
+
+} // namespace Arbiter
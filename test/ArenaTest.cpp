@@ -0,0 +1,63 @@
+#include "Arena.h"
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <vector>
+
+using namespace Arbiter;
+
+TEST(ArenaTest, AlignsAllocations) {
+  Arena arena(256);
+
+  for (size_t alignment : { 1, 2, 8, 16, 64 }) {
+    arena.allocate(3, 1);
+
+    void *ptr = arena.allocate(24, alignment);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % alignment, 0);
+  }
+}
+
+TEST(ArenaTest, ReusesMemoryAfterRewinding) {
+  Arena arena(256);
+
+  void *first = arena.allocate(100, 8);
+  Arena::Mark mark = arena.mark();
+
+  void *second = arena.allocate(100, 8);
+  arena.allocate(200, 8);
+  size_t capacity = arena.capacity();
+
+  arena.rewind(mark);
+  EXPECT_EQ(arena.allocate(100, 8), second);
+
+  arena.reset();
+  EXPECT_EQ(arena.allocate(100, 8), first);
+
+  arena.allocate(100, 8);
+  arena.allocate(200, 8);
+  EXPECT_EQ(arena.capacity(), capacity);
+}
+
+TEST(ArenaTest, AllocatesLargerThanBlockSize) {
+  Arena arena(64);
+
+  auto *bytes = static_cast<char *>(arena.allocate(1000, 8));
+  bytes[0] = 'a';
+  bytes[999] = 'z';
+
+  EXPECT_GE(arena.capacity(), 1000);
+}
+
+TEST(ArenaTest, BacksStandardContainers) {
+  Arena arena(128);
+
+  std::vector<int, ArenaAllocator<int>> values((ArenaAllocator<int>(arena)));
+  for (int i = 0; i < 1000; i++) {
+    values.emplace_back(i);
+  }
+
+  for (int i = 0; i < 1000; i++) {
+    EXPECT_EQ(values[i], i);
+  }
+}
@@ -0,0 +1,114 @@
+#include "Batch.h"
+#include "Requirement.h"
+
+#include "Ecosystem.h"
+#include "TestValue.h"
+
+#include "gtest/gtest.h"
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace Arbiter;
+using namespace Testing;
+
+namespace {
+
+EcosystemOptions batchOptions ()
+{
+  EcosystemOptions options;
+  options._seed = 11;
+  options._packageCount = 40;
+  options._versionsPerPackage = 5;
+  options._fanOut = 3;
+  options._compatibleWithWeight = 0;
+  options._exactlyWeight = 0;
+  return options;
+}
+
+/**
+ * Returns a dependency upon each of the given packages, at any version.
+ */
+ArbiterDependencyList dependenciesUpon (const Ecosystem &ecosystem, const std::vector<size_t> &packages)
+{
+  std::vector<ArbiterDependency> dependencies;
+
+  for (size_t package : packages) {
+    ArbiterProjectIdentifier project(makeSharedUserValue<ArbiterProjectIdentifier, StringTestValue>(ecosystem.packages()[package]._name));
+    dependencies.emplace_back(std::move(project), Requirement::Any());
+  }
+
+  return ArbiterDependencyList(std::move(dependencies));
+}
+
+} // namespace
+
+TEST(BatchTest, ResolvesEntriesConcurrently) {
+  Ecosystem ecosystem(batchOptions());
+
+  std::vector<BatchEntry> entries;
+  for (size_t i = 0; i < 16; i++) {
+    entries.push_back(BatchEntry{ dependenciesUpon(ecosystem, { i, i + 1, i + 2 }), ArbiterResolvedDependencyGraph() });
+  }
+
+  BatchStats stats;
+  std::vector<BatchResult> results = resolveBatch(Ecosystem::behaviors(), ecosystem.context(), entries, 4, &stats);
+  ASSERT_EQ(results.size(), entries.size());
+
+  uint64_t separateFetches = 0;
+
+  for (size_t i = 0; i < entries.size(); i++) {
+    std::unique_ptr<ArbiterResolver> resolver = ecosystem.createResolver(entries[i]._dependenciesToResolve);
+
+    ASSERT_TRUE(bool(results[i]._graph)) << results[i]._error;
+    EXPECT_EQ(*results[i]._graph, resolver->resolve());
+
+    separateFetches += resolver->_latestStats._availableVersionFetches;
+  }
+
+  // Each project is only fetched once across the whole batch.
+  EXPECT_LE(stats._availableVersionFetches, ecosystem.packages().size());
+  EXPECT_LT(stats._availableVersionFetches, separateFetches);
+  EXPECT_GT(stats._sharedFetches, 0);
+}
+
+TEST(BatchTest, ReportsErrorsForEachEntry) {
+  Ecosystem ecosystem(batchOptions());
+
+  ArbiterDependencyList valid = dependenciesUpon(ecosystem, { 0 });
+
+  std::vector<ArbiterDependency> missing;
+  missing.emplace_back(ArbiterProjectIdentifier(makeSharedUserValue<ArbiterProjectIdentifier, StringTestValue>("missing")), Requirement::Any());
+  ArbiterDependencyList invalid(std::move(missing));
+
+  // Use the C API, with more threads than entries.
+  const ArbiterResolverBatchEntry entries[] = {
+    { &valid, nullptr },
+    { &invalid, nullptr },
+    { &invalid, nullptr },
+  };
+
+  ArbiterResolverBatchResult results[3];
+  ArbiterResolverBatchStatistics statistics;
+
+  ArbiterUserContext context = { const_cast<Ecosystem *>(&ecosystem), nullptr };
+  EXPECT_EQ(ArbiterResolveBatch(Ecosystem::behaviors(), entries, 3, context, 8, results, &statistics), 1);
+
+  EXPECT_NE(results[0].graph, nullptr);
+  EXPECT_EQ(results[0].error, nullptr);
+
+  for (size_t i = 1; i < 3; i++) {
+    EXPECT_EQ(results[i].graph, nullptr);
+    ASSERT_NE(results[i].error, nullptr);
+    EXPECT_NE(std::string(results[i].error).find("missing"), std::string::npos);
+  }
+
+  // The failure was only fetched once, too.
+  EXPECT_EQ(statistics.sharedFetches, 1);
+
+  for (const ArbiterResolverBatchResult &result : results) {
+    ArbiterFree(result.graph);
+    free(result.error);
+  }
+}
@@ -0,0 +1,211 @@
+#include "Graph.h"
+#include "Hash.h"
+#include "Requirement.h"
+#include "Resolver.h"
+#include "ToString.h"
+
+#include "Ecosystem.h"
+#include "TestValue.h"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace Arbiter;
+using namespace Testing;
+
+// These tests are most useful when built with ThreadSanitizer, as by `make
+// tsan`, which reports any unsynchronized access they provoke.
+
+namespace {
+
+const size_t threadCount = 4;
+
+EcosystemOptions stressOptions ()
+{
+  EcosystemOptions options;
+  options._seed = 3;
+  options._packageCount = 40;
+  options._versionsPerPackage = 6;
+  options._compatibleWithWeight = 0;
+  options._exactlyWeight = 0;
+  return options;
+}
+
+/**
+ * Runs `fn` on `threadCount` threads at once, passing each its index.
+ */
+void runInParallel (const std::function<void(size_t)> &fn)
+{
+  std::atomic<size_t> waiting{threadCount};
+  std::vector<std::thread> threads;
+
+  for (size_t i = 0; i < threadCount; i++) {
+    threads.emplace_back([&, i] {
+      // Start together, to make overlapping accesses more likely.
+      waiting.fetch_sub(1);
+      while (waiting.load() > 0) {
+        std::this_thread::yield();
+      }
+
+      fn(i);
+    });
+  }
+
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+}
+
+/**
+ * Returns the dependencies of `project` according to the edges of `graph`.
+ */
+std::set<ArbiterProjectIdentifier> expectedDependencies (const ArbiterResolvedDependencyGraph &graph, const ArbiterProjectIdentifier &project)
+{
+  auto it = graph.edges().find(project);
+  if (it == graph.edges().end()) {
+    return std::set<ArbiterProjectIdentifier>();
+  } else {
+    return it->second;
+  }
+}
+
+bool isEvenPatch (const ArbiterSelectedVersion *version, const void *)
+{
+  return version->_semanticVersion && version->_semanticVersion->_patch % 2 == 0;
+}
+
+} // namespace
+
+TEST(ConcurrencyTest, QueriesSharedGraphs) {
+  Ecosystem ecosystem(stressOptions());
+  const ArbiterResolvedDependencyGraph resolved = ecosystem.createResolver(ecosystem.rootDependencies())->resolve();
+
+  std::vector<ArbiterProjectIdentifier> roots;
+  for (const auto &dependency : ecosystem.rootDependencies()._dependencies) {
+    roots.push_back(dependency._projectIdentifier);
+  }
+
+  const size_t expectedEdges = ArbiterResolvedDependencyGraphCountEdges(&resolved);
+
+  for (size_t round = 0; round < 8; round++) {
+    // A new graph, which has not cached its compact form yet, so that the
+    // threads race to create it.
+    const ArbiterResolvedDependencyGraph shared = resolved.graphWithNewRoots(roots);
+
+    runInParallel([&](size_t) {
+      const ArbiterResolvedDependencyGraph copy = shared;
+      EXPECT_EQ(copy, shared);
+
+      // These pointers refer into the cached compact graph, so they must stay
+      // valid even if another thread is creating it at the same time.
+      std::vector<const ArbiterResolvedDependency *> nodes(ArbiterResolvedDependencyGraphCount(&shared));
+      std::vector<const ArbiterRequirement *> requirements(nodes.size());
+      ArbiterResolvedDependencyGraphGetAll(&shared, nodes.data(), requirements.data());
+
+      std::vector<size_t> offsets(nodes.size() + 1);
+      std::vector<size_t> edges(ArbiterResolvedDependencyGraphCountEdges(&shared));
+      EXPECT_EQ(edges.size(), expectedEdges);
+      ArbiterResolvedDependencyGraphGetAllEdges(&shared, offsets.data(), edges.data());
+
+      ASSERT_EQ(nodes.size(), shared.nodes().size());
+      for (size_t i = 0; i < nodes.size(); i++) {
+        const ArbiterResolvedDependency &node = *nodes[i];
+        const auto &value = shared.nodes().at(node._project);
+        EXPECT_EQ(node._version, value._version);
+        EXPECT_EQ(*requirements[i], value.requirement());
+
+        std::set<ArbiterProjectIdentifier> dependencies;
+        for (size_t edge = offsets[i]; edge < offsets[i + 1]; edge++) {
+          dependencies.insert(nodes[edges[edge]]->_project);
+        }
+
+        EXPECT_EQ(dependencies, expectedDependencies(shared, node._project));
+      }
+
+      for (const auto &node : shared.nodes()) {
+        EXPECT_EQ(*ArbiterResolvedDependencyGraphProjectVersion(&shared, &node.first), node.second._version);
+        EXPECT_TRUE(ArbiterResolvedDependencyGraphProjectRequirement(&shared, &node.first)->satisfiedBy(node.second._version));
+
+        std::vector<const ArbiterProjectIdentifier *> dependencies(ArbiterResolvedDependencyGraphCountDependencies(&shared, &node.first));
+        ArbiterResolvedDependencyGraphGetAllDependencies(&shared, &node.first, dependencies.data());
+
+        std::set<ArbiterProjectIdentifier> dereferenced;
+        for (const ArbiterProjectIdentifier *dependency : dependencies) {
+          dereferenced.insert(*dependency);
+        }
+
+        EXPECT_EQ(dereferenced, expectedDependencies(shared, node.first));
+      }
+
+      EXPECT_EQ(copy.createInstaller(), shared.createInstaller());
+      EXPECT_FALSE(toString(shared).empty());
+    });
+  }
+}
+
+TEST(ConcurrencyTest, EvaluatesSharedRequirements) {
+  Ecosystem ecosystem(stressOptions());
+  const ArbiterSelectedVersionList versions = ecosystem.availableVersionsList(ecosystem.packages().front()._name);
+
+  std::vector<std::shared_ptr<ArbiterRequirement>> requirements;
+  requirements.push_back(std::make_shared<Requirement::Any>());
+  requirements.push_back(std::make_shared<Requirement::AtLeast>(ArbiterSemanticVersion(0, 1, 0)));
+  requirements.push_back(std::make_shared<Requirement::CompatibleWith>(ArbiterSemanticVersion(1, 0, 0), ArbiterRequirementStrictnessStrict));
+  requirements.push_back(std::make_shared<Requirement::Exactly>(ArbiterSemanticVersion(1, 0, 0)));
+  requirements.push_back(std::make_shared<Requirement::Custom>(&isEvenPatch, nullptr));
+  requirements.push_back(std::make_shared<Requirement::Compound>(std::vector<std::shared_ptr<ArbiterRequirement>>{ requirements[1], requirements[4] }));
+
+  // Evaluate everything once on this thread, to compare against.
+  std::vector<std::vector<bool>> expected;
+  for (const auto &requirement : requirements) {
+    expected.emplace_back();
+    for (const ArbiterSelectedVersion &version : versions._versions) {
+      expected.back().push_back(requirement->satisfiedBy(version));
+    }
+  }
+
+  runInParallel([&](size_t thread) {
+    for (size_t iteration = 0; iteration < 50; iteration++) {
+      for (size_t i = 0; i < requirements.size(); i++) {
+        const ArbiterRequirement &requirement = *requirements[(i + thread) % requirements.size()];
+        const std::vector<bool> &satisfied = expected[(i + thread) % requirements.size()];
+
+        for (size_t v = 0; v < versions._versions.size(); v++) {
+          EXPECT_EQ(requirement.satisfiedBy(versions._versions[v]), satisfied[v]);
+        }
+
+        const ArbiterRequirement &other = *requirements[(i + 1) % requirements.size()];
+        requirement.intersect(other);
+
+        std::unique_ptr<Base> clone = requirement.clone();
+        EXPECT_EQ(*clone, requirement);
+        EXPECT_EQ(hashOf(static_cast<const ArbiterRequirement &>(*clone)), hashOf(requirement));
+        EXPECT_FALSE(toString(requirement).empty());
+      }
+    }
+  });
+}
+
+TEST(ConcurrencyTest, ResolvesInParallel) {
+  Ecosystem ecosystem(stressOptions());
+  const ArbiterDependencyList dependencies = ecosystem.rootDependencies();
+  const ArbiterResolvedDependencyGraph expected = ecosystem.createResolver(dependencies)->resolve();
+
+  runInParallel([&](size_t) {
+    for (size_t iteration = 0; iteration < 4; iteration++) {
+      // The resolver is per thread, but the dependencies and the initial
+      // graph are copied from objects shared by every thread.
+      std::unique_ptr<ArbiterResolver> resolver = ecosystem.createResolver(dependencies, expected);
+      ArbiterResolvedDependencyGraph resolved = resolver->resolve();
+
+      EXPECT_EQ(resolved, expected);
+      EXPECT_TRUE(resolver->unsatisfiedDependencies()._dependencies.empty());
+    }
+  });
+}
@@ -0,0 +1,333 @@
+#include "Ecosystem.h"
+
+#include "Requirement.h"
+#include "ToString.h"
+
+#include "Random.h"
+#include "TestValue.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <sys/stat.h>
+
+namespace Arbiter {
+namespace Testing {
+
+namespace {
+
+ArbiterSemanticVersion nextRelease (Random &random, const ArbiterSemanticVersion &version)
+{
+  double roll = random.unit();
+
+  if (roll < 0.1) {
+    return ArbiterSemanticVersion(version._major + 1, 0, 0);
+  } else if (roll < 0.4) {
+    return ArbiterSemanticVersion(version._major, version._minor + 1, 0);
+  } else {
+    return ArbiterSemanticVersion(version._major, version._minor, version._patch + 1);
+  }
+}
+
+std::vector<ArbiterSemanticVersion> generateVersions (Random &random, const EcosystemOptions &options)
+{
+  std::vector<ArbiterSemanticVersion> versions;
+  versions.reserve(options._versionsPerPackage);
+
+  ArbiterSemanticVersion release(1, 0, 0);
+
+  while (versions.size() < options._versionsPerPackage) {
+    if (!versions.empty()) {
+      release = nextRelease(random, release);
+    }
+
+    if (versions.size() + 1 < options._versionsPerPackage && random.chance(options._prereleaseShare)) {
+      versions.emplace_back(release._major, release._minor, release._patch, makeOptional(std::string("beta.1")));
+    }
+
+    versions.emplace_back(release);
+  }
+
+  return versions;
+}
+
+Ecosystem::Constraint chooseConstraint (Random &random, const EcosystemOptions &options)
+{
+  double total = options._compatibleWithWeight + options._atLeastWeight + options._exactlyWeight;
+  if (total <= 0) {
+    return Ecosystem::Constraint::CompatibleWith;
+  }
+
+  double roll = random.unit() * total;
+
+  if (roll < options._compatibleWithWeight) {
+    return Ecosystem::Constraint::CompatibleWith;
+  } else if (roll < options._compatibleWithWeight + options._atLeastWeight) {
+    return Ecosystem::Constraint::AtLeast;
+  } else {
+    return Ecosystem::Constraint::Exactly;
+  }
+}
+
+const char *constraintOperator (Ecosystem::Constraint constraint) noexcept
+{
+  switch (constraint) {
+    case Ecosystem::Constraint::CompatibleWith:
+      return "~>";
+
+    case Ecosystem::Constraint::AtLeast:
+      return ">=";
+
+    case Ecosystem::Constraint::Exactly:
+      return "==";
+  }
+
+  return "==";
+}
+
+std::unique_ptr<ArbiterRequirement> makeRequirement (const Ecosystem::Dependency &dependency)
+{
+  switch (dependency._constraint) {
+    case Ecosystem::Constraint::CompatibleWith:
+      // Matching how FixtureDirectory reads `~>`.
+      return std::make_unique<Requirement::CompatibleWith>(dependency._version, ArbiterRequirementStrictnessAllowVersionZeroPatches);
+
+    case Ecosystem::Constraint::AtLeast:
+      return std::make_unique<Requirement::AtLeast>(dependency._version);
+
+    case Ecosystem::Constraint::Exactly:
+      return std::make_unique<Requirement::Exactly>(dependency._version);
+  }
+
+  return nullptr;
+}
+
+ArbiterProjectIdentifier makeProjectIdentifier (const std::string &name)
+{
+  return ArbiterProjectIdentifier(makeSharedUserValue<ArbiterProjectIdentifier, StringTestValue>(name));
+}
+
+std::string packageName (size_t index, size_t count)
+{
+  std::string digits = std::to_string(index);
+  std::string width = std::to_string(count > 0 ? count - 1 : 0);
+
+  return "package" + std::string(width.size() - std::min(width.size(), digits.size()), '0') + digits;
+}
+
+const Ecosystem &ecosystemForResolver (const ArbiterResolver *resolver)
+{
+  return *static_cast<const Ecosystem *>(resolver->_context.get());
+}
+
+ArbiterDependencyList *createDependencyList (const ArbiterResolver *resolver, const ArbiterProjectIdentifier *project, const ArbiterSelectedVersion *version, char **error)
+{
+  try {
+    return new ArbiterDependencyList(ecosystemForResolver(resolver).dependencyList(fromUserValue<StringTestValue>(project->_value.data())._str, fromUserValue<StringTestValue>(version->_metadata.data())._str));
+  } catch (std::exception &ex) {
+    *error = copyCString(ex.what()).release();
+    return nullptr;
+  }
+}
+
+ArbiterSelectedVersionList *createAvailableVersionsList (const ArbiterResolver *resolver, const ArbiterProjectIdentifier *project, char **error)
+{
+  try {
+    return new ArbiterSelectedVersionList(ecosystemForResolver(resolver).availableVersionsList(fromUserValue<StringTestValue>(project->_value.data())._str));
+  } catch (std::exception &ex) {
+    *error = copyCString(ex.what()).release();
+    return nullptr;
+  }
+}
+
+void makeDirectory (const std::string &path) noexcept(false)
+{
+  if (mkdir(path.c_str(), 0755) != 0 && errno != EEXIST) {
+    throw std::runtime_error("Could not create directory " + path + ": " + std::strerror(errno));
+  }
+}
+
+std::ofstream openFile (const std::string &path) noexcept(false)
+{
+  std::ofstream file(path);
+  if (!file) {
+    throw std::runtime_error("Could not open file " + path);
+  }
+
+  return file;
+}
+
+} // namespace
+
+const char *const Ecosystem::rootProjectName = "Root";
+
+std::string Ecosystem::Version::tag () const
+{
+  return toString(_version);
+}
+
+Ecosystem::Ecosystem (const EcosystemOptions &options)
+  : _options(options)
+{
+  assert(options._versionsPerPackage > 0);
+
+  Random random(options._seed);
+
+  _packages.resize(options._packageCount);
+
+  for (size_t index = 0; index < _packages.size(); index++) {
+    Package &package = _packages[index];
+    package._name = packageName(index, _packages.size());
+    _packageIndexes.emplace(package._name, index);
+
+    for (ArbiterSemanticVersion &version : generateVersions(random, options)) {
+      package._versions.emplace_back(Version{ std::move(version), {} });
+    }
+  }
+
+  // Dependencies can only be chosen once every package's versions are known.
+  for (size_t index = 0; index < _packages.size(); index++) {
+    Package &package = _packages[index];
+    const size_t laterPackageCount = _packages.size() - index - 1;
+
+    for (size_t versionIndex = 0; versionIndex < package._versions.size(); versionIndex++) {
+      Version &version = package._versions[versionIndex];
+      size_t dependencyCount = std::min(random.below(options._fanOut + 1), laterPackageCount);
+
+      while (version._dependencies.size() < dependencyCount) {
+        size_t dependencyIndex = index + 1 + random.below(laterPackageCount);
+
+        auto existing = std::find_if(version._dependencies.begin(), version._dependencies.end(), [dependencyIndex](const Dependency &dependency) {
+          return dependency._package == dependencyIndex;
+        });
+
+        if (existing != version._dependencies.end()) {
+          continue;
+        }
+
+        std::vector<const ArbiterSemanticVersion *> releases;
+        for (const Version &candidate : _packages[dependencyIndex]._versions) {
+          if (!candidate._version._prereleaseVersion) {
+            releases.emplace_back(&candidate._version);
+          }
+        }
+
+        Dependency dependency{ dependencyIndex, Constraint::Exactly, *releases.front() };
+
+        if (random.chance(options._conflictDensity)) {
+          dependency._version = *releases[random.below(releases.size())];
+        } else {
+          // Newer versions of this package may depend upon newer versions of
+          // the dependency.
+          size_t newestRelease = (versionIndex + 1) * releases.size() / package._versions.size();
+
+          dependency._constraint = chooseConstraint(random, options);
+          dependency._version = *releases[random.below(std::max<size_t>(newestRelease, 1))];
+        }
+
+        version._dependencies.emplace_back(std::move(dependency));
+      }
+    }
+  }
+}
+
+ArbiterDependencyList Ecosystem::rootDependencies () const
+{
+  std::vector<ArbiterDependency> dependencies;
+
+  for (size_t index = 0; index < std::min(_options._rootDependencyCount, _packages.size()); index++) {
+    const Package &package = _packages[index];
+    dependencies.emplace_back(makeProjectIdentifier(package._name), Requirement::AtLeast(package._versions.front()._version));
+  }
+
+  return ArbiterDependencyList(std::move(dependencies));
+}
+
+ArbiterDependencyList Ecosystem::dependencyList (const std::string &packageName, const std::string &tag) const noexcept(false)
+{
+  const Package &package = this->package(packageName);
+
+  auto it = std::find_if(package._versions.begin(), package._versions.end(), [&tag](const Version &version) {
+    return version.tag() == tag;
+  });
+
+  if (it == package._versions.end()) {
+    throw std::runtime_error("No version " + tag + " of package " + packageName);
+  }
+
+  std::vector<ArbiterDependency> dependencies;
+  dependencies.reserve(it->_dependencies.size());
+
+  for (const Dependency &dependency : it->_dependencies) {
+    dependencies.emplace_back(makeProjectIdentifier(_packages[dependency._package]._name), *makeRequirement(dependency));
+  }
+
+  return ArbiterDependencyList(std::move(dependencies));
+}
+
+ArbiterSelectedVersionList Ecosystem::availableVersionsList (const std::string &packageName) const noexcept(false)
+{
+  std::vector<ArbiterSelectedVersion> versions;
+
+  for (const Version &version : package(packageName)._versions) {
+    versions.emplace_back(makeOptional(version._version), makeSharedUserValue<ArbiterSelectedVersion, StringTestValue>(version.tag()));
+  }
+
+  return ArbiterSelectedVersionList(std::move(versions));
+}
+
+ArbiterResolverBehaviors Ecosystem::behaviors () noexcept
+{
+  return ArbiterResolverBehaviors{ &createDependencyList, &createAvailableVersionsList, nullptr };
+}
+
+std::unique_ptr<ArbiterResolver> Ecosystem::createResolver (ArbiterDependencyList dependenciesToResolve, ArbiterResolvedDependencyGraph initialGraph) const
+{
+  return std::make_unique<ArbiterResolver>(behaviors(), std::move(initialGraph), std::move(dependenciesToResolve), context());
+}
+
+void Ecosystem::writeFixture (const std::string &directory) const noexcept(false)
+{
+  auto writeDependencies = [&](const std::string &path, const std::vector<Dependency> &dependencies) {
+    std::ofstream file = openFile(path);
+
+    for (const Dependency &dependency : dependencies) {
+      file << _packages[dependency._package]._name << ' ' << constraintOperator(dependency._constraint) << ' ' << toString(dependency._version) << '\n';
+    }
+  };
+
+  for (const Package &package : _packages) {
+    std::ofstream versions = openFile(directory + package._name + ".txt");
+    makeDirectory(directory + package._name);
+
+    for (const Version &version : package._versions) {
+      versions << version.tag() << '\n';
+      writeDependencies(directory + package._name + "/" + version.tag() + ".txt", version._dependencies);
+    }
+  }
+
+  std::vector<Dependency> rootDependencies;
+  for (size_t index = 0; index < std::min(_options._rootDependencyCount, _packages.size()); index++) {
+    rootDependencies.emplace_back(Dependency{ index, Constraint::AtLeast, _packages[index]._versions.front()._version });
+  }
+
+  openFile(directory + rootProjectName + ".txt") << "1.0.0\n";
+  makeDirectory(directory + rootProjectName);
+  writeDependencies(directory + rootProjectName + "/1.0.0.txt", rootDependencies);
+}
+
+const Ecosystem::Package &Ecosystem::package (const std::string &packageName) const noexcept(false)
+{
+  auto it = _packageIndexes.find(packageName);
+  if (it == _packageIndexes.end()) {
+    throw std::runtime_error("No package named " + packageName);
+  }
+
+  return _packages[it->second];
+}
+
+} // namespace Testing
+} // namespace Arbiter
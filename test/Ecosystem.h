@@ -0,0 +1,196 @@
+#pragma once
+
+#ifndef __cplusplus
+#error "This file must be compiled as C++."
+#endif
+
+#include "Dependency.h"
+#include "Resolver.h"
+#include "Version.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Arbiter {
+namespace Testing {
+
+/**
+ * Options for generating a synthetic Ecosystem.
+ */
+struct EcosystemOptions final
+{
+  public:
+    /**
+     * Ecosystems generated with the same options, including the same seed,
+     * are identical on every platform.
+     */
+    uint32_t _seed = 1;
+
+    size_t _packageCount = 100;
+
+    // Must be at least 1.
+    size_t _versionsPerPackage = 10;
+
+    /**
+     * The most dependencies that each version of a package may have. Each
+     * version has between zero and this many, chosen uniformly.
+     */
+    size_t _fanOut = 3;
+
+    /**
+     * The number of packages depended upon by the root project.
+     */
+    size_t _rootDependencyCount = 5;
+
+    /**
+     * The relative likelihood of each kind of constraint (`~>`, `>=`, and `==`,
+     * respectively). These do not need to add up to 1.
+     */
+    double _compatibleWithWeight = 6;
+    double _atLeastWeight = 3;
+    double _exactlyWeight = 1;
+
+    /**
+     * The probability that a dependency is pinned with `==` to a version
+     * chosen from anywhere in the dependency's history, rather than following
+     * the constraint mix. This makes conflicting requirements more likely.
+     */
+    double _conflictDensity = 0;
+
+    /**
+     * The probability that each version is a prerelease of the next release.
+     */
+    double _prereleaseShare = 0.1;
+};
+
+/**
+ * A randomly generated, but deterministic, collection of packages and their
+ * dependencies, for testing how the resolver and installer scale.
+ *
+ * Packages only depend upon packages generated after them, so the ecosystem is
+ * acyclic, but packages are likely to be depended upon along several paths
+ * (i.e., in diamonds). Newer versions of a package tend to depend upon newer
+ * versions of other packages, like real ecosystems.
+ *
+ * Like FixtureDirectory, projects and versions use StringTestValue for their
+ * user data, holding the package name and the version's tag.
+ */
+class Ecosystem final
+{
+  public:
+    enum class Constraint
+    {
+      CompatibleWith,
+      AtLeast,
+      Exactly,
+    };
+
+    struct Dependency final
+    {
+      public:
+        size_t _package;
+        Constraint _constraint;
+        ArbiterSemanticVersion _version;
+    };
+
+    struct Version final
+    {
+      public:
+        ArbiterSemanticVersion _version;
+        std::vector<Dependency> _dependencies;
+
+        /**
+         * Returns the tag for this version, as used in fixtures.
+         */
+        std::string tag () const;
+    };
+
+    struct Package final
+    {
+      public:
+        std::string _name;
+
+        // From oldest to newest.
+        std::vector<Version> _versions;
+    };
+
+    /**
+     * The name of the project which depends upon the first
+     * `_rootDependencyCount` packages, when the ecosystem is written to disk.
+     */
+    static const char *const rootProjectName;
+
+    explicit Ecosystem (const EcosystemOptions &options);
+
+    const EcosystemOptions &options () const noexcept
+    {
+      return _options;
+    }
+
+    const std::vector<Package> &packages () const noexcept
+    {
+      return _packages;
+    }
+
+    /**
+     * Returns the dependencies of the root project, which is not itself one of
+     * the packages.
+     */
+    ArbiterDependencyList rootDependencies () const;
+
+    /**
+     * Returns the dependencies of the given package at the given version tag.
+     *
+     * Throws an exception if the package or version does not exist.
+     */
+    ArbiterDependencyList dependencyList (const std::string &packageName, const std::string &tag) const noexcept(false);
+
+    /**
+     * Returns the available versions of the given package.
+     *
+     * Throws an exception if the package does not exist.
+     */
+    ArbiterSelectedVersionList availableVersionsList (const std::string &packageName) const noexcept(false);
+
+    /**
+     * Behaviors which read from the ecosystem given as the resolver's context.
+     */
+    static ArbiterResolverBehaviors behaviors () noexcept;
+
+    /**
+     * A context for behaviors(), which does not own the ecosystem.
+     */
+    std::shared_ptr<const void> context () const noexcept
+    {
+      return std::shared_ptr<const void>(std::shared_ptr<const void>(), this);
+    }
+
+    /**
+     * Creates a resolver which reads from this ecosystem in memory. The
+     * ecosystem must outlive the resolver.
+     */
+    std::unique_ptr<ArbiterResolver> createResolver (ArbiterDependencyList dependenciesToResolve, ArbiterResolvedDependencyGraph initialGraph = ArbiterResolvedDependencyGraph()) const;
+
+    /**
+     * Writes the ecosystem to `directory` in the format read by
+     * FixtureDirectory, including the root project, which is given one
+     * version, "1.0.0". `directory` must already exist, and should end in
+     * a slash.
+     *
+     * Throws an exception if any file cannot be written.
+     */
+    void writeFixture (const std::string &directory) const noexcept(false);
+
+  private:
+    EcosystemOptions _options;
+    std::vector<Package> _packages;
+    std::unordered_map<std::string, size_t> _packageIndexes;
+
+    const Package &package (const std::string &packageName) const noexcept(false);
+};
+
+} // namespace Testing
+} // namespace Arbiter
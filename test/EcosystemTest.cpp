@@ -0,0 +1,122 @@
+#include "Ecosystem.h"
+#include "Fixture.h"
+
+#include "gtest/gtest.h"
+
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+
+using namespace Arbiter;
+using namespace Testing;
+
+namespace {
+
+EcosystemOptions smallOptions ()
+{
+  EcosystemOptions options;
+  options._seed = 42;
+  options._packageCount = 30;
+  options._versionsPerPackage = 6;
+  options._fanOut = 3;
+  options._rootDependencyCount = 4;
+  options._exactlyWeight = 0;
+  options._prereleaseShare = 0.2;
+  return options;
+}
+
+} // namespace
+
+TEST(EcosystemTest, IsDeterministic)
+{
+  Ecosystem first(smallOptions());
+  Ecosystem second(smallOptions());
+
+  ASSERT_EQ(first.packages().size(), second.packages().size());
+
+  for (size_t index = 0; index < first.packages().size(); index++) {
+    const auto &package = first.packages()[index];
+    EXPECT_EQ(first.availableVersionsList(package._name), second.availableVersionsList(package._name));
+
+    for (const auto &version : package._versions) {
+      EXPECT_EQ(first.dependencyList(package._name, version.tag()), second.dependencyList(package._name, version.tag()));
+    }
+  }
+
+  EcosystemOptions options = smallOptions();
+  options._seed = 43;
+
+  Ecosystem different(options);
+
+  bool anyDifferent = false;
+  for (size_t index = 0; index < first.packages().size(); index++) {
+    const auto &package = first.packages()[index];
+    anyDifferent = anyDifferent || first.availableVersionsList(package._name) != different.availableVersionsList(package._name);
+  }
+
+  EXPECT_TRUE(anyDifferent);
+}
+
+TEST(EcosystemTest, FollowsOptions)
+{
+  EcosystemOptions options = smallOptions();
+  options._prereleaseShare = 0;
+
+  Ecosystem ecosystem(options);
+  ASSERT_EQ(ecosystem.packages().size(), options._packageCount);
+
+  size_t dependencyCount = 0;
+
+  for (size_t index = 0; index < ecosystem.packages().size(); index++) {
+    const auto &package = ecosystem.packages()[index];
+    EXPECT_EQ(package._versions.size(), options._versionsPerPackage);
+
+    for (size_t versionIndex = 0; versionIndex < package._versions.size(); versionIndex++) {
+      const auto &version = package._versions[versionIndex];
+      EXPECT_FALSE(version._version._prereleaseVersion);
+      EXPECT_LE(version._dependencies.size(), options._fanOut);
+
+      if (versionIndex > 0) {
+        EXPECT_LT(package._versions[versionIndex - 1]._version, version._version);
+      }
+
+      for (const auto &dependency : version._dependencies) {
+        // Packages only depend upon later packages, so there are no cycles.
+        EXPECT_GT(dependency._package, index);
+        EXPECT_NE(dependency._constraint, Ecosystem::Constraint::Exactly);
+        ++dependencyCount;
+      }
+    }
+  }
+
+  EXPECT_GT(dependencyCount, 0);
+  EXPECT_EQ(ecosystem.rootDependencies()._dependencies.size(), options._rootDependencyCount);
+}
+
+TEST(EcosystemTest, ResolvesInMemoryAndFromDisk)
+{
+  Ecosystem ecosystem(smallOptions());
+
+  ArbiterResolvedDependencyGraph inMemory = ecosystem.createResolver(ecosystem.rootDependencies())->resolve();
+  EXPECT_GE(inMemory.nodes().size(), ecosystem.options()._rootDependencyCount);
+
+  char path[] = "/tmp/ArbiterEcosystemTest.XXXXXX";
+  ASSERT_NE(mkdtemp(path), nullptr);
+
+  const std::string directory = std::string(path) + "/";
+  ecosystem.writeFixture(directory);
+
+  FixtureDirectory fixture(directory);
+
+  for (const auto &package : ecosystem.packages()) {
+    EXPECT_EQ(fixture.loadAvailableVersionsList(package._name), ecosystem.availableVersionsList(package._name));
+  }
+
+  ArbiterDependencyList rootDependencies = fixture.loadDependencyList(Ecosystem::rootProjectName, "1.0.0");
+  EXPECT_EQ(rootDependencies, ecosystem.rootDependencies());
+
+  ArbiterResolvedDependencyGraph fromDisk = fixture.createResolver(std::move(rootDependencies))->resolve();
+  EXPECT_EQ(fromDisk, inMemory);
+
+  EXPECT_EQ(std::system(("rm -rf '" + std::string(path) + "'").c_str()), 0);
+}
@@ -0,0 +1,151 @@
+#include "Fixture.h"
+
+#include "Requirement.h"
+#include "ToString.h"
+
+#include "TestValue.h"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+namespace Arbiter {
+namespace Testing {
+
+namespace {
+
+Optional<ArbiterSemanticVersion> semanticVersionFromString (std::string version)
+{
+  if (version.front() == 'v') {
+    version.erase(0, 1);
+  }
+
+  // problem???
+  while (std::count(version.begin(), version.end(), '.') < 2) {
+    version += ".0";
+  }
+
+  return ArbiterSemanticVersion::fromString(version);
+}
+
+const FixtureDirectory &fixtureForResolver (const ArbiterResolver *resolver)
+{
+  return *static_cast<const FixtureDirectory *>(resolver->_context.get());
+}
+
+ArbiterDependencyList *createDependencyList (const ArbiterResolver *resolver, const ArbiterProjectIdentifier *project, const ArbiterSelectedVersion *version, char **error)
+{
+  try {
+    return new ArbiterDependencyList(fixtureForResolver(resolver).loadDependencyList(fromUserValue<StringTestValue>(project->_value.data())._str, fromUserValue<StringTestValue>(version->_metadata.data())._str));
+  } catch (std::exception &ex) {
+    *error = copyCString(ex.what()).release();
+    return nullptr;
+  }
+}
+
+ArbiterSelectedVersionList *createAvailableVersionsList (const ArbiterResolver *resolver, const ArbiterProjectIdentifier *project, char **error)
+{
+  try {
+    return new ArbiterSelectedVersionList(fixtureForResolver(resolver).loadAvailableVersionsList(fromUserValue<StringTestValue>(project->_value.data())._str));
+  } catch (std::exception &ex) {
+    *error = copyCString(ex.what()).release();
+    return nullptr;
+  }
+}
+
+} // namespace
+
+const FixtureDirectory &FixtureDirectory::carthage () noexcept
+{
+  static const FixtureDirectory fixture("test/fixtures/carthage-graph/");
+  return fixture;
+}
+
+const std::vector<std::string> &FixtureDirectory::brokenCarthageVersions () noexcept
+{
+  static const std::vector<std::string> versions = { "0.2.2", "0.3" };
+  return versions;
+}
+
+ArbiterDependencyList FixtureDirectory::loadDependencyList (const std::string &projectName, const std::string &versionString) const noexcept(false)
+{
+  std::ifstream fd(_directory + projectName + "/" + versionString + ".txt");
+  std::vector<ArbiterDependency> dependencies;
+
+  while (fd) {
+    std::string depName;
+    std::string constraint;
+    std::string version;
+
+    fd >> depName >> constraint >> version;
+
+    auto semanticVersion = semanticVersionFromString(std::move(version));
+    if (!semanticVersion) {
+      continue;
+    }
+
+    std::unique_ptr<ArbiterRequirement> requirement;
+    if (constraint == "==") {
+      requirement = std::make_unique<Requirement::Exactly>(std::move(*semanticVersion));
+    } else if (constraint == "~>") {
+      requirement = std::make_unique<Requirement::CompatibleWith>(std::move(*semanticVersion), ArbiterRequirementStrictnessAllowVersionZeroPatches);
+    } else if (constraint == ">=") {
+      requirement = std::make_unique<Requirement::AtLeast>(std::move(*semanticVersion));
+    } else {
+      // TODO: 'Any' constraints
+      throw std::runtime_error("Unrecognized constraint: " + constraint);
+    }
+
+    ArbiterProjectIdentifier depProject(makeSharedUserValue<ArbiterProjectIdentifier, StringTestValue>(std::move(depName)));
+    dependencies.emplace_back(std::move(depProject), *requirement);
+  }
+
+  return ArbiterDependencyList(std::move(dependencies));
+}
+
+ArbiterSelectedVersionList FixtureDirectory::loadAvailableVersionsList (const std::string &projectName) const noexcept(false)
+{
+  std::vector<ArbiterSelectedVersion> versions;
+
+  for (std::string &versionStr : loadVersionStrings(projectName)) {
+    auto semanticVersion = semanticVersionFromString(versionStr);
+    if (!semanticVersion) {
+      continue;
+    }
+
+    versions.emplace_back(std::move(semanticVersion), makeSharedUserValue<ArbiterSelectedVersion, StringTestValue>(std::move(versionStr)));
+  }
+
+  return ArbiterSelectedVersionList(std::move(versions));
+}
+
+std::vector<std::string> FixtureDirectory::loadVersionStrings (const std::string &projectName) const noexcept(false)
+{
+  std::ifstream fd(_directory + projectName + ".txt");
+
+  if (!fd) {
+    throw std::runtime_error("No version list found for project: " + projectName);
+  }
+
+  std::vector<std::string> versionStrings;
+
+  std::string versionStr;
+  while (fd >> versionStr) {
+    versionStrings.emplace_back(std::move(versionStr));
+  }
+
+  return versionStrings;
+}
+
+ArbiterResolverBehaviors FixtureDirectory::behaviors () noexcept
+{
+  return ArbiterResolverBehaviors{ &createDependencyList, &createAvailableVersionsList, nullptr };
+}
+
+std::unique_ptr<ArbiterResolver> FixtureDirectory::createResolver (ArbiterDependencyList dependenciesToResolve, ArbiterResolvedDependencyGraph initialGraph) const
+{
+  return std::make_unique<ArbiterResolver>(behaviors(), std::move(initialGraph), std::move(dependenciesToResolve), context());
+}
+
+} // namespace Testing
+} // namespace Arbiter
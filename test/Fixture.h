@@ -0,0 +1,102 @@
+#pragma once
+
+#ifndef __cplusplus
+#error "This file must be compiled as C++."
+#endif
+
+#include "Dependency.h"
+#include "Resolver.h"
+#include "Version.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Arbiter {
+namespace Testing {
+
+/**
+ * A dependency graph stored on disk, in the format of
+ * `test/fixtures/carthage-graph/`.
+ *
+ * Each project has a `<project>.txt` file listing its version tags, and a
+ * `<project>/<tag>.txt` file for each version, listing one dependency per
+ * line as `<project> <constraint> <version>`, where the constraint is one of
+ * `==`, `~>`, or `>=`.
+ *
+ * Projects and versions use StringTestValue for their user data, holding the
+ * project name and the version's tag.
+ */
+class FixtureDirectory final
+{
+  public:
+    /**
+     * Reads a fixture from `directory`, which should end in a slash.
+     */
+    explicit FixtureDirectory (std::string directory)
+      : _directory(std::move(directory))
+    {}
+
+    /**
+     * The Carthage dependency graph, relative to the current directory.
+     */
+    static const FixtureDirectory &carthage () noexcept;
+
+    /**
+     * Versions of Carthage which cannot be resolved, because they depend upon
+     * versions which have since been revoked.
+     */
+    static const std::vector<std::string> &brokenCarthageVersions () noexcept;
+
+    const std::string &directory () const noexcept
+    {
+      return _directory;
+    }
+
+    /**
+     * Loads the dependencies of the given project at the given version tag.
+     *
+     * Throws an exception if a requirement cannot be parsed.
+     */
+    ArbiterDependencyList loadDependencyList (const std::string &projectName, const std::string &versionString) const noexcept(false);
+
+    /**
+     * Loads the available versions of the given project.
+     *
+     * Throws an exception if the project does not exist in the fixture.
+     */
+    ArbiterSelectedVersionList loadAvailableVersionsList (const std::string &projectName) const noexcept(false);
+
+    /**
+     * Returns the version tags of the given project, in the order they are
+     * listed in the fixture.
+     *
+     * Throws an exception if the project does not exist in the fixture.
+     */
+    std::vector<std::string> loadVersionStrings (const std::string &projectName) const noexcept(false);
+
+    /**
+     * Behaviors which read from the fixture given as the resolver's context.
+     */
+    static ArbiterResolverBehaviors behaviors () noexcept;
+
+    /**
+     * A context for behaviors(), which does not own the fixture.
+     */
+    std::shared_ptr<const void> context () const noexcept
+    {
+      return std::shared_ptr<const void>(std::shared_ptr<const void>(), this);
+    }
+
+    /**
+     * Creates a resolver which reads from this fixture. The fixture must
+     * outlive the resolver.
+     */
+    std::unique_ptr<ArbiterResolver> createResolver (ArbiterDependencyList dependenciesToResolve, ArbiterResolvedDependencyGraph initialGraph = ArbiterResolvedDependencyGraph()) const;
+
+  private:
+    std::string _directory;
+};
+
+} // namespace Testing
+} // namespace Arbiter
@@ -0,0 +1,360 @@
+#include "CompactGraph.h"
+#include "Exception.h"
+#include "Graph.h"
+#include "Requirement.h"
+#include "Scheduler.h"
+
+#include "TestValue.h"
+
+#include "gtest/gtest.h"
+
+#include <cstdlib>
+#include <stdexcept>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+using namespace Arbiter;
+using namespace Testing;
+
+namespace {
+
+ArbiterProjectIdentifier makeProjectIdentifier (std::string name)
+{
+  return ArbiterProjectIdentifier(makeSharedUserValue<ArbiterProjectIdentifier, StringTestValue>(std::move(name)));
+}
+
+void addNode (ArbiterResolvedDependencyGraph &graph, std::string name)
+{
+  ArbiterSelectedVersion version(ArbiterSemanticVersion(1, 0, 0), makeSharedUserValue<ArbiterSelectedVersion, EmptyTestValue>());
+  graph.addNode(ArbiterResolvedDependency(makeProjectIdentifier(std::move(name)), std::move(version)), Requirement::Any());
+}
+
+void addEdge (ArbiterResolvedDependencyGraph &graph, std::string dependent, std::string dependency)
+{
+  graph.addEdge(makeProjectIdentifier(std::move(dependent)), makeProjectIdentifier(std::move(dependency)));
+}
+
+size_t phaseOf (const ArbiterResolvedDependencyInstaller &installer, const std::string &name)
+{
+  for (size_t index = 0; index < installer._phases.size(); index++) {
+    for (const ArbiterResolvedDependency &dependency : installer._phases[index]) {
+      if (dependency._project == makeProjectIdentifier(name)) {
+        return index;
+      }
+    }
+  }
+
+  throw std::out_of_range("Project " + name + " not found in installer");
+}
+
+std::string nameOf (const ArbiterResolvedDependency *dependency)
+{
+  return fromUserValue<StringTestValue>(dependency->_project._value.data())._str;
+}
+
+} // namespace
+
+TEST(GraphTest, CompactGraphMirrorsEdges) {
+  ArbiterResolvedDependencyGraph graph;
+  for (const char *name : { "d", "c", "b", "a" }) {
+    addNode(graph, name);
+  }
+
+  addEdge(graph, "a", "c");
+  addEdge(graph, "a", "b");
+  addEdge(graph, "b", "d");
+  addEdge(graph, "c", "d");
+
+  auto compact = graph.compact();
+  ASSERT_EQ(compact->size(), 4);
+  EXPECT_EQ(compact->project(0), makeProjectIdentifier("a"));
+  EXPECT_EQ(compact->project(3), makeProjectIdentifier("d"));
+  EXPECT_EQ(compact->indexOf(makeProjectIdentifier("c")), makeOptional<CompactGraph::Index>(2));
+  EXPECT_FALSE(compact->indexOf(makeProjectIdentifier("e")));
+
+  std::vector<CompactGraph::Index> dependencies(compact->dependencies(0).begin(), compact->dependencies(0).end());
+  EXPECT_EQ(dependencies, std::vector<CompactGraph::Index>({ 1, 2 }));
+
+  std::vector<CompactGraph::Index> dependents(compact->dependents(3).begin(), compact->dependents(3).end());
+  EXPECT_EQ(dependents, std::vector<CompactGraph::Index>({ 1, 2 }));
+  EXPECT_EQ(compact->dependencies(3).size(), 0);
+  EXPECT_EQ(compact->dependents(0).size(), 0);
+
+  // The compact graph is cached until the next modification.
+  EXPECT_EQ(graph.compact(), compact);
+
+  addNode(graph, "e");
+  EXPECT_NE(graph.compact(), compact);
+  EXPECT_EQ(graph.compact()->size(), 5);
+}
+
+TEST(GraphTest, ExportsAllNodesAndEdges) {
+  ArbiterResolvedDependencyGraph graph;
+  for (const char *name : { "c", "a", "b" }) {
+    addNode(graph, name);
+  }
+
+  addEdge(graph, "a", "c");
+  addEdge(graph, "a", "b");
+  addEdge(graph, "b", "c");
+
+  size_t count = ArbiterResolvedDependencyGraphCount(&graph);
+  ASSERT_EQ(count, 3);
+
+  std::vector<const ArbiterResolvedDependency *> nodes(count);
+  std::vector<const ArbiterRequirement *> requirements(count);
+  ArbiterResolvedDependencyGraphGetAll(&graph, nodes.data(), requirements.data());
+
+  EXPECT_EQ(nameOf(nodes[0]), "a");
+  EXPECT_EQ(nameOf(nodes[1]), "b");
+  EXPECT_EQ(nameOf(nodes[2]), "c");
+  EXPECT_EQ(nodes[1]->_version, *ArbiterResolvedDependencyGraphProjectVersion(&graph, &nodes[1]->_project));
+  EXPECT_EQ(*requirements[2], Requirement::Any());
+
+  // Reading the graph again returns the same pointers.
+  std::vector<const ArbiterResolvedDependency *> nodesAgain(count);
+  ArbiterResolvedDependencyGraphGetAll(&graph, nodesAgain.data(), nullptr);
+  EXPECT_EQ(nodesAgain, nodes);
+
+  ASSERT_EQ(ArbiterResolvedDependencyGraphCountEdges(&graph), 3);
+
+  std::vector<size_t> offsets(count + 1);
+  std::vector<size_t> dependencies(3);
+  ArbiterResolvedDependencyGraphGetAllEdges(&graph, offsets.data(), dependencies.data());
+
+  EXPECT_EQ(offsets, std::vector<size_t>({ 0, 2, 3, 3 }));
+  EXPECT_EQ(dependencies, std::vector<size_t>({ 1, 2, 2 }));
+}
+
+TEST(GraphTest, GraphWithNewRootsKeepsReachableNodes) {
+  ArbiterResolvedDependencyGraph graph;
+  for (const char *name : { "a", "b", "c", "d", "e" }) {
+    addNode(graph, name);
+  }
+
+  addEdge(graph, "a", "b");
+  addEdge(graph, "a", "c");
+  addEdge(graph, "b", "d");
+  addEdge(graph, "c", "d");
+  addEdge(graph, "e", "a");
+
+  ArbiterResolvedDependencyGraph subgraph = graph.graphWithNewRoots({ makeProjectIdentifier("b"), makeProjectIdentifier("c") });
+  EXPECT_EQ(subgraph.nodes().size(), 3);
+  EXPECT_EQ(subgraph.edges().size(), 2);
+  EXPECT_EQ(subgraph.nodes().count(makeProjectIdentifier("a")), 0);
+  EXPECT_EQ(subgraph.nodes().count(makeProjectIdentifier("d")), 1);
+
+  EXPECT_EQ(graph.graphWithNewRoots({ makeProjectIdentifier("e") }), graph);
+  EXPECT_THROW(graph.graphWithNewRoots({ makeProjectIdentifier("f") }), std::out_of_range);
+}
+
+TEST(GraphTest, InstallerPlacesNodesAfterLastDependency) {
+  ArbiterResolvedDependencyGraph graph;
+  for (const char *name : { "app", "ui", "net", "json", "log" }) {
+    addNode(graph, name);
+  }
+
+  // app -> ui -> net -> log, app -> json -> log, app -> log
+  addEdge(graph, "app", "ui");
+  addEdge(graph, "app", "json");
+  addEdge(graph, "app", "log");
+  addEdge(graph, "ui", "net");
+  addEdge(graph, "net", "log");
+  addEdge(graph, "json", "log");
+
+  ArbiterResolvedDependencyInstaller installer = graph.createInstaller();
+  ASSERT_EQ(installer._phases.size(), 4);
+  EXPECT_EQ(phaseOf(installer, "log"), 0);
+  EXPECT_EQ(phaseOf(installer, "net"), 1);
+  EXPECT_EQ(phaseOf(installer, "json"), 1);
+  EXPECT_EQ(phaseOf(installer, "ui"), 2);
+  EXPECT_EQ(phaseOf(installer, "app"), 3);
+
+  ASSERT_EQ(installer._edges.size(), 4);
+  EXPECT_EQ(installer._edges.at(makeProjectIdentifier("app")).size(), 3);
+}
+
+TEST(GraphTest, InstallerReportsCycles) {
+  ArbiterResolvedDependencyGraph graph;
+  for (const char *name : { "root", "a", "b", "c" }) {
+    addNode(graph, name);
+  }
+
+  addEdge(graph, "root", "a");
+  addEdge(graph, "a", "b");
+  addEdge(graph, "b", "c");
+  addEdge(graph, "c", "a");
+
+  EXPECT_THROW(graph.createInstaller(), Exception::DependencyCycle);
+
+  EXPECT_EQ(ArbiterResolvedDependencyInstallerCreate(&graph), nullptr);
+
+  char *error = nullptr;
+  EXPECT_EQ(ArbiterResolvedDependencyInstallerCreateWithError(&graph, &error), nullptr);
+  ASSERT_NE(error, nullptr);
+
+  // The cycle may be reported starting from any of its members, but "root"
+  // is not part of it.
+  std::string description(error);
+  free(error);
+
+  EXPECT_EQ(description.find("Dependency cycle detected: "), 0);
+  EXPECT_EQ(description.find("(root)"), std::string::npos);
+  EXPECT_NE(description.find("(a) -> ArbiterProjectIdentifier(b) -> ArbiterProjectIdentifier(c)"), std::string::npos);
+}
+
+TEST(GraphTest, SchedulerStartsNodesWithoutPhaseBarriers) {
+  ArbiterResolvedDependencyGraph graph;
+  for (const char *name : { "slow", "fast", "afterFast", "afterBoth" }) {
+    addNode(graph, name);
+  }
+
+  addEdge(graph, "afterFast", "fast");
+  addEdge(graph, "afterBoth", "fast");
+  addEdge(graph, "afterBoth", "slow");
+
+  ArbiterResolvedDependencyScheduler scheduler(graph, nullptr, 0);
+
+  const ArbiterResolvedDependency *first = scheduler.next();
+  const ArbiterResolvedDependency *second = scheduler.next();
+  ASSERT_NE(first, nullptr);
+  ASSERT_NE(second, nullptr);
+  EXPECT_EQ(scheduler.next(), nullptr);
+
+  const ArbiterResolvedDependency *fast = (nameOf(first) == "fast" ? first : second);
+  const ArbiterResolvedDependency *slow = (nameOf(first) == "fast" ? second : first);
+  EXPECT_EQ(nameOf(fast), "fast");
+  EXPECT_EQ(nameOf(slow), "slow");
+
+  // "afterFast" can start while "slow" is still going.
+  scheduler.markCompleted(fast->_project);
+  const ArbiterResolvedDependency *afterFast = scheduler.next();
+  ASSERT_NE(afterFast, nullptr);
+  EXPECT_EQ(nameOf(afterFast), "afterFast");
+  EXPECT_EQ(scheduler.next(), nullptr);
+
+  scheduler.markCompleted(slow->_project);
+  const ArbiterResolvedDependency *afterBoth = scheduler.next();
+  ASSERT_NE(afterBoth, nullptr);
+  EXPECT_EQ(nameOf(afterBoth), "afterBoth");
+
+  EXPECT_FALSE(scheduler.finished());
+  scheduler.markCompleted(afterFast->_project);
+  scheduler.markCompleted(afterBoth->_project);
+  EXPECT_TRUE(scheduler.finished());
+  EXPECT_EQ(scheduler.next(), nullptr);
+  EXPECT_EQ(scheduler.waitForNext(), nullptr);
+
+  EXPECT_THROW(scheduler.markCompleted(afterBoth->_project), std::invalid_argument);
+
+  // The C API reports the same misuse without throwing.
+  char *error = nullptr;
+  EXPECT_FALSE(ArbiterResolvedDependencySchedulerMarkCompleted(&scheduler, afterBoth, &error));
+  ASSERT_NE(error, nullptr);
+  EXPECT_NE(std::string(error).find("is not being installed"), std::string::npos);
+  free(error);
+}
+
+TEST(GraphTest, SchedulerPrioritizesCriticalPath) {
+  ArbiterResolvedDependencyGraph graph;
+  for (const char *name : { "a", "b", "c", "d" }) {
+    addNode(graph, name);
+  }
+
+  // "b" has a longer chain of dependents than "a".
+  addEdge(graph, "c", "b");
+  addEdge(graph, "d", "c");
+
+  {
+    ArbiterResolvedDependencyScheduler scheduler(graph, nullptr, 1);
+    EXPECT_EQ(scheduler.criticalPathCost(makeProjectIdentifier("a")), 1);
+    EXPECT_EQ(scheduler.criticalPathCost(makeProjectIdentifier("b")), 3);
+
+    const ArbiterResolvedDependency *first = scheduler.next();
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(nameOf(first), "b");
+
+    // Only one worker is allowed.
+    EXPECT_EQ(scheduler.next(), nullptr);
+  }
+
+  {
+    // With costs, "a" alone is more expensive than the whole chain.
+    auto cost = [](const ArbiterResolvedDependency &dependency) {
+      return nameOf(&dependency) == "a" ? 10.0 : 1.0;
+    };
+
+    ArbiterResolvedDependencyScheduler scheduler(graph, cost, 1);
+    EXPECT_EQ(scheduler.criticalPathCost(makeProjectIdentifier("a")), 10);
+
+    const ArbiterResolvedDependency *first = scheduler.next();
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(nameOf(first), "a");
+  }
+}
+
+TEST(GraphTest, SchedulerRunsWithWorkerThreads) {
+  ArbiterResolvedDependencyGraph graph;
+
+  const size_t nodeCount = 50;
+  for (size_t index = 0; index < nodeCount; index++) {
+    addNode(graph, std::to_string(index));
+
+    // Each node depends upon the nodes at half and a third of its index.
+    if (index > 0) {
+      addEdge(graph, std::to_string(index), std::to_string(index / 2));
+      addEdge(graph, std::to_string(index), std::to_string(index / 3));
+    }
+  }
+
+  ArbiterResolvedDependencyScheduler scheduler(graph, nullptr, 3);
+
+  std::mutex mutex;
+  std::unordered_set<std::string> completed;
+  bool outOfOrder = false;
+
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < 4; i++) {
+    threads.emplace_back([&] {
+      while (const ArbiterResolvedDependency *dependency = scheduler.waitForNext()) {
+        size_t index = std::stoul(nameOf(dependency));
+
+        {
+          std::lock_guard<std::mutex> guard(mutex);
+          if (index > 0 && (!completed.count(std::to_string(index / 2)) || !completed.count(std::to_string(index / 3)))) {
+            outOfOrder = true;
+          }
+
+          completed.emplace(nameOf(dependency));
+        }
+
+        scheduler.markCompleted(dependency->_project);
+      }
+    });
+  }
+
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_TRUE(scheduler.finished());
+  EXPECT_FALSE(outOfOrder);
+  EXPECT_EQ(completed.size(), nodeCount);
+}
+
+TEST(GraphTest, SchedulerReportsCycles) {
+  ArbiterResolvedDependencyGraph graph;
+  addNode(graph, "a");
+  addNode(graph, "b");
+  addEdge(graph, "a", "b");
+  addEdge(graph, "b", "a");
+
+  char *error = nullptr;
+  EXPECT_EQ(ArbiterResolvedDependencySchedulerCreate(&graph, nullptr, ArbiterUserContext{nullptr, nullptr}, 0, &error), nullptr);
+  ASSERT_NE(error, nullptr);
+  EXPECT_EQ(std::string(error).find("Dependency cycle detected: "), 0);
+  free(error);
+}
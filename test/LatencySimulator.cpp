@@ -0,0 +1,166 @@
+#include "LatencySimulator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <thread>
+#include <unordered_set>
+
+using namespace Arbiter;
+using namespace Testing;
+
+namespace {
+
+using Duration = LatencyDistribution::Duration;
+
+Duration longestPathFrom (const ArbiterResolvedDependencyGraph &graph, const ArbiterProjectIdentifier &project, const std::function<Duration(const ArbiterProjectIdentifier &)> &cost, std::unordered_map<ArbiterProjectIdentifier, Duration> &memo, std::unordered_set<ArbiterProjectIdentifier> &visiting)
+{
+  auto memoIt = memo.find(project);
+  if (memoIt != memo.end()) {
+    return memoIt->second;
+  }
+
+  // Resolved graphs should not contain cycles, but don't recurse forever if
+  // one does.
+  if (!visiting.insert(project).second) {
+    return Duration(0);
+  }
+
+  Duration longestDependency(0);
+
+  auto edgeIt = graph.edges().find(project);
+  if (edgeIt != graph.edges().end()) {
+    for (const ArbiterProjectIdentifier &dependency : edgeIt->second) {
+      longestDependency = std::max(longestDependency, longestPathFrom(graph, dependency, cost, memo, visiting));
+    }
+  }
+
+  visiting.erase(project);
+
+  Duration result = cost(project) + longestDependency;
+  memo.emplace(project, result);
+  return result;
+}
+
+} // namespace
+
+Duration LatencyDistribution::sample (Random &random) const
+{
+  if (_sigma == 0) {
+    return _median;
+  }
+
+  double factor = std::exp(_sigma * random.normal());
+  return Duration(static_cast<Duration::rep>(std::llround(_median.count() * factor)));
+}
+
+LatencySimulator::LatencySimulator (ArbiterResolverBehaviors behaviors, std::shared_ptr<const void> context, LatencyOptions options)
+  : _behaviors(std::move(behaviors))
+  , _options(std::move(options))
+  , _random(_options._seed)
+  , _innerResolver(std::make_unique<ArbiterResolver>(_behaviors, ArbiterResolvedDependencyGraph(), ArbiterDependencyList(), std::move(context)))
+{}
+
+std::unique_ptr<ArbiterResolver> LatencySimulator::createResolver (ArbiterDependencyList dependenciesToResolve, ArbiterResolvedDependencyGraph initialGraph)
+{
+  ArbiterResolverBehaviors behaviors;
+  behaviors.createDependencyList = &createDependencyList;
+  behaviors.createAvailableVersionsList = &createAvailableVersionsList;
+  behaviors.createSelectedVersionForMetadata = _behaviors.createSelectedVersionForMetadata ? &createSelectedVersionForMetadata : nullptr;
+
+  std::shared_ptr<const void> context(std::shared_ptr<const void>(), this);
+  return std::make_unique<ArbiterResolver>(behaviors, std::move(initialGraph), std::move(dependenciesToResolve), std::move(context));
+}
+
+LatencyReport LatencySimulator::report (const ArbiterResolver &resolver, const ArbiterResolvedDependencyGraph &resolved) const
+{
+  LatencyReport report;
+  report._fetches = _fetches;
+  report._fetchLatency = _fetchLatency;
+
+  report._duration = resolver._latestStats.duration();
+  if (!_options._sleep) {
+    report._duration += std::chrono::duration_cast<Stats::Clock::duration>(_fetchLatency);
+  }
+
+  auto cost = [&](const ArbiterProjectIdentifier &project) {
+    Duration total(0);
+
+    auto availableIt = _availableVersionsLatencies.find(project);
+    if (availableIt != _availableVersionsLatencies.end()) {
+      total += availableIt->second;
+    }
+
+    auto projectIt = _dependencyListLatencies.find(project);
+    auto nodeIt = resolved.nodes().find(project);
+    if (projectIt != _dependencyListLatencies.end() && nodeIt != resolved.nodes().end()) {
+      auto versionIt = projectIt->second.find(nodeIt->second._version);
+      if (versionIt != projectIt->second.end()) {
+        total += versionIt->second;
+      }
+    }
+
+    return total;
+  };
+
+  std::unordered_map<ArbiterProjectIdentifier, Duration> memo;
+  std::unordered_set<ArbiterProjectIdentifier> visiting;
+
+  for (const auto &node : resolved.nodes()) {
+    report._criticalPathLatency = std::max(report._criticalPathLatency, longestPathFrom(resolved, node.first, cost, memo, visiting));
+  }
+
+  return report;
+}
+
+void LatencySimulator::reset ()
+{
+  _fetches = 0;
+  _fetchLatency = Duration(0);
+  _availableVersionsLatencies.clear();
+  _dependencyListLatencies.clear();
+}
+
+Duration LatencySimulator::simulateFetch (const ArbiterProjectIdentifier &project, const LatencyDistribution &distribution)
+{
+  auto it = _options._perProject.find(project);
+  Duration latency = (it == _options._perProject.end() ? distribution : it->second).sample(_random);
+
+  if (_options._sleep) {
+    std::this_thread::sleep_for(latency);
+  }
+
+  ++_fetches;
+  _fetchLatency += latency;
+  return latency;
+}
+
+ArbiterDependencyList *LatencySimulator::createDependencyList (const ArbiterResolver *resolver, const ArbiterProjectIdentifier *project, const ArbiterSelectedVersion *selectedVersion, char **error)
+{
+  auto simulator = static_cast<LatencySimulator *>(const_cast<void *>(resolver->_context.get()));
+
+  Duration latency = simulator->simulateFetch(*project, simulator->_options._dependencyList);
+
+  Duration &recorded = simulator->_dependencyListLatencies[*project][*selectedVersion];
+  recorded = std::max(recorded, latency);
+
+  return simulator->_behaviors.createDependencyList(simulator->_innerResolver.get(), project, selectedVersion, error);
+}
+
+ArbiterSelectedVersionList *LatencySimulator::createAvailableVersionsList (const ArbiterResolver *resolver, const ArbiterProjectIdentifier *project, char **error)
+{
+  auto simulator = static_cast<LatencySimulator *>(const_cast<void *>(resolver->_context.get()));
+
+  Duration latency = simulator->simulateFetch(*project, simulator->_options._availableVersions);
+
+  Duration &recorded = simulator->_availableVersionsLatencies[*project];
+  recorded = std::max(recorded, latency);
+
+  return simulator->_behaviors.createAvailableVersionsList(simulator->_innerResolver.get(), project, error);
+}
+
+ArbiterSelectedVersion *LatencySimulator::createSelectedVersionForMetadata (const ArbiterResolver *resolver, const ArbiterProjectIdentifier *project, const void *metadata)
+{
+  auto simulator = static_cast<LatencySimulator *>(const_cast<void *>(resolver->_context.get()));
+  return simulator->_behaviors.createSelectedVersionForMetadata(simulator->_innerResolver.get(), project, metadata);
+}
@@ -0,0 +1,182 @@
+#pragma once
+
+#ifndef __cplusplus
+#error "This file must be compiled as C++."
+#endif
+
+#include "Dependency.h"
+#include "Graph.h"
+#include "Resolver.h"
+#include "Stats.h"
+#include "Version.h"
+
+#include "Random.h"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+namespace Arbiter {
+namespace Testing {
+
+/**
+ * A distribution of simulated latencies, whose logarithms are normally
+ * distributed, as is typical of network requests.
+ */
+class LatencyDistribution final
+{
+  public:
+    using Duration = std::chrono::microseconds;
+
+    /**
+     * A distribution which is always zero.
+     */
+    LatencyDistribution () = default;
+
+    /**
+     * A distribution which always produces `latency`.
+     */
+    static LatencyDistribution fixed (Duration latency) noexcept
+    {
+      return logNormal(latency, 0);
+    }
+
+    /**
+     * A log-normal distribution with the given median, where `sigma` is the
+     * standard deviation of the logarithm of the latency. A sigma of 1 means
+     * that about 1 in 6 samples take over 2.7 times the median.
+     */
+    static LatencyDistribution logNormal (Duration median, double sigma) noexcept
+    {
+      LatencyDistribution distribution;
+      distribution._median = median;
+      distribution._sigma = sigma;
+      return distribution;
+    }
+
+    Duration sample (Random &random) const;
+
+  private:
+    Duration _median{0};
+    double _sigma = 0;
+};
+
+/**
+ * Options for a LatencySimulator.
+ */
+struct LatencyOptions final
+{
+  public:
+    uint32_t _seed = 1;
+
+    LatencyDistribution _availableVersions;
+    LatencyDistribution _dependencyList;
+
+    /**
+     * Latencies for every fetch concerning particular projects, in place of
+     * the distributions above.
+     */
+    std::unordered_map<ArbiterProjectIdentifier, LatencyDistribution> _perProject;
+
+    /**
+     * Whether to actually sleep for each simulated latency. Otherwise, the
+     * latency is only accounted for, which keeps benchmarks fast and
+     * repeatable.
+     */
+    bool _sleep = false;
+};
+
+/**
+ * Measurements of one resolution through a LatencySimulator.
+ */
+struct LatencyReport final
+{
+  public:
+    using Duration = LatencyDistribution::Duration;
+
+    // The number of behavior invocations which incurred latency.
+    size_t _fetches{0};
+
+    // The total latency of all fetches.
+    Duration _fetchLatency{0};
+
+    /**
+     * The most latency along any chain of fetches in the resolved graph,
+     * where each project's versions and dependencies cannot be fetched until
+     * a project depending upon it has been fetched.
+     *
+     * However fetches were overlapped, resolution could not take less time
+     * than this.
+     */
+    Duration _criticalPathLatency{0};
+
+    /**
+     * The end-to-end time of the resolution, as if each fetch had actually
+     * taken its simulated latency.
+     */
+    Stats::Clock::duration _duration{0};
+};
+
+/**
+ * Wraps resolver behaviors to inject simulated latency into every fetch,
+ * without any network access, in order to measure how much of a resolution is
+ * spent waiting and how much of that waiting could be overlapped.
+ */
+class LatencySimulator final
+{
+  public:
+    /**
+     * Wraps `behaviors`, which will receive a resolver with the given
+     * `context` from ArbiterResolverContext(), rather than the resolver doing
+     * the resolution.
+     */
+    LatencySimulator (ArbiterResolverBehaviors behaviors, std::shared_ptr<const void> context, LatencyOptions options);
+
+    LatencySimulator (const LatencySimulator &) = delete;
+    LatencySimulator &operator= (const LatencySimulator &) = delete;
+
+    /**
+     * Creates a resolver whose behaviors incur simulated latency. The
+     * simulator must outlive the resolver.
+     */
+    std::unique_ptr<ArbiterResolver> createResolver (ArbiterDependencyList dependenciesToResolve, ArbiterResolvedDependencyGraph initialGraph = ArbiterResolvedDependencyGraph());
+
+    /**
+     * Describes the latest resolution by `resolver`, which produced
+     * `resolved`, including every fetch since the simulator was created or
+     * last reset.
+     */
+    LatencyReport report (const ArbiterResolver &resolver, const ArbiterResolvedDependencyGraph &resolved) const;
+
+    /**
+     * Forgets all fetches, so that the next report only includes those made
+     * afterward.
+     */
+    void reset ();
+
+  private:
+    using Duration = LatencyDistribution::Duration;
+
+    ArbiterResolverBehaviors _behaviors;
+    LatencyOptions _options;
+    Random _random;
+
+    // Passed to the wrapped behaviors, so that they can retrieve their own
+    // context.
+    std::unique_ptr<ArbiterResolver> _innerResolver;
+
+    size_t _fetches = 0;
+    Duration _fetchLatency{0};
+    std::unordered_map<ArbiterProjectIdentifier, Duration> _availableVersionsLatencies;
+    std::unordered_map<ArbiterProjectIdentifier, std::unordered_map<ArbiterSelectedVersion, Duration>> _dependencyListLatencies;
+
+    Duration simulateFetch (const ArbiterProjectIdentifier &project, const LatencyDistribution &distribution);
+
+    static ArbiterDependencyList *createDependencyList (const ArbiterResolver *resolver, const ArbiterProjectIdentifier *project, const ArbiterSelectedVersion *selectedVersion, char **error);
+    static ArbiterSelectedVersionList *createAvailableVersionsList (const ArbiterResolver *resolver, const ArbiterProjectIdentifier *project, char **error);
+    static ArbiterSelectedVersion *createSelectedVersionForMetadata (const ArbiterResolver *resolver, const ArbiterProjectIdentifier *project, const void *metadata);
+};
+
+} // namespace Testing
+} // namespace Arbiter
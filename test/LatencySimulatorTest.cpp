@@ -0,0 +1,126 @@
+#include "Fixture.h"
+#include "LatencySimulator.h"
+#include "TestValue.h"
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace Arbiter;
+using namespace Testing;
+
+namespace {
+
+using std::chrono::milliseconds;
+
+/**
+ * Writes a fixture where Root depends upon A, A depends upon B and D, and
+ * B depends upon C, so that the longest chain of fetches is A, B, C.
+ */
+std::string writeChainFixture ()
+{
+  char path[] = "/tmp/ArbiterLatencySimulatorTest.XXXXXX";
+  if (!mkdtemp(path)) {
+    return "";
+  }
+
+  const std::string directory = std::string(path) + "/";
+
+  auto writeProject = [&](const std::string &name, const std::string &dependencies) {
+    mkdir((directory + name).c_str(), 0700);
+    std::ofstream(directory + name + ".txt") << "1.0.0\n";
+    std::ofstream(directory + name + "/1.0.0.txt") << dependencies;
+  };
+
+  writeProject("Root", "A >= 1.0.0\n");
+  writeProject("A", "B >= 1.0.0\nD >= 1.0.0\n");
+  writeProject("B", "C >= 1.0.0\n");
+  writeProject("C", "");
+  writeProject("D", "");
+
+  return directory;
+}
+
+ArbiterProjectIdentifier project (const std::string &name)
+{
+  return ArbiterProjectIdentifier(makeSharedUserValue<ArbiterProjectIdentifier, StringTestValue>(name));
+}
+
+} // namespace
+
+TEST(LatencySimulatorTest, AccountsForFixedLatency)
+{
+  const std::string directory = writeChainFixture();
+  ASSERT_FALSE(directory.empty());
+
+  FixtureDirectory fixture(directory);
+
+  LatencyOptions options;
+  options._availableVersions = LatencyDistribution::fixed(milliseconds(10));
+  options._dependencyList = LatencyDistribution::fixed(milliseconds(10));
+
+  LatencySimulator simulator(FixtureDirectory::behaviors(), fixture.context(), options);
+  std::unique_ptr<ArbiterResolver> resolver = simulator.createResolver(fixture.loadDependencyList("Root", "1.0.0"));
+
+  ArbiterResolvedDependencyGraph resolved = resolver->resolve();
+  EXPECT_EQ(resolved.nodes().size(), 4);
+
+  LatencyReport report = simulator.report(*resolver, resolved);
+  EXPECT_EQ(report._fetches, 8);
+  EXPECT_EQ(report._fetchLatency, milliseconds(80));
+  EXPECT_EQ(report._criticalPathLatency, milliseconds(60));
+  EXPECT_GE(report._duration, milliseconds(80));
+
+  simulator.reset();
+  EXPECT_EQ(simulator.report(*resolver, resolved)._fetches, 0);
+}
+
+TEST(LatencySimulatorTest, AppliesPerProjectLatency)
+{
+  const std::string directory = writeChainFixture();
+  ASSERT_FALSE(directory.empty());
+
+  FixtureDirectory fixture(directory);
+
+  LatencyOptions options;
+  options._availableVersions = LatencyDistribution::fixed(milliseconds(10));
+  options._dependencyList = LatencyDistribution::fixed(milliseconds(10));
+  options._perProject[project("D")] = LatencyDistribution::fixed(milliseconds(100));
+
+  LatencySimulator simulator(FixtureDirectory::behaviors(), fixture.context(), options);
+  std::unique_ptr<ArbiterResolver> resolver = simulator.createResolver(fixture.loadDependencyList("Root", "1.0.0"));
+
+  ArbiterResolvedDependencyGraph resolved = resolver->resolve();
+
+  // D is now slower than B and C together.
+  LatencyReport report = simulator.report(*resolver, resolved);
+  EXPECT_EQ(report._fetchLatency, milliseconds(260));
+  EXPECT_EQ(report._criticalPathLatency, milliseconds(220));
+}
+
+TEST(LatencySimulatorTest, SamplesDeterministically)
+{
+  LatencyDistribution distribution = LatencyDistribution::logNormal(milliseconds(50), 1);
+
+  Random first(7);
+  Random second(7);
+
+  bool varied = false;
+  LatencyDistribution::Duration previous(0);
+
+  for (size_t i = 0; i < 100; i++) {
+    LatencyDistribution::Duration sample = distribution.sample(first);
+    EXPECT_EQ(sample, distribution.sample(second));
+    EXPECT_GE(sample.count(), 0);
+
+    varied |= (i > 0 && sample != previous);
+    previous = sample;
+  }
+
+  EXPECT_TRUE(varied);
+}
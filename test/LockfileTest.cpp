@@ -0,0 +1,277 @@
+#include "Exception.h"
+#include "Graph.h"
+#include "Lockfile.h"
+#include "Requirement.h"
+#include "ToString.h"
+
+#include "TestValue.h"
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace Arbiter;
+using namespace Testing;
+
+namespace {
+
+ArbiterUserValue createTestValue (const void *bytes, size_t length, const void *)
+{
+  return TestValue::fromSerialization(bytes, length);
+}
+
+const ArbiterLockfileValueReaders testValueReaders = { &createTestValue, &createTestValue, nullptr };
+
+ArbiterProjectIdentifier makeProjectIdentifier (std::string name)
+{
+  return ArbiterProjectIdentifier(makeSharedUserValue<ArbiterProjectIdentifier, StringTestValue>(std::move(name)));
+}
+
+ArbiterProjectIdentifier makeStringProjectIdentifier (const std::string &name)
+{
+  return ArbiterProjectIdentifier(SharedUserValue<ArbiterProjectIdentifier>(std::string(name)));
+}
+
+ArbiterSelectedVersion makeVersion (unsigned major, unsigned minor, unsigned patch)
+{
+  return ArbiterSelectedVersion(ArbiterSemanticVersion(major, minor, patch), makeSharedUserValue<ArbiterSelectedVersion, EmptyTestValue>());
+}
+
+/**
+ * A temporary file which is deleted when it goes out of scope.
+ */
+class TemporaryFile final
+{
+  public:
+    std::string _path;
+
+    TemporaryFile ()
+    {
+      char path[] = "/tmp/ArbiterLockfileTest.XXXXXX";
+      int fd = mkstemp(path);
+      EXPECT_GE(fd, 0);
+      close(fd);
+
+      _path = path;
+    }
+
+    ~TemporaryFile ()
+    {
+      std::remove(_path.c_str());
+    }
+
+    void write (const std::string &contents) const
+    {
+      std::ofstream stream(_path, std::ios::binary | std::ios::trunc);
+      stream << contents;
+    }
+
+    std::string read () const
+    {
+      std::ifstream stream(_path, std::ios::binary);
+      return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    }
+};
+
+std::string writeLockfile (const ArbiterResolvedDependencyGraph &graph)
+{
+  std::string contents;
+  Lockfile::write(graph, [&contents](const char *bytes, size_t length) {
+    contents.append(bytes, length);
+  });
+
+  return contents;
+}
+
+} // namespace
+
+TEST(LockfileTest, RoundTripsGraph) {
+  std::vector<std::shared_ptr<ArbiterRequirement>> requirements;
+  requirements.emplace_back(std::make_shared<Requirement::AtLeast>(ArbiterSemanticVersion(1, 0, 0)));
+  requirements.emplace_back(std::make_shared<Requirement::CompatibleWith>(ArbiterSemanticVersion(1, 2, 0), ArbiterRequirementStrictnessAllowVersionZeroPatches));
+
+  ArbiterResolvedDependencyGraph graph;
+  graph.addNode(ArbiterResolvedDependency(makeProjectIdentifier("app"), makeVersion(2, 0, 0)), Requirement::Prioritized(std::make_shared<Requirement::Exactly>(ArbiterSemanticVersion(2, 0, 0)), -3));
+  graph.addNode(ArbiterResolvedDependency(makeProjectIdentifier("lib"), makeVersion(1, 2, 3)), Requirement::Compound(std::move(requirements)));
+  graph.addNode(ArbiterResolvedDependency(makeProjectIdentifier("base"), ArbiterSelectedVersion(None(), SharedUserValue<ArbiterSelectedVersion>(std::string("main")))), Requirement::Unversioned(SharedUserValue<ArbiterSelectedVersion>(std::string("main"))));
+  graph.addNode(ArbiterResolvedDependency(makeProjectIdentifier("util"), makeVersion(0, 1, 0)), Requirement::Any());
+  graph.addEdge(makeProjectIdentifier("app"), makeProjectIdentifier("lib"));
+  graph.addEdge(makeProjectIdentifier("app"), makeProjectIdentifier("util"));
+  graph.addEdge(makeProjectIdentifier("lib"), makeProjectIdentifier("base"));
+  graph.addEdge(makeProjectIdentifier("util"), makeProjectIdentifier("base"));
+
+  TemporaryFile file;
+  char *error = nullptr;
+  ASSERT_TRUE(ArbiterResolvedDependencyGraphWriteLockfile(&graph, file._path.c_str(), &error)) << error;
+  EXPECT_EQ(file.read(), writeLockfile(graph));
+
+  ArbiterLockfile lockfile(file._path, testValueReaders);
+  ASSERT_EQ(lockfile.size(), 4);
+  EXPECT_EQ(lockfile.graph(), graph);
+
+  // Nodes are sorted by their serializations, which are prefixed with "s" for
+  // StringTestValues.
+  auto base = lockfile.find("sbase", 5);
+  auto util = lockfile.find("sutil", 5);
+  auto lib = lockfile.find("slib", 4);
+  ASSERT_TRUE(bool(base));
+  ASSERT_TRUE(bool(util));
+  ASSERT_TRUE(bool(lib));
+  EXPECT_FALSE(bool(lockfile.find("lib", 3)));
+  EXPECT_FALSE(bool(lockfile.find("", 0)));
+  EXPECT_FALSE(bool(lockfile.find("sap", 3)));
+
+  EXPECT_EQ(*base, 1);
+  EXPECT_EQ(lockfile.project(*base), makeProjectIdentifier("base"));
+  EXPECT_EQ(lockfile.version(*base), ArbiterSelectedVersion(None(), SharedUserValue<ArbiterSelectedVersion>(std::string("main"))));
+  EXPECT_EQ(lockfile.countDependencies(*base), 0);
+
+  EXPECT_EQ(lockfile.project(*lib), makeProjectIdentifier("lib"));
+  EXPECT_EQ(lockfile.version(*lib), makeVersion(1, 2, 3));
+  EXPECT_EQ(*lockfile.requirement(*lib), graph.nodes().at(makeProjectIdentifier("lib")).requirement());
+  ASSERT_EQ(lockfile.countDependencies(*lib), 1);
+  EXPECT_EQ(lockfile.dependency(*lib, 0), *base);
+
+  auto app = lockfile.find("sapp", 4);
+  ASSERT_TRUE(bool(app));
+  EXPECT_EQ(lockfile.requirement(*app)->priority(), -3);
+
+  std::vector<size_t> dependencies(ArbiterLockfileCountDependencies(&lockfile, *app));
+  ArbiterLockfileGetAllDependencies(&lockfile, *app, dependencies.data());
+  EXPECT_EQ(dependencies, (std::vector<size_t>{ *lib, *util }));
+}
+
+TEST(LockfileTest, RoundTripsStringValuesWithoutReaders) {
+  ArbiterResolvedDependencyGraph graph;
+  graph.addNode(ArbiterResolvedDependency(makeStringProjectIdentifier("b"), ArbiterSelectedVersion(ArbiterSemanticVersion(1, 0, 0, std::string("beta")), SharedUserValue<ArbiterSelectedVersion>(std::string("b1")))), Requirement::AtLeast(ArbiterSemanticVersion(1, 0, 0, std::string("alpha"))));
+  graph.addNode(ArbiterResolvedDependency(makeStringProjectIdentifier("a"), ArbiterSelectedVersion(None(), SharedUserValue<ArbiterSelectedVersion>(std::string("main")))), Requirement::Unversioned(SharedUserValue<ArbiterSelectedVersion>(std::string("main"))));
+  graph.addEdge(makeStringProjectIdentifier("a"), makeStringProjectIdentifier("b"));
+
+  TemporaryFile file;
+  file.write(writeLockfile(graph));
+
+  ArbiterLockfileValueReaders noReaders = { nullptr, nullptr, nullptr };
+  ArbiterLockfile lockfile(file._path, noReaders);
+  EXPECT_EQ(lockfile.graph(), graph);
+
+  size_t length = 0;
+  const char *bytes = lockfile.projectBytes(0, &length);
+  EXPECT_EQ(std::string(bytes, length), "a");
+
+  bytes = lockfile.projectBytes(1, &length);
+  EXPECT_EQ(std::string(bytes, length), "b");
+  EXPECT_EQ(toString(lockfile.version(1)), "1.0.0-beta (b1)");
+}
+
+TEST(LockfileTest, RejectsMalformedFiles) {
+  ArbiterResolvedDependencyGraph graph;
+  graph.addNode(ArbiterResolvedDependency(makeProjectIdentifier("a"), makeVersion(1, 0, 0)), Requirement::Any());
+  graph.addNode(ArbiterResolvedDependency(makeProjectIdentifier("b"), makeVersion(1, 0, 0)), Requirement::Any());
+  graph.addEdge(makeProjectIdentifier("a"), makeProjectIdentifier("b"));
+
+  const std::string contents = writeLockfile(graph);
+  TemporaryFile file;
+
+  auto expectRejected = [&file](const std::string &contents) {
+    file.write(contents);
+
+    char *error = nullptr;
+    EXPECT_EQ(ArbiterLockfileOpen(file._path.c_str(), testValueReaders, &error), nullptr);
+    EXPECT_NE(error, nullptr);
+    free(error);
+  };
+
+  expectRejected("");
+  expectRejected(contents.substr(0, contents.size() - 1));
+  expectRejected(contents + "x");
+
+  std::string badMagic = contents;
+  badMagic[0] = 'X';
+  expectRejected(badMagic);
+
+  // Point the edge at a node which does not exist.
+  std::string badEdge = contents;
+  badEdge[32 + 2 * 44] = 2;
+  expectRejected(badEdge);
+
+  file.write(contents);
+  ArbiterLockfile lockfile(file._path, testValueReaders);
+  EXPECT_EQ(lockfile.graph(), graph);
+
+  ArbiterLockfileValueReaders noReaders = { nullptr, nullptr, nullptr };
+  ArbiterLockfile unreadable(file._path, noReaders);
+  EXPECT_THROW(unreadable.project(0), Exception::SerializationError);
+}
+
+TEST(LockfileTest, RejectsOverflowingHeaders) {
+  const std::string contents = writeLockfile(ArbiterResolvedDependencyGraph());
+  ASSERT_EQ(contents.size(), 32);
+  TemporaryFile file;
+
+  auto expectRejected = [&](uint32_t nodeCount, uint32_t edgeCount, uint64_t dataSize) {
+    std::string header = contents;
+    for (size_t i = 0; i < 4; i++) {
+      header[12 + i] = char((nodeCount >> (8 * i)) & 0xff);
+      header[16 + i] = char((edgeCount >> (8 * i)) & 0xff);
+    }
+
+    for (size_t i = 0; i < 8; i++) {
+      header[24 + i] = char((dataSize >> (8 * i)) & 0xff);
+    }
+
+    file.write(header);
+    EXPECT_THROW(ArbiterLockfile(file._path, testValueReaders), Exception::SerializationError);
+  };
+
+  // Sections which claim more than the file contains.
+  expectRejected(1, 0, 0);
+  expectRejected(0, 1, 0);
+  expectRejected(0, 0, 1);
+
+  // A data size which would wrap the total around to the real file size.
+  expectRejected(100000, 0, uint64_t(0) - 100000 * 44);
+  expectRejected(0, 0, uint64_t(std::numeric_limits<uint32_t>::max()) + 1);
+}
+
+TEST(LockfileTest, RejectsDeeplyNestedRequirements) {
+  auto nested = [](unsigned depth) {
+    std::shared_ptr<ArbiterRequirement> requirement = std::make_shared<Requirement::Any>();
+    for (unsigned i = 0; i < depth; i++) {
+      requirement = std::make_shared<Requirement::Prioritized>(std::move(requirement), 0);
+    }
+
+    ArbiterResolvedDependencyGraph graph;
+    graph.addNode(ArbiterResolvedDependency(makeProjectIdentifier("a"), makeVersion(1, 0, 0)), *requirement);
+    return graph;
+  };
+
+  TemporaryFile file;
+
+  file.write(writeLockfile(nested(64)));
+  ArbiterLockfile shallow(file._path, testValueReaders);
+  EXPECT_NE(shallow.requirement(0), nullptr);
+
+  file.write(writeLockfile(nested(65)));
+  ArbiterLockfile deep(file._path, testValueReaders);
+  EXPECT_THROW(deep.requirement(0), Exception::SerializationError);
+}
+
+TEST(LockfileTest, RefusesToWriteCustomRequirements) {
+  ArbiterResolvedDependencyGraph graph;
+  graph.addNode(ArbiterResolvedDependency(makeProjectIdentifier("a"), makeVersion(1, 0, 0)), Requirement::Custom([](const ArbiterSelectedVersion *, const void *) { return true; }, nullptr, nullptr));
+
+  EXPECT_THROW(writeLockfile(graph), Exception::SerializationError);
+
+  char *error = nullptr;
+  EXPECT_FALSE(ArbiterResolvedDependencyGraphWriteLockfileToFunction(&graph, [](const void *, size_t, void *) { return true; }, nullptr, &error));
+  EXPECT_NE(error, nullptr);
+  free(error);
+}
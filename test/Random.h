@@ -0,0 +1,69 @@
+#pragma once
+
+#ifndef __cplusplus
+#error "This file must be compiled as C++."
+#endif
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+
+namespace Arbiter {
+namespace Testing {
+
+/**
+ * Produces random numbers from a seed, identically on every platform.
+ *
+ * The standard distributions are implemented differently by each standard
+ * library, so they are avoided in favor of the raw output of the engine,
+ * which is fully specified.
+ */
+class Random final
+{
+  public:
+    explicit Random (uint32_t seed)
+      : _engine(seed)
+    {}
+
+    /**
+     * Returns a number in [0, bound), or 0 if `bound` is 0.
+     */
+    size_t below (size_t bound)
+    {
+      return bound == 0 ? 0 : size_t(_engine() % bound);
+    }
+
+    /**
+     * Returns a number in [0, 1).
+     */
+    double unit ()
+    {
+      return double(_engine()) / 4294967296.0;
+    }
+
+    bool chance (double probability)
+    {
+      return unit() < probability;
+    }
+
+    /**
+     * Returns a number from the standard normal distribution.
+     */
+    double normal ()
+    {
+      const double pi = 3.14159265358979323846;
+
+      // Box-Muller transform, avoiding log(0).
+      double u1 = 1.0 - unit();
+      double u2 = unit();
+
+      return std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * pi * u2);
+    }
+
+  private:
+    std::mt19937 _engine;
+};
+
+} // namespace Testing
+} // namespace Arbiter
@@ -1,6 +1,8 @@
 #include "Requirement.h"
 
+#include "PredicateCache.h"
 #include "TestValue.h"
+#include "VersionBlock.h"
 
 #include "gtest/gtest.h"
 
@@ -8,6 +10,79 @@ using namespace Arbiter;
 using namespace Requirement;
 using namespace Testing;
 
+namespace {
+
+std::vector<ArbiterSelectedVersion> makeVersionsForBlock ()
+{
+  std::vector<ArbiterSelectedVersion> versions;
+
+  // Enough versions to span several mask words and exercise the scalar tail of
+  // the SIMD comparisons.
+  for (unsigned major = 0; major < 3; major++) {
+    for (unsigned minor = 0; minor < 5; minor++) {
+      for (unsigned patch = 0; patch < 6; patch++) {
+        versions.emplace_back(ArbiterSemanticVersion(major, minor, patch), makeSharedUserValue<ArbiterSelectedVersion, EmptyTestValue>());
+        versions.emplace_back(ArbiterSemanticVersion(major, minor, patch, makeOptional("alpha.1")), makeSharedUserValue<ArbiterSelectedVersion, EmptyTestValue>());
+      }
+    }
+  }
+
+  versions.emplace_back(ArbiterSemanticVersion(1, 2, 3, makeOptional("alpha.2")), makeSharedUserValue<ArbiterSelectedVersion, EmptyTestValue>());
+  versions.emplace_back(ArbiterSemanticVersion(1, 2, 3, makeOptional("alpha.1"), makeOptional("dailybuild")), makeSharedUserValue<ArbiterSelectedVersion, EmptyTestValue>());
+  versions.emplace_back(ArbiterSemanticVersion(1, 2, 3, None(), makeOptional("dailybuild")), makeSharedUserValue<ArbiterSelectedVersion, EmptyTestValue>());
+  versions.emplace_back(ArbiterSemanticVersion(4000000000u, 0, 0), makeSharedUserValue<ArbiterSelectedVersion, EmptyTestValue>());
+  versions.emplace_back(None(), makeSharedUserValue<ArbiterSelectedVersion, StringTestValue>("branch"));
+
+  return versions;
+}
+
+void expectBlockMatchesScalar (const ArbiterRequirement &requirement, const std::vector<ArbiterSelectedVersion> &versions)
+{
+  VersionBlock block(versions.begin(), versions.end());
+
+  std::vector<uint64_t> mask(block.wordCount());
+  requirement.satisfiedByEach(block, mask.data(), nullptr);
+
+  for (size_t i = 0; i < versions.size(); i++) {
+    EXPECT_EQ(maskTest(mask.data(), i), requirement.satisfiedBy(versions[i])) << requirement << " with " << versions[i];
+  }
+
+  // No bits should be set past the end of the block.
+  if (size_t remainder = versions.size() % 64) {
+    EXPECT_EQ(mask.back() >> remainder, 0);
+  }
+}
+
+struct BatchPredicateContext final
+{
+  public:
+    size_t _batchCalls = 0;
+    size_t _versionsChecked = 0;
+};
+
+bool hasEvenMinor (const ArbiterSelectedVersion *version)
+{
+  return version->_semanticVersion && version->_semanticVersion->_minor % 2 == 0;
+}
+
+bool evenMinorPredicate (const ArbiterSelectedVersion *version, const void *)
+{
+  return hasEvenMinor(version);
+}
+
+void evenMinorBatchPredicate (const ArbiterSelectedVersion * const *versions, size_t count, bool *results, const void *context)
+{
+  auto *counts = static_cast<BatchPredicateContext *>(const_cast<void *>(context));
+  counts->_batchCalls++;
+  counts->_versionsChecked += count;
+
+  for (size_t i = 0; i < count; i++) {
+    results[i] = hasEvenMinor(versions[i]);
+  }
+}
+
+} // namespace
+
 TEST(RequirementTest, AnyRequirement) {
   Any req;
   EXPECT_EQ(req, *req.clone());
@@ -236,3 +311,78 @@ TEST(RequirementTest, ExactlyIntersects) {
     EXPECT_EQ(rhs.intersect(lhs), nullptr);
   }
 }
+
+TEST(RequirementTest, SatisfiedByEachMatchesSatisfiedBy) {
+  const std::vector<ArbiterSelectedVersion> versions = makeVersionsForBlock();
+
+  expectBlockMatchesScalar(Any(), versions);
+  expectBlockMatchesScalar(AtLeast(ArbiterSemanticVersion(1, 2, 3)), versions);
+  expectBlockMatchesScalar(AtLeast(ArbiterSemanticVersion(1, 2, 3, makeOptional("alpha.2"))), versions);
+  expectBlockMatchesScalar(AtLeast(ArbiterSemanticVersion(0, 0, 0)), versions);
+  expectBlockMatchesScalar(CompatibleWith(ArbiterSemanticVersion(1, 2, 3), ArbiterRequirementStrictnessStrict), versions);
+  expectBlockMatchesScalar(CompatibleWith(ArbiterSemanticVersion(1, 2, 3, makeOptional("alpha.1")), ArbiterRequirementStrictnessStrict), versions);
+  expectBlockMatchesScalar(CompatibleWith(ArbiterSemanticVersion(0, 2, 3), ArbiterRequirementStrictnessStrict), versions);
+  expectBlockMatchesScalar(CompatibleWith(ArbiterSemanticVersion(0, 2, 3), ArbiterRequirementStrictnessAllowVersionZeroPatches), versions);
+  expectBlockMatchesScalar(Exactly(ArbiterSemanticVersion(1, 2, 3)), versions);
+  expectBlockMatchesScalar(Exactly(ArbiterSemanticVersion(1, 2, 3, makeOptional("alpha.1"), makeOptional("dailybuild"))), versions);
+  expectBlockMatchesScalar(Unversioned(makeSharedUserValue<ArbiterSelectedVersion, StringTestValue>("branch")), versions);
+
+  std::vector<std::shared_ptr<ArbiterRequirement>> requirements = {
+    std::make_shared<AtLeast>(ArbiterSemanticVersion(1, 0, 0)),
+    std::make_shared<CompatibleWith>(ArbiterSemanticVersion(1, 2, 0), ArbiterRequirementStrictnessStrict),
+  };
+
+  Compound compound(requirements);
+  expectBlockMatchesScalar(compound, versions);
+  expectBlockMatchesScalar(Prioritized(compound.cloneRequirement(), -1), versions);
+}
+
+TEST(RequirementTest, SatisfiedByEachEmptyBlock) {
+  VersionBlock block;
+  EXPECT_EQ(block.wordCount(), 0);
+
+  AtLeast(ArbiterSemanticVersion(1, 2, 3)).satisfiedByEach(block, nullptr, nullptr);
+}
+
+TEST(RequirementTest, CustomBatchPredicate) {
+  const std::vector<ArbiterSelectedVersion> versions = makeVersionsForBlock();
+  auto context = std::make_shared<BatchPredicateContext>();
+
+  Custom requirement(&evenMinorPredicate, &evenMinorBatchPredicate, context);
+  expectBlockMatchesScalar(requirement, versions);
+  EXPECT_EQ(context->_batchCalls, 1);
+  EXPECT_EQ(context->_versionsChecked, versions.size());
+
+  // Without a scalar predicate, individual versions go through the batch
+  // predicate.
+  Custom batchOnly(nullptr, &evenMinorBatchPredicate, context);
+  EXPECT_TRUE(batchOnly.satisfiedBy(versions[0]));
+  EXPECT_EQ(context->_batchCalls, 2);
+  EXPECT_EQ(context->_versionsChecked, versions.size() + 1);
+
+  EXPECT_NE(requirement, batchOnly);
+  EXPECT_EQ(requirement, Custom(&evenMinorPredicate, &evenMinorBatchPredicate, context));
+}
+
+TEST(RequirementTest, CustomBatchPredicateCache) {
+  const std::vector<ArbiterSelectedVersion> versions = makeVersionsForBlock();
+  VersionBlock block(versions.begin(), versions.end());
+  auto context = std::make_shared<BatchPredicateContext>();
+
+  Custom requirement(&evenMinorPredicate, &evenMinorBatchPredicate, context);
+  PredicateCache cache;
+
+  std::vector<uint64_t> first(block.wordCount());
+  requirement.satisfiedByEach(block, first.data(), &cache);
+  EXPECT_EQ(context->_batchCalls, 1);
+
+  std::vector<uint64_t> second(block.wordCount());
+  Prioritized(requirement.cloneRequirement(), 1).satisfiedByEach(block, second.data(), &cache);
+  EXPECT_EQ(context->_batchCalls, 1);
+  EXPECT_EQ(first, second);
+
+  cache.clear();
+  requirement.satisfiedByEach(block, second.data(), &cache);
+  EXPECT_EQ(context->_batchCalls, 2);
+  EXPECT_EQ(first, second);
+}
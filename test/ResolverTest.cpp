@@ -1,4 +1,5 @@
 #include "Dependency.h"
+#include "Exception.h"
 #include "Hash.h"
 #include "Requirement.h"
 #include "Resolver.h"
@@ -10,7 +11,14 @@
 #include "gtest/gtest.h"
 
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <stdexcept>
+#include <unistd.h>
 
 using namespace Arbiter;
 using namespace Testing;
@@ -95,12 +103,83 @@ ArbiterDependencyList *createTransitiveDependencyList (const ArbiterResolver *,
   return new ArbiterDependencyList(std::move(dependencies));
 }
 
+ArbiterDependencyList *createSharedDependencyList (const ArbiterResolver *, const ArbiterProjectIdentifier *project, const ArbiterSelectedVersion *, char **)
+{
+  std::vector<ArbiterDependency> dependencies;
+
+  if (*project != makeProjectIdentifier("shared")) {
+    dependencies.emplace_back(makeProjectIdentifier("shared"), Requirement::Any());
+  }
+
+  return new ArbiterDependencyList(std::move(dependencies));
+}
+
+ArbiterSelectedVersionList *createStringVersionsList (const ArbiterResolver *, const ArbiterProjectIdentifier *, char **)
+{
+  std::vector<ArbiterSelectedVersion> versions;
+
+  versions.emplace_back(ArbiterSemanticVersion(1, 0, 0), SharedUserValue<ArbiterSelectedVersion>(std::string("1.0.0")));
+  versions.emplace_back(ArbiterSemanticVersion(2, 0, 0), SharedUserValue<ArbiterSelectedVersion>(std::string("2.0.0")));
+  versions.emplace_back(None(), SharedUserValue<ArbiterSelectedVersion>(std::string("main")));
+
+  return new ArbiterSelectedVersionList(std::move(versions));
+}
+
+ArbiterDependencyList *createStringDependencyList (const ArbiterResolver *, const ArbiterProjectIdentifier *project, const ArbiterSelectedVersion *, char **)
+{
+  std::vector<ArbiterDependency> dependencies;
+
+  if (static_cast<const char *>(project->_value.data()) == std::string("app")) {
+    std::unique_ptr<ArbiterProjectIdentifier> library(ArbiterCreateProjectIdentifierFromString("library", 7));
+    dependencies.emplace_back(*library, Requirement::Exactly(ArbiterSemanticVersion(1, 0, 0)));
+  }
+
+  return new ArbiterDependencyList(std::move(dependencies));
+}
+
+ArbiterSelectedVersion *createStringSelectedVersionForMetadata (const ArbiterResolver *, const ArbiterProjectIdentifier *, const void *metadata)
+{
+  const char *string = static_cast<const char *>(metadata);
+  return ArbiterCreateSelectedVersionWithStringMetadata(nullptr, string, strlen(string));
+}
+
 ArbiterSelectedVersion *createSelectedVersionForMetadata (const ArbiterResolver *, const ArbiterProjectIdentifier *, const void *metadata)
 {
   const auto &testValue = fromUserValue<StringTestValue>(metadata);
   return new ArbiterSelectedVersion(None(), makeSharedUserValue<ArbiterSelectedVersion, StringTestValue>(testValue._str));
 }
 
+struct TracedEvent final
+{
+  public:
+    ArbiterTraceEventKind _kind;
+    ArbiterTraceEventPhase _phase;
+    size_t _depth;
+    std::string _project;
+};
+
+void collectTraceEvent (const ArbiterTraceEvent *event, const void *context)
+{
+  auto &events = *static_cast<std::vector<TracedEvent> *>(const_cast<void *>(context));
+  events.emplace_back(TracedEvent{ event->kind, event->phase, event->depth, event->project ? toString(*event->project) : "" });
+}
+
+struct ProgressReports final
+{
+  public:
+    std::vector<ArbiterResolverProgress> _reports;
+
+    // The number of reports after which to cancel resolution.
+    size_t _cancelAfter;
+};
+
+bool recordProgress (const ArbiterResolverProgress *progress, const void *context)
+{
+  auto &reports = *static_cast<ProgressReports *>(const_cast<void *>(context));
+  reports._reports.emplace_back(*progress);
+  return reports._reports.size() < reports._cancelAfter;
+}
+
 const ArbiterResolvedDependency &findResolved (const ArbiterResolvedDependencyInstaller &installer, size_t phaseIndex, const std::string &name)
 {
   ArbiterProjectIdentifier identifier = makeProjectIdentifier(name);
@@ -242,6 +321,404 @@ TEST(ResolverTest, ResolvesIncrementallyFromInitialGraph)
   EXPECT_EQ(findResolved(installer, 0, "C")._version._semanticVersion, makeOptional(ArbiterSemanticVersion(1, 0, 0)));
 }
 
+TEST(ResolverTest, ReusesFetchedProjectsAcrossResolutions)
+{
+  ArbiterResolverBehaviors behaviors{&createTransitiveDependencyList, &createVariedVersionsList, nullptr};
+
+  std::vector<ArbiterDependency> dependencies;
+  dependencies.emplace_back(makeProjectIdentifier("ancestor"), Requirement::Any());
+  dependencies.emplace_back(makeProjectIdentifier("parent"), Requirement::Any());
+
+  ArbiterResolver resolver(behaviors, ArbiterResolvedDependencyGraph(), ArbiterDependencyList(std::move(dependencies)), nullptr);
+
+  ArbiterResolvedDependencyGraph first = resolver.resolve();
+  EXPECT_EQ(first.nodes().size(), 6);
+  EXPECT_EQ(resolver._interner.size(), 6);
+  EXPECT_GT(resolver._latestStats._availableVersionFetches, 0);
+
+  ArbiterResolvedDependencyGraph second = resolver.resolve();
+  EXPECT_EQ(second, first);
+  EXPECT_EQ(resolver._interner.size(), 6);
+  EXPECT_EQ(resolver._latestStats._availableVersionFetches, 0);
+  EXPECT_EQ(resolver._latestStats._dependencyListFetches, 0);
+  EXPECT_GT(resolver._latestStats._availableVersionCacheHits, 0);
+  EXPECT_GT(resolver._latestStats._dependencyListCacheHits, 0);
+}
+
+TEST(ResolverTest, CopiesStatistics)
+{
+  ArbiterResolverBehaviors behaviors{&createTransitiveDependencyList, &createVariedVersionsList, nullptr};
+
+  std::vector<ArbiterDependency> dependencies;
+  dependencies.emplace_back(makeProjectIdentifier("ancestor"), Requirement::Any());
+  dependencies.emplace_back(makeProjectIdentifier("parent"), Requirement::Any());
+
+  ArbiterResolver resolver(behaviors, ArbiterResolvedDependencyGraph(), ArbiterDependencyList(std::move(dependencies)), nullptr);
+
+  ArbiterResolverStatistics statistics;
+  EXPECT_FALSE(ArbiterResolverCopyStatistics(&resolver, &statistics, sizeof(statistics)));
+
+  resolver.resolve();
+  ASSERT_TRUE(ArbiterResolverCopyStatistics(&resolver, &statistics, sizeof(statistics)));
+
+  EXPECT_GE(statistics.durationSeconds, statistics.behaviorSeconds);
+
+  // A smaller structure, as from an older header, only has its own fields
+  // written.
+  ArbiterResolverStatistics truncated;
+  std::memset(&truncated, 0xff, sizeof(truncated));
+  ASSERT_TRUE(ArbiterResolverCopyStatistics(&resolver, &truncated, offsetof(ArbiterResolverStatistics, behaviorSeconds)));
+  EXPECT_EQ(truncated.durationSeconds, statistics.durationSeconds);
+  EXPECT_EQ(truncated.availableVersionFetches, UINT64_MAX);
+  EXPECT_EQ(statistics.availableVersionFetches, 6);
+  EXPECT_GT(statistics.availableVersionCacheHits, 0);
+  EXPECT_GE(statistics.dependencyListFetches, 6);
+  EXPECT_EQ(statistics.selectedVersionForMetadataFetches, 0);
+
+  // Two levels of transitive dependencies below the roots.
+  EXPECT_EQ(statistics.maxDepth, 3);
+
+  // One graph copy is made for each permutation.
+  EXPECT_GE(statistics.permutationsAttempted, statistics.maxDepth);
+  EXPECT_EQ(statistics.graphCopies, statistics.permutationsAttempted);
+  EXPECT_EQ(statistics.deadEnds, statistics.permutationsAttempted - statistics.maxDepth);
+
+  // "leaf_majors_only" and "leaf_dailybuild" are each required twice.
+  EXPECT_GE(statistics.requirementIntersections, 2);
+  EXPECT_GT(statistics.peakCandidates, 0);
+}
+
+TEST(ResolverTest, AccountsMemory)
+{
+  ArbiterResolverBehaviors behaviors{&createTransitiveDependencyList, &createVariedVersionsList, nullptr};
+
+  std::vector<ArbiterDependency> dependencies;
+  dependencies.emplace_back(makeProjectIdentifier("ancestor"), Requirement::Any());
+  dependencies.emplace_back(makeProjectIdentifier("parent"), Requirement::Any());
+
+  ArbiterResolver resolver(behaviors, ArbiterResolvedDependencyGraph(), ArbiterDependencyList(std::move(dependencies)), nullptr);
+  resolver.resolve();
+
+  ArbiterResolverStatistics statistics;
+  ASSERT_TRUE(ArbiterResolverCopyStatistics(&resolver, &statistics, sizeof(statistics)));
+
+  // The caches survive the resolution, but the search does not.
+  EXPECT_GT(statistics.availableVersionsMemory.currentBytes, 0);
+  EXPECT_GT(statistics.dependencyListsMemory.currentBytes, 0);
+  EXPECT_EQ(statistics.candidateGraphMemory.currentBytes, 0);
+  EXPECT_GT(statistics.candidateGraphMemory.peakBytes, 0);
+  EXPECT_EQ(statistics.searchStateMemory.currentBytes, 0);
+  EXPECT_GT(statistics.searchStateMemory.peakBytes, 0);
+  EXPECT_GT(statistics.requirementMemory.currentBytes, 0);
+  EXPECT_GE(statistics.requirementMemory.peakBytes, statistics.requirementMemory.currentBytes);
+  EXPECT_GE(statistics.arenaReservedBytes, statistics.candidateGraphMemory.peakBytes);
+
+  const ArbiterMemoryUsage availableVersionsMemory = statistics.availableVersionsMemory;
+  const ArbiterMemoryUsage dependencyListsMemory = statistics.dependencyListsMemory;
+
+  // Everything is cached the second time, so the caches should not grow.
+  resolver.resolve();
+  ASSERT_TRUE(ArbiterResolverCopyStatistics(&resolver, &statistics, sizeof(statistics)));
+
+  EXPECT_EQ(statistics.availableVersionsMemory.currentBytes, availableVersionsMemory.currentBytes);
+  EXPECT_EQ(statistics.availableVersionsMemory.peakBytes, availableVersionsMemory.currentBytes);
+  EXPECT_EQ(statistics.dependencyListsMemory.currentBytes, dependencyListsMemory.currentBytes);
+  EXPECT_EQ(statistics.dependencyListsMemory.peakBytes, dependencyListsMemory.currentBytes);
+  EXPECT_GT(statistics.candidateGraphMemory.peakBytes, 0);
+}
+
+TEST(ResolverTest, ChecksInitialGraphWithoutResolving)
+{
+  ArbiterResolverBehaviors behaviors{&createTransitiveDependencyList, &createVariedVersionsList, nullptr};
+
+  std::vector<ArbiterDependency> dependencies;
+  dependencies.emplace_back(makeProjectIdentifier("ancestor"), Requirement::Any());
+  dependencies.emplace_back(makeProjectIdentifier("parent"), Requirement::Any());
+
+  ArbiterResolvedDependencyGraph resolved = ArbiterResolver(behaviors, ArbiterResolvedDependencyGraph(), ArbiterDependencyList(dependencies), nullptr).resolve();
+
+  ArbiterResolver satisfied(behaviors, resolved, ArbiterDependencyList(dependencies), nullptr);
+  EXPECT_EQ(satisfied.unsatisfiedDependencies(), ArbiterDependencyList());
+  EXPECT_EQ(satisfied._latestStats._availableVersionFetches, 0);
+  EXPECT_EQ(satisfied._latestStats._dependencyListFetches, 6);
+
+  // The lists fetched for the check are reused by resolve(), which only has
+  // to fetch the newer leaf_majors_only candidate that was never selected.
+  EXPECT_EQ(satisfied.resolve(), resolved);
+  EXPECT_EQ(satisfied._latestStats._dependencyListFetches, 1);
+  EXPECT_GE(satisfied._latestStats._dependencyListCacheHits, 6);
+
+  EXPECT_EQ(satisfied.unsatisfiedDependencies(), ArbiterDependencyList());
+  EXPECT_EQ(satisfied._latestStats._dependencyListFetches, 0);
+
+  dependencies.emplace_back(makeProjectIdentifier("leaf"), Requirement::AtLeast(ArbiterSemanticVersion(1, 0, 0)));
+  dependencies.emplace_back(makeProjectIdentifier("unknown"), Requirement::Any());
+
+  ArbiterResolver unsatisfied(behaviors, resolved, ArbiterDependencyList(dependencies), nullptr);
+  std::unique_ptr<ArbiterDependencyList> list(ArbiterResolverCreateUnsatisfiedDependencyList(&unsatisfied, nullptr));
+  ASSERT_NE(list, nullptr);
+  ASSERT_EQ(ArbiterDependencyListCount(list.get()), 2);
+
+  std::vector<const ArbiterDependency *> buffer(2);
+  ArbiterDependencyListGetAll(list.get(), buffer.data());
+  EXPECT_EQ(*buffer[0], dependencies[2]);
+  EXPECT_EQ(*buffer[1], dependencies[3]);
+}
+
+TEST(ResolverTest, ReportsSharedUnsatisfiedDependencyOnce)
+{
+  ArbiterResolverBehaviors behaviors{&createSharedDependencyList, &createMajorVersionsList, nullptr};
+
+  ArbiterResolvedDependencyGraph graph;
+  std::vector<ArbiterDependency> dependencies;
+
+  for (const char *name : { "first", "second" }) {
+    ArbiterSelectedVersion version(ArbiterSemanticVersion(1, 0, 0), makeSharedUserValue<ArbiterSelectedVersion, EmptyTestValue>());
+    graph.addNode(ArbiterResolvedDependency(makeProjectIdentifier(name), std::move(version)), Requirement::Any());
+    dependencies.emplace_back(makeProjectIdentifier(name), Requirement::Any());
+  }
+
+  ArbiterResolver resolver(behaviors, std::move(graph), ArbiterDependencyList(dependencies), nullptr);
+
+  std::vector<ArbiterDependency> expected;
+  expected.emplace_back(makeProjectIdentifier("shared"), Requirement::Any());
+  EXPECT_EQ(resolver.unsatisfiedDependencies(), ArbiterDependencyList(std::move(expected)));
+}
+
+TEST(ResolverTest, TracesResolution)
+{
+  ArbiterResolverBehaviors behaviors{&createTransitiveDependencyList, &createVariedVersionsList, nullptr};
+
+  std::vector<ArbiterDependency> dependencies;
+  dependencies.emplace_back(makeProjectIdentifier("ancestor"), Requirement::Any());
+  dependencies.emplace_back(makeProjectIdentifier("parent"), Requirement::Any());
+
+  ArbiterResolver resolver(behaviors, ArbiterResolvedDependencyGraph(), ArbiterDependencyList(std::move(dependencies)), nullptr);
+
+  std::vector<TracedEvent> events;
+  ArbiterResolverSetTraceFunction(&resolver, &collectTraceEvent, ArbiterUserContext{ &events, nullptr });
+
+  resolver.resolve();
+  ASSERT_FALSE(events.empty());
+
+  // Every span which begins must end, in the reverse order.
+  std::vector<ArbiterTraceEventKind> open;
+  size_t maxDepth = 0;
+  size_t conflicts = 0;
+  size_t dependencyListFetches = 0;
+
+  for (const TracedEvent &event : events) {
+    maxDepth = std::max(maxDepth, event._depth);
+
+    if (event._phase == ArbiterTraceEventPhaseBegin) {
+      open.emplace_back(event._kind);
+    } else if (event._phase == ArbiterTraceEventPhaseEnd) {
+      ASSERT_FALSE(open.empty());
+      EXPECT_EQ(open.back(), event._kind);
+      open.pop_back();
+    } else if (event._kind == ArbiterTraceEventKindConflict) {
+      ++conflicts;
+    }
+
+    if (event._kind == ArbiterTraceEventKindFetchDependencyList && event._phase == ArbiterTraceEventPhaseBegin) {
+      EXPECT_FALSE(event._project.empty());
+      ++dependencyListFetches;
+    }
+  }
+
+  EXPECT_TRUE(open.empty());
+  EXPECT_EQ(maxDepth, resolver._latestStats._maxDepth);
+  EXPECT_EQ(conflicts, resolver._latestStats._deadEnds);
+  EXPECT_EQ(dependencyListFetches, resolver._latestStats._dependencyListFetches);
+
+  // Nothing else is emitted once tracing is disabled.
+  events.clear();
+  ArbiterResolverSetTraceFunction(&resolver, nullptr, ArbiterUserContext{ nullptr, nullptr });
+  resolver.resolve();
+  EXPECT_TRUE(events.empty());
+}
+
+TEST(ResolverTest, WritesChromeTraceFile)
+{
+  ArbiterResolverBehaviors behaviors{&createTransitiveDependencyList, &createVariedVersionsList, nullptr};
+
+  std::vector<ArbiterDependency> dependencies;
+  dependencies.emplace_back(makeProjectIdentifier("parent"), Requirement::Any());
+
+  char path[] = "/tmp/ArbiterTraceTest.XXXXXX";
+  close(mkstemp(path));
+
+  {
+    ArbiterResolver resolver(behaviors, ArbiterResolvedDependencyGraph(), ArbiterDependencyList(std::move(dependencies)), nullptr);
+    ASSERT_TRUE(ArbiterResolverSetTraceFile(&resolver, path, nullptr));
+    resolver.resolve();
+  }
+
+  std::ifstream stream(path);
+  std::string contents((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+  std::remove(path);
+
+  EXPECT_EQ(contents.find("{\"traceEvents\":["), 0);
+  EXPECT_EQ(contents.substr(contents.size() - 4), "\n]}\n");
+  EXPECT_NE(contents.find("\"name\":\"createDependencyList\",\"cat\":\"arbiter\",\"ph\":\"B\""), std::string::npos);
+  EXPECT_NE(contents.find("\"project\":\"ArbiterProjectIdentifier(leaf)\""), std::string::npos);
+
+  char *error = nullptr;
+  ArbiterResolver resolver(behaviors, ArbiterResolvedDependencyGraph(), ArbiterDependencyList(), nullptr);
+  EXPECT_FALSE(ArbiterResolverSetTraceFile(&resolver, "/nonexistent/trace.json", &error));
+  EXPECT_NE(error, nullptr);
+  free(error);
+}
+
+TEST(ResolverTest, ResolvesWithinLimits)
+{
+  ArbiterResolverBehaviors behaviors{&createTransitiveDependencyList, &createVariedVersionsList, nullptr};
+
+  std::vector<ArbiterDependency> dependencies;
+  dependencies.emplace_back(makeProjectIdentifier("ancestor"), Requirement::Any());
+  dependencies.emplace_back(makeProjectIdentifier("parent"), Requirement::Any());
+
+  ArbiterResolver resolver(behaviors, ArbiterResolvedDependencyGraph(), ArbiterDependencyList(std::move(dependencies)), nullptr);
+
+  ProgressReports reports{ {}, SIZE_MAX };
+
+  ArbiterResolverLimits limits{};
+  limits.timeLimitSeconds = 60;
+  limits.maxDeadEnds = 1000;
+  limits.maxFetches = 1000;
+  limits.progress = &recordProgress;
+
+  ArbiterResolverSetLimits(&resolver, &limits, ArbiterUserContext{ &reports, nullptr });
+
+  std::unique_ptr<ArbiterResolvedDependencyGraph> graph(ArbiterResolverCreateResolvedDependencyGraph(&resolver, nullptr));
+  ASSERT_NE(graph, nullptr);
+  EXPECT_EQ(graph->nodes().size(), 6);
+
+  EXPECT_EQ(ArbiterResolverGetCancellation(&resolver), ArbiterResolverCancellationNone);
+  EXPECT_EQ(ArbiterResolverCreatePartialDependencyGraph(&resolver), nullptr);
+
+  // Progress is reported for every permutation and fetch.
+  ASSERT_FALSE(reports._reports.empty());
+  EXPECT_EQ(reports._reports.front().fetchedProjects, 1);
+  EXPECT_EQ(reports._reports.back().depth, 3);
+
+  for (size_t i = 1; i < reports._reports.size(); i++) {
+    EXPECT_GE(reports._reports[i].deadEnds, reports._reports[i - 1].deadEnds);
+    EXPECT_GE(reports._reports[i].fetches, reports._reports[i - 1].fetches);
+    EXPECT_GE(reports._reports[i].elapsedSeconds, reports._reports[i - 1].elapsedSeconds);
+  }
+}
+
+TEST(ResolverTest, CancelsWhenFetchLimitIsExceeded)
+{
+  ArbiterResolverBehaviors behaviors{&createTransitiveDependencyList, &createVariedVersionsList, nullptr};
+
+  std::vector<ArbiterDependency> dependencies;
+  dependencies.emplace_back(makeProjectIdentifier("ancestor"), Requirement::Any());
+  dependencies.emplace_back(makeProjectIdentifier("parent"), Requirement::Any());
+
+  ArbiterResolver resolver(behaviors, ArbiterResolvedDependencyGraph(), ArbiterDependencyList(std::move(dependencies)), nullptr);
+
+  ArbiterResolverLimits limits{};
+  limits.maxFetches = 4;
+  ArbiterResolverSetLimits(&resolver, &limits, ArbiterUserContext{ nullptr, nullptr });
+
+  char *error = nullptr;
+  EXPECT_EQ(ArbiterResolverCreateResolvedDependencyGraph(&resolver, &error), nullptr);
+  ASSERT_NE(error, nullptr);
+  EXPECT_EQ(std::string(error), "Resolution cancelled: too many fetches");
+  free(error);
+
+  EXPECT_EQ(ArbiterResolverGetCancellation(&resolver), ArbiterResolverCancellationFetchLimit);
+  EXPECT_EQ(resolver._latestStats._availableVersionFetches + resolver._latestStats._dependencyListFetches, 5);
+
+  // The roots were selected before the limit was reached.
+  std::unique_ptr<ArbiterResolvedDependencyGraph> partial(ArbiterResolverCreatePartialDependencyGraph(&resolver));
+  ASSERT_NE(partial, nullptr);
+  EXPECT_EQ(partial->nodes().size(), 2);
+
+  // Everything fetched is kept, so retrying eventually succeeds.
+  std::unique_ptr<ArbiterResolvedDependencyGraph> graph;
+  for (size_t attempt = 0; attempt < 10 && !graph; attempt++) {
+    graph.reset(ArbiterResolverCreateResolvedDependencyGraph(&resolver, nullptr));
+  }
+
+  ASSERT_NE(graph, nullptr);
+  EXPECT_EQ(ArbiterResolverGetCancellation(&resolver), ArbiterResolverCancellationNone);
+  EXPECT_EQ(graph->nodes().size(), 6);
+}
+
+TEST(ResolverTest, CancelsFromProgressFunction)
+{
+  ArbiterResolverBehaviors behaviors{&createTransitiveDependencyList, &createVariedVersionsList, nullptr};
+
+  std::vector<ArbiterDependency> dependencies;
+  dependencies.emplace_back(makeProjectIdentifier("ancestor"), Requirement::Any());
+  dependencies.emplace_back(makeProjectIdentifier("parent"), Requirement::Any());
+
+  ArbiterResolver resolver(behaviors, ArbiterResolvedDependencyGraph(), ArbiterDependencyList(std::move(dependencies)), nullptr);
+
+  ProgressReports reports{ {}, 3 };
+
+  ArbiterResolverLimits limits{};
+  limits.progress = &recordProgress;
+  ArbiterResolverSetLimits(&resolver, &limits, ArbiterUserContext{ &reports, nullptr });
+
+  EXPECT_THROW(resolver.resolve(), Exception::Cancelled);
+  EXPECT_EQ(reports._reports.size(), 3);
+  EXPECT_EQ(ArbiterResolverGetCancellation(&resolver), ArbiterResolverCancellationRequested);
+
+  std::unique_ptr<ArbiterResolvedDependencyGraph> partial(ArbiterResolverCreatePartialDependencyGraph(&resolver));
+  ASSERT_NE(partial, nullptr);
+
+  // Removing the limits allows resolution to complete.
+  ArbiterResolverSetLimits(&resolver, nullptr, ArbiterUserContext{ nullptr, nullptr });
+  EXPECT_EQ(resolver.resolve().nodes().size(), 6);
+  EXPECT_EQ(reports._reports.size(), 3);
+}
+
+TEST(ResolverTest, ResolvesStringValues)
+{
+  ArbiterResolverBehaviors behaviors{&createStringDependencyList, &createStringVersionsList, &createStringSelectedVersionForMetadata};
+
+  std::unique_ptr<ArbiterProjectIdentifier> app(ArbiterCreateProjectIdentifierFromString("app", 3));
+  std::unique_ptr<ArbiterRequirement> branch(ArbiterCreateRequirementUnversionedWithString("main", 4));
+
+  std::vector<ArbiterDependency> dependencies;
+  dependencies.emplace_back(*app, *branch);
+
+  ArbiterResolver resolver(behaviors, ArbiterResolvedDependencyGraph(), ArbiterDependencyList(std::move(dependencies)), nullptr);
+
+  ArbiterResolvedDependencyGraph resolved = resolver.resolve();
+  EXPECT_EQ(resolved.nodes().size(), 2);
+
+  std::unique_ptr<ArbiterProjectIdentifier> library(ArbiterCreateProjectIdentifierFromString("library", 7));
+  EXPECT_EQ(toString(resolved.nodes().at(*library)._version), "1.0.0 (1.0.0)");
+
+  const ArbiterSelectedVersion &appVersion = resolved.nodes().at(*app)._version;
+  EXPECT_FALSE(appVersion._semanticVersion);
+  EXPECT_STREQ(static_cast<const char *>(ArbiterSelectedVersionMetadata(&appVersion)), "main");
+}
+
+TEST(ResolverTest, OrdersStringValuesBeforeUserValues)
+{
+  using Value = SharedUserValue<ArbiterProjectIdentifier>;
+
+  Value first(std::string("app"));
+  Value second(std::string("app"));
+  Value user = makeSharedUserValue<ArbiterProjectIdentifier, StringTestValue>("app");
+
+  // Equal strings are compared by contents, not by storage.
+  EXPECT_NE(first.data(), second.data());
+  EXPECT_EQ(first, second);
+  EXPECT_FALSE(first < second);
+
+  // Mixed kinds never reach the user's callbacks.
+  EXPECT_NE(first, user);
+  EXPECT_LT(first, user);
+  EXPECT_FALSE(user < first);
+}
+
 #if 0
 TEST(ResolverTest, FailsWhenNoAvailableVersions)
 {}
@@ -0,0 +1,152 @@
+#include "Ecosystem.h"
+#include "Resolver.h"
+#include "ResultCache.h"
+#include "Sha256.h"
+
+#include "TestValue.h"
+
+#include "gtest/gtest.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <unistd.h>
+
+using namespace Arbiter;
+using namespace Testing;
+
+namespace {
+
+ArbiterUserValue createTestValue (const void *bytes, size_t length, const void *)
+{
+  return TestValue::fromSerialization(bytes, length);
+}
+
+const ArbiterLockfileValueReaders testValueReaders = { &createTestValue, &createTestValue, nullptr };
+
+EcosystemOptions smallOptions ()
+{
+  EcosystemOptions options;
+  options._seed = 7;
+  options._packageCount = 20;
+  options._versionsPerPackage = 4;
+  options._rootDependencyCount = 3;
+  options._compatibleWithWeight = 0;
+  options._exactlyWeight = 0;
+  return options;
+}
+
+std::string sha256Hex (const std::string &message)
+{
+  Sha256 hash;
+  hash.update(message.data(), message.size());
+  return Sha256::hex(hash.finish());
+}
+
+} // namespace
+
+TEST(ResultCacheTest, ComputesSha256) {
+  EXPECT_EQ(sha256Hex(""), "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+  EXPECT_EQ(sha256Hex("abc"), "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+  EXPECT_EQ(sha256Hex("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"), "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+
+  // Updating in pieces is the same as updating all at once.
+  const std::string message(1000, 'a');
+
+  Sha256 hash;
+  for (size_t offset = 0; offset < message.size(); offset += 7) {
+    hash.update(message.data() + offset, std::min<size_t>(7, message.size() - offset));
+  }
+
+  EXPECT_EQ(Sha256::hex(hash.finish()), sha256Hex(message));
+}
+
+TEST(ResultCacheTest, ReturnsCachedGraphWithoutFetching) {
+  Ecosystem ecosystem(smallOptions());
+  const ArbiterDependencyList dependencies = ecosystem.rootDependencies();
+
+  ArbiterResultCache cache(4, None(), testValueReaders);
+
+  std::unique_ptr<ArbiterResolver> first = ecosystem.createResolver(dependencies);
+  first->setResultCache(&cache, "1");
+
+  ArbiterResolvedDependencyGraph resolved = first->resolve();
+  EXPECT_EQ(first->_latestStats._resultCacheHits, 0);
+  EXPECT_GT(first->_latestStats._availableVersionFetches, 0);
+  EXPECT_EQ(cache.size(), 1);
+
+  std::unique_ptr<ArbiterResolver> second = ecosystem.createResolver(dependencies);
+  second->setResultCache(&cache, "1");
+
+  EXPECT_EQ(second->resolve(), resolved);
+  EXPECT_EQ(second->_latestStats._resultCacheHits, 1);
+  EXPECT_EQ(second->_latestStats._availableVersionFetches, 0);
+  EXPECT_EQ(second->_latestStats._dependencyListFetches, 0);
+
+  // A new registry epoch must not reuse the old result.
+  std::unique_ptr<ArbiterResolver> third = ecosystem.createResolver(dependencies);
+  third->setResultCache(&cache, "2");
+
+  EXPECT_EQ(third->resolve(), resolved);
+  EXPECT_EQ(third->_latestStats._resultCacheHits, 0);
+  EXPECT_EQ(cache.size(), 2);
+}
+
+TEST(ResultCacheTest, EvictsLeastRecentlyUsedGraph) {
+  Ecosystem ecosystem(smallOptions());
+  const ArbiterDependencyList dependencies = ecosystem.rootDependencies();
+  const ArbiterResolvedDependencyGraph resolved = ecosystem.createResolver(dependencies)->resolve();
+
+  auto a = ArbiterResultCache::fingerprint(dependencies, ArbiterResolvedDependencyGraph(), "a");
+  auto b = ArbiterResultCache::fingerprint(dependencies, ArbiterResolvedDependencyGraph(), "b");
+  auto c = ArbiterResultCache::fingerprint(dependencies, ArbiterResolvedDependencyGraph(), "c");
+  ASSERT_TRUE(a && b && c);
+  EXPECT_NE(*a, *b);
+
+  ArbiterResultCache cache(2, None(), testValueReaders);
+  cache.insert(*a, resolved);
+  cache.insert(*b, resolved);
+
+  // Using `a` makes `b` the least recently used.
+  EXPECT_TRUE(bool(cache.find(*a)));
+  cache.insert(*c, resolved);
+
+  EXPECT_EQ(cache.size(), 2);
+  EXPECT_TRUE(bool(cache.find(*a)));
+  EXPECT_FALSE(bool(cache.find(*b)));
+  EXPECT_TRUE(bool(cache.find(*c)));
+}
+
+TEST(ResultCacheTest, ReadsGraphsFromDirectory) {
+  char path[] = "/tmp/ArbiterResultCacheTest.XXXXXX";
+  ASSERT_NE(mkdtemp(path), nullptr);
+
+  Ecosystem ecosystem(smallOptions());
+  const ArbiterDependencyList dependencies = ecosystem.rootDependencies();
+
+  ArbiterResolvedDependencyGraph resolved;
+  {
+    ArbiterResultCache cache(4, makeOptional(std::string(path)), testValueReaders);
+
+    std::unique_ptr<ArbiterResolver> resolver = ecosystem.createResolver(dependencies);
+    resolver->setResultCache(&cache, "epoch");
+    resolved = resolver->resolve();
+  }
+
+  // A new cache has nothing in memory, but finds the lockfile.
+  ArbiterResultCache cache(4, makeOptional(std::string(path)), testValueReaders);
+  EXPECT_EQ(cache.size(), 0);
+
+  std::unique_ptr<ArbiterResolver> resolver = ecosystem.createResolver(dependencies);
+  resolver->setResultCache(&cache, "epoch");
+
+  EXPECT_EQ(resolver->resolve(), resolved);
+  EXPECT_EQ(resolver->_latestStats._resultCacheHits, 1);
+  EXPECT_EQ(cache.size(), 1);
+
+  char *error = nullptr;
+  EXPECT_EQ(ArbiterCreateResultCache(1, "/nonexistent/ArbiterResultCacheTest", testValueReaders, &error), nullptr);
+  EXPECT_NE(error, nullptr);
+  free(error);
+}
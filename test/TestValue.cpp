@@ -2,6 +2,10 @@
 
 #include "Hash.h"
 
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+
 namespace Arbiter {
 namespace Testing {
 
@@ -43,17 +47,44 @@ static char *createDescription (const void *data)
   return copyCString(toString(*static_cast<const TestValue *>(data))).release();
 }
 
+static void *createSerialization (const void *data, size_t *length)
+{
+  // Empty values serialize to nothing, which is how they are told apart when
+  // deserializing.
+  std::string bytes;
+  if (const auto *ptr = dynamic_cast<const StringTestValue *>(static_cast<const TestValue *>(data))) {
+    bytes = "s" + ptr->_str;
+  }
+
+  *length = bytes.size();
+
+  void *buffer = malloc(bytes.size() + 1);
+  memcpy(buffer, bytes.data(), bytes.size());
+  return buffer;
+}
+
 } // namespace
 
+ArbiterUserValue TestValue::fromSerialization (const void *bytes, size_t length)
+{
+  if (length == 0) {
+    return convertToUserValue(std::make_unique<EmptyTestValue>());
+  }
+
+  assert(static_cast<const char *>(bytes)[0] == 's');
+  return convertToUserValue(std::make_unique<StringTestValue>(std::string(static_cast<const char *>(bytes) + 1, length - 1)));
+}
+
 ArbiterUserValue TestValue::convertToUserValue (std::unique_ptr<TestValue> testValue)
 {
-  ArbiterUserValue userValue;
+  ArbiterUserValue userValue = {};
   userValue.data = testValue.release();
   userValue.equalTo = &::equalTo;
   userValue.lessThan = &::lessThan;
   userValue.hash = &::hash;
   userValue.destructor = &::destructor;
   userValue.createDescription = &::createDescription;
+  userValue.createSerialization = &::createSerialization;
   return userValue;
 }
 
@@ -28,6 +28,12 @@ class TestValue
     virtual size_t hash () const = 0;
 
     static ArbiterUserValue convertToUserValue (std::unique_ptr<TestValue> testValue);
+
+    /**
+     * Recreates an EmptyTestValue or StringTestValue from the serialization
+     * created for it.
+     */
+    static ArbiterUserValue fromSerialization (const void *bytes, size_t length);
 };
 
 std::ostream &operator<< (std::ostream &os, const TestValue &value);
@@ -44,6 +44,58 @@ TEST(VersionTest, FailsToParseMalformedVersions) {
   EXPECT_EQ(ArbiterSemanticVersion::fromString("1.0.0-alpha.01").pointer(), nullptr);
   EXPECT_EQ(ArbiterSemanticVersion::fromString("1.0.0-alpha$1").pointer(), nullptr);
   EXPECT_EQ(ArbiterSemanticVersion::fromString("1.0.0+build$1").pointer(), nullptr);
+  EXPECT_EQ(ArbiterSemanticVersion::fromString("").pointer(), nullptr);
+  EXPECT_EQ(ArbiterSemanticVersion::fromString("1.0.0-").pointer(), nullptr);
+  EXPECT_EQ(ArbiterSemanticVersion::fromString("1.0.0+").pointer(), nullptr);
+  EXPECT_EQ(ArbiterSemanticVersion::fromString("1.0.0-alpha..1").pointer(), nullptr);
+  EXPECT_EQ(ArbiterSemanticVersion::fromString("1.0.0+build+1").pointer(), nullptr);
+  EXPECT_EQ(ArbiterSemanticVersion::fromString("1.0.0 ").pointer(), nullptr);
+  EXPECT_EQ(ArbiterSemanticVersion::fromString("4294967296.0.0").pointer(), nullptr);
+}
+
+TEST(VersionTest, ParsesLengthDelimitedStrings) {
+  const char *string = "1.0.2-alpha.1+dailybuild";
+  EXPECT_EQ(ArbiterSemanticVersion::fromString(string, 5).value(), ArbiterSemanticVersion(1, 0, 2));
+  EXPECT_EQ(ArbiterSemanticVersion::fromString(string, 13).value(), ArbiterSemanticVersion(1, 0, 2, makeOptional("alpha.1")));
+  EXPECT_EQ(ArbiterSemanticVersion::fromString(string, 4).pointer(), nullptr);
+  EXPECT_EQ(ArbiterSemanticVersion::fromString("4294967295.0.0").value(), ArbiterSemanticVersion(4294967295u, 0, 0));
+}
+
+TEST(VersionTest, ReportsParseErrors) {
+  std::string error;
+
+  EXPECT_EQ(ArbiterSemanticVersion::fromString("1.0", &error).pointer(), nullptr);
+  EXPECT_EQ(error, "expected '.' after minor version at offset 3 in version \"1.0\"");
+
+  EXPECT_EQ(ArbiterSemanticVersion::fromString("01.0.0", &error).pointer(), nullptr);
+  EXPECT_EQ(error, "version numbers cannot have a leading zero at offset 0 in version \"01.0.0\"");
+
+  EXPECT_EQ(ArbiterSemanticVersion::fromString("1.0.0-alpha.01", &error).pointer(), nullptr);
+  EXPECT_EQ(error, "identifiers cannot have a leading zero at offset 12 in version \"1.0.0-alpha.01\"");
+
+  EXPECT_EQ(ArbiterSemanticVersion::fromString("1.0.0+build$1", &error).pointer(), nullptr);
+  EXPECT_EQ(error, "invalid character in identifier at offset 11 in version \"1.0.0+build$1\"");
+
+  EXPECT_EQ(ArbiterSemanticVersion::fromString("1.0.0a1", &error).pointer(), nullptr);
+  EXPECT_EQ(error, "expected '-', '+', or end of version after patch version at offset 5 in version \"1.0.0a1\"");
+
+  EXPECT_EQ(ArbiterSemanticVersion::fromString("1.99999999999.0", &error).pointer(), nullptr);
+  EXPECT_EQ(error, "version number is too large at offset 2 in version \"1.99999999999.0\"");
+}
+
+TEST(VersionTest, ParsesManyStrings) {
+  const char *strings[] = { "1.0.0", "1.0", "2.0.0-beta+1" };
+  ArbiterSemanticVersion *versions[3];
+
+  EXPECT_EQ(ArbiterCreateSemanticVersionsFromStrings(strings, 3, versions), 2);
+  ASSERT_NE(versions[0], nullptr);
+  EXPECT_EQ(*versions[0], ArbiterSemanticVersion(1, 0, 0));
+  EXPECT_EQ(versions[1], nullptr);
+  ASSERT_NE(versions[2], nullptr);
+  EXPECT_EQ(*versions[2], ArbiterSemanticVersion(2, 0, 0, makeOptional("beta"), makeOptional("1")));
+
+  ArbiterFree(versions[0]);
+  ArbiterFree(versions[2]);
 }
 
 TEST(VersionTest, ComparesForEquality) {
@@ -71,6 +123,51 @@ TEST(VersionTest, ComparesForPrecedence) {
   EXPECT_LT(ArbiterSemanticVersion(1, 2, 3, makeOptional("1")), ArbiterSemanticVersion(1, 2, 3, makeOptional("alpha")));
 }
 
+TEST(VersionTest, ComparesPrereleaseIdentifiersForPrecedence) {
+  EXPECT_LT(ArbiterSemanticVersion(1, 2, 3, makeOptional("alpha.1.beta")), ArbiterSemanticVersion(1, 2, 3, makeOptional("alpha.1.gamma")));
+  EXPECT_LT(ArbiterSemanticVersion(1, 2, 3, makeOptional("alpha.99")), ArbiterSemanticVersion(1, 2, 3, makeOptional("alpha.1a")));
+  EXPECT_LT(ArbiterSemanticVersion(1, 2, 3, makeOptional("18446744073709551615")), ArbiterSemanticVersion(1, 2, 3, makeOptional("18446744073709551616")));
+  EXPECT_FALSE(ArbiterSemanticVersion(1, 2, 3, makeOptional("alpha.1")) < ArbiterSemanticVersion(1, 2, 3, makeOptional("alpha.1"), makeOptional("dailybuild")));
+  EXPECT_FALSE(ArbiterSemanticVersion(1, 2, 3, makeOptional("alpha.1"), makeOptional("dailybuild")) < ArbiterSemanticVersion(1, 2, 3, makeOptional("alpha.1")));
+}
+
+TEST(VersionTest, TokenizesIdentifiers) {
+  ArbiterSemanticVersion version(1, 2, 3, makeOptional("alpha.12"), makeOptional("build.007"));
+
+  ASSERT_EQ(version._prereleaseIdentifiers.size(), 2);
+  EXPECT_FALSE(version._prereleaseIdentifiers[0]._numeric);
+  EXPECT_EQ(version._prereleaseIdentifiers[0]._string.str(), "alpha");
+  EXPECT_TRUE(version._prereleaseIdentifiers[1]._numeric);
+  EXPECT_EQ(version._prereleaseIdentifiers[1]._number, 12);
+
+  // Build metadata is not interned.
+  EXPECT_EQ(version._buildMetadata, makeOptional(std::string("build.007")));
+
+  // Identifiers are interned, so they share storage across versions.
+  ArbiterSemanticVersion other(2, 0, 0, makeOptional("alpha"));
+  EXPECT_EQ(&other._prereleaseIdentifiers[0]._string.str(), &version._prereleaseIdentifiers[0]._string.str());
+  EXPECT_EQ(InternedString("alpha"), other._prereleaseIdentifiers[0]._string);
+  EXPECT_NE(InternedString("beta"), other._prereleaseIdentifiers[0]._string);
+
+  EXPECT_NE(ArbiterSemanticVersion(1, 0, 0, makeOptional("")), ArbiterSemanticVersion(1, 0, 0));
+  EXPECT_NE(ArbiterSemanticVersion(1, 0, 0, None(), makeOptional("")), ArbiterSemanticVersion(1, 0, 0));
+}
+
+TEST(VersionTest, ComparesLargeComponentsForPrecedence) {
+  const unsigned large = 1u << 21;
+
+  EXPECT_TRUE(ArbiterSemanticVersion(1, 2, 3)._precedenceKeyExact);
+  EXPECT_FALSE(ArbiterSemanticVersion(1, large, 3)._precedenceKeyExact);
+
+  EXPECT_LT(ArbiterSemanticVersion(1, large - 1, 3), ArbiterSemanticVersion(1, large, 3));
+  EXPECT_LT(ArbiterSemanticVersion(1, large, 3), ArbiterSemanticVersion(1, large + 1, 0));
+  EXPECT_LT(ArbiterSemanticVersion(1, large, 3), ArbiterSemanticVersion(2, 0, 0));
+  EXPECT_LT(ArbiterSemanticVersion(large, 0, 0), ArbiterSemanticVersion(4000000000u, 0, 0));
+  EXPECT_LT(ArbiterSemanticVersion(1, 2, large, makeOptional("alpha")), ArbiterSemanticVersion(1, 2, large));
+  EXPECT_LT(ArbiterSemanticVersion(1, 2, large + 1, makeOptional("alpha")), ArbiterSemanticVersion(1, 2, large + 2));
+  EXPECT_FALSE(ArbiterSemanticVersion(1, 2, large) < ArbiterSemanticVersion(1, 2, large));
+}
+
 TEST(VersionTest, ConvertsToString) {
   std::stringstream stream;
   stream << ArbiterSemanticVersion(1, 2, 3, makeOptional("alpha.1"), makeOptional("dailybuild"));
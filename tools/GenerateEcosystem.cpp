@@ -0,0 +1,119 @@
+#include "Ecosystem.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <sys/stat.h>
+
+using namespace Arbiter;
+using namespace Testing;
+
+namespace {
+
+void printUsage (const char *program)
+{
+  EcosystemOptions defaults;
+
+  std::cerr
+    << "Usage: " << program << " [options] <directory>\n"
+    << "\n"
+    << "Generates a synthetic dependency ecosystem in <directory>, in the format of\n"
+    << "test/fixtures/carthage-graph. The root project is named \"" << Ecosystem::rootProjectName << "\".\n"
+    << "\n"
+    << "Options:\n"
+    << "  --seed N               Random seed (default " << defaults._seed << ")\n"
+    << "  --packages N           Number of packages (default " << defaults._packageCount << ")\n"
+    << "  --versions N           Versions per package (default " << defaults._versionsPerPackage << ")\n"
+    << "  --fan-out N            Most dependencies per version (default " << defaults._fanOut << ")\n"
+    << "  --roots N              Dependencies of the root project (default " << defaults._rootDependencyCount << ")\n"
+    << "  --compatible-with W    Relative weight of ~> constraints (default " << defaults._compatibleWithWeight << ")\n"
+    << "  --at-least W           Relative weight of >= constraints (default " << defaults._atLeastWeight << ")\n"
+    << "  --exactly W            Relative weight of == constraints (default " << defaults._exactlyWeight << ")\n"
+    << "  --conflict-density P   Probability of pinning to any old version (default " << defaults._conflictDensity << ")\n"
+    << "  --prerelease-share P   Probability of each version being a prerelease (default " << defaults._prereleaseShare << ")\n";
+}
+
+} // namespace
+
+int main (int argc, const char **argv)
+{
+  EcosystemOptions options;
+  const char *directory = nullptr;
+
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+
+    if (arg == "--help" || arg == "-h") {
+      printUsage(argv[0]);
+      return EXIT_SUCCESS;
+    }
+
+    if (arg.compare(0, 2, "--") != 0) {
+      if (directory) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+      }
+
+      directory = argv[i];
+      continue;
+    }
+
+    if (i + 1 >= argc) {
+      std::cerr << "Missing value for " << arg << "\n";
+      return EXIT_FAILURE;
+    }
+
+    const char *value = argv[++i];
+
+    if (arg == "--seed") {
+      options._seed = uint32_t(std::strtoul(value, nullptr, 10));
+    } else if (arg == "--packages") {
+      options._packageCount = std::strtoul(value, nullptr, 10);
+    } else if (arg == "--versions") {
+      options._versionsPerPackage = std::strtoul(value, nullptr, 10);
+    } else if (arg == "--fan-out") {
+      options._fanOut = std::strtoul(value, nullptr, 10);
+    } else if (arg == "--roots") {
+      options._rootDependencyCount = std::strtoul(value, nullptr, 10);
+    } else if (arg == "--compatible-with") {
+      options._compatibleWithWeight = std::strtod(value, nullptr);
+    } else if (arg == "--at-least") {
+      options._atLeastWeight = std::strtod(value, nullptr);
+    } else if (arg == "--exactly") {
+      options._exactlyWeight = std::strtod(value, nullptr);
+    } else if (arg == "--conflict-density") {
+      options._conflictDensity = std::strtod(value, nullptr);
+    } else if (arg == "--prerelease-share") {
+      options._prereleaseShare = std::strtod(value, nullptr);
+    } else {
+      std::cerr << "Unrecognized option " << arg << "\n";
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (!directory) {
+    printUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  if (options._versionsPerPackage == 0) {
+    std::cerr << "Every package must have at least one version\n";
+    return EXIT_FAILURE;
+  }
+
+  if (mkdir(directory, 0755) != 0 && errno != EEXIST) {
+    std::cerr << "Could not create " << directory << ": " << std::strerror(errno) << "\n";
+    return EXIT_FAILURE;
+  }
+
+  try {
+    Ecosystem(options).writeFixture(std::string(directory) + "/");
+  } catch (const std::exception &ex) {
+    std::cerr << ex.what() << "\n";
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}